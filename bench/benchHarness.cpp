@@ -0,0 +1,247 @@
+// Header
+#include "benchHarness.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <thread>
+
+namespace
+{
+	struct Benchmark
+	{
+		std::string name;
+		BenchFunction function;
+		bool has_arg;
+		int64_t arg;
+	};
+
+	struct BenchResult
+	{
+		std::string name;
+		int64_t iterations;
+		double real_ns; // per iteration
+		double cpu_ns;
+		double items_per_second;
+		const char* skip_reason;
+	};
+
+	// Function local so registrations from any translation unit find it constructed
+	std::vector<Benchmark>& get_benchmarks()
+	{
+		static std::vector<Benchmark> benchmarks;
+		return benchmarks;
+	}
+
+	// Written by bench_escape(), opaque to the optimizer as long as it lives in its own translation unit
+	const void* volatile g_sink = nullptr;
+
+	int64_t real_now_ns()
+	{
+		return (int64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	int64_t cpu_now_ns()
+	{
+		return (int64_t)((double)std::clock() * 1e9 / CLOCKS_PER_SEC);
+	}
+
+	// Benchmark functions are written as bench_<name>, the prefix is left out of reports
+	std::string get_display_name(const char* function_name)
+	{
+		const char* prefix = "bench_";
+		if (strncmp(function_name, prefix, strlen(prefix)) == 0)
+			return function_name + strlen(prefix);
+		return function_name;
+	}
+
+	// Grows the iteration count until a run lasts min_time, like Google Benchmark does
+	BenchResult run(const Benchmark& benchmark, double min_time)
+	{
+		const int64_t MAX_ITERATIONS = 1000000000;
+
+		BenchResult result;
+		result.name = benchmark.name;
+		int64_t iterations = 1;
+		while (true)
+		{
+			BenchState state(benchmark.arg, iterations);
+			benchmark.function(state);
+
+			result.skip_reason = state.skip_reason();
+			if (result.skip_reason != nullptr)
+				break;
+
+			double seconds = state.elapsed_real_seconds();
+			if (seconds >= min_time || iterations >= MAX_ITERATIONS)
+			{
+				result.iterations = iterations;
+				result.real_ns = seconds * 1e9 / iterations;
+				result.cpu_ns = state.elapsed_cpu_seconds() * 1e9 / iterations;
+				result.items_per_second = seconds > 0.0 ? state.items_per_iteration() * iterations / seconds : 0.0;
+				break;
+			}
+
+			// Aim a little past min_time so the next run is likely the last one
+			double multiplier = seconds > min_time * 0.1 ? min_time * 1.4 / seconds : 10.0;
+			iterations = std::min(std::max((int64_t)(iterations * multiplier), iterations + 1), MAX_ITERATIONS);
+		}
+		return result;
+	}
+
+	void write_json_string(FILE* file, const std::string& str)
+	{
+		fputc('"', file);
+		for (char c : str)
+		{
+			if (c == '"' || c == '\\')
+				fputc('\\', file);
+			fputc(c, file);
+		}
+		fputc('"', file);
+	}
+
+	bool write_json(const char* path, const char* executable, const std::vector<BenchResult>& results)
+	{
+		FILE* file = path != nullptr ? fopen(path, "w") : stdout;
+		if (file == nullptr)
+		{
+			fprintf(stderr, "Failed to open %s for writing\n", path);
+			return false;
+		}
+
+		char date[64];
+		time_t now = time(nullptr);
+		strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", localtime(&now));
+
+		fprintf(file, "{\n  \"context\": {\n    \"date\": \"%s\",\n    \"executable\": ", date);
+		write_json_string(file, executable);
+#ifdef NDEBUG
+		const char* build_type = "release";
+#else
+		const char* build_type = "debug";
+#endif
+		fprintf(file, ",\n    \"num_cpus\": %u,\n    \"library_build_type\": \"%s\"\n  },\n  \"benchmarks\": [",
+			std::thread::hardware_concurrency(), build_type);
+
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			const BenchResult& result = results[i];
+			fprintf(file, "%s\n    {\n      \"name\": ", i == 0 ? "" : ",");
+			write_json_string(file, result.name);
+			fprintf(file, ",\n      \"run_name\": ");
+			write_json_string(file, result.name);
+			fprintf(file, ",\n      \"run_type\": \"iteration\",\n");
+			if (result.skip_reason != nullptr)
+			{
+				fprintf(file, "      \"error_occurred\": true,\n      \"error_message\": ");
+				write_json_string(file, result.skip_reason);
+				fprintf(file, "\n    }");
+				continue;
+			}
+			fprintf(file, "      \"iterations\": %lld,\n      \"real_time\": %.3f,\n      \"cpu_time\": %.3f,\n      \"time_unit\": \"ns\"",
+				(long long)result.iterations, result.real_ns, result.cpu_ns);
+			if (result.items_per_second > 0.0)
+				fprintf(file, ",\n      \"items_per_second\": %.1f", result.items_per_second);
+			fprintf(file, "\n    }");
+		}
+		fprintf(file, "\n  ]\n}\n");
+
+		bool ok = ferror(file) == 0;
+		if (file != stdout)
+			fclose(file);
+		return ok;
+	}
+}
+
+BenchState::BenchState(int64_t arg, int64_t iterations) :
+	m_arg(arg),
+	m_iterations(iterations),
+	m_remaining(iterations)
+{
+}
+
+bool BenchState::keep_running()
+{
+	if (!m_started)
+	{
+		m_started = true;
+		m_start_cpu_ns = cpu_now_ns();
+		m_start_real_ns = real_now_ns();
+	}
+	if (m_remaining-- > 0)
+		return true;
+	stop_timer();
+	return false;
+}
+
+void BenchState::skip(const char* reason)
+{
+	m_skip_reason = reason;
+	m_remaining = 0;
+}
+
+void BenchState::stop_timer()
+{
+	m_real_seconds = (real_now_ns() - m_start_real_ns) / 1e9;
+	m_cpu_seconds = (cpu_now_ns() - m_start_cpu_ns) / 1e9;
+}
+
+BenchRegistration::BenchRegistration(const char* name, BenchFunction function, std::vector<int64_t> args)
+{
+	std::string display_name = get_display_name(name);
+	if (args.empty())
+	{
+		get_benchmarks().push_back({ display_name, function, false, 0 });
+		return;
+	}
+	for (int64_t arg : args)
+		get_benchmarks().push_back({ display_name + "/" + std::to_string(arg), function, true, arg });
+}
+
+void bench_escape(const void* ptr)
+{
+	g_sink = ptr;
+}
+
+int bench_main(int argc, char* argv[])
+{
+	const char* filter = nullptr;
+	const char* json_path = nullptr;
+	double min_time = 0.2;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			filter = argv[++i];
+		else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+			min_time = atof(argv[++i]);
+		else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+			json_path = argv[++i];
+		else
+		{
+			fprintf(stderr, "Unknown argument %s\n", argv[i]);
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::vector<BenchResult> results;
+	for (const Benchmark& benchmark : get_benchmarks())
+	{
+		if (filter != nullptr && benchmark.name.find(filter) == std::string::npos)
+			continue;
+
+		BenchResult result = run(benchmark, min_time);
+		if (result.skip_reason != nullptr)
+			fprintf(stderr, "%-40s skipped: %s\n", result.name.c_str(), result.skip_reason);
+		else
+			fprintf(stderr, "%-40s %14.1f ns %14lld iterations\n", result.name.c_str(), result.real_ns, (long long)result.iterations);
+		results.push_back(result);
+	}
+
+	if (!write_json(json_path, argv[0], results))
+		return EXIT_FAILURE;
+	return EXIT_SUCCESS;
+}
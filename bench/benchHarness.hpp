@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Minimal microbenchmark harness, results are written in the Google Benchmark JSON
+// format so the usual comparison tools can read them.
+//
+//   void bench_mat3_mul(BenchState& state) {
+//       ... setup, not timed ...
+//       while (state.keep_running())
+//           bench_keep(mul(a, b));
+//   }
+//   BENCH(bench_mat3_mul);
+//
+// The body runs with a growing iteration count until one run takes long enough to
+// be measured, only the loop itself is timed.
+
+class BenchState
+{
+public:
+	BenchState(int64_t arg, int64_t iterations);
+
+	// True while iterations remain, starts the timer on the first call
+	bool keep_running();
+
+	// Argument the benchmark was registered with, e.g. an object count
+	int64_t arg() const { return m_arg; }
+	int64_t iterations() const { return m_iterations; }
+
+	// Work items per iteration, reported as items_per_second
+	void set_items_per_iteration(int64_t items) { m_items_per_iteration = items; }
+	int64_t items_per_iteration() const { return m_items_per_iteration; }
+
+	// Marks the benchmark as not runnable here, e.g. without a GL context
+	void skip(const char* reason);
+	const char* skip_reason() const { return m_skip_reason; }
+
+	double elapsed_real_seconds() const { return m_real_seconds; }
+	double elapsed_cpu_seconds() const { return m_cpu_seconds; }
+
+private:
+	void stop_timer();
+
+	int64_t m_arg;
+	int64_t m_iterations;
+	int64_t m_remaining;
+	int64_t m_items_per_iteration = 0;
+	const char* m_skip_reason = nullptr;
+	bool m_started = false;
+	int64_t m_start_real_ns = 0;
+	int64_t m_start_cpu_ns = 0;
+	double m_real_seconds = 0.0;
+	double m_cpu_seconds = 0.0;
+};
+
+typedef void (*BenchFunction)(BenchState& state);
+
+// Adds a benchmark run once per argument, or once without any. Called by the BENCH
+// macros during static initialization
+struct BenchRegistration
+{
+	BenchRegistration(const char* name, BenchFunction function, std::vector<int64_t> args = {});
+};
+
+#define BENCH_CONCAT_(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_(a, b)
+#define BENCH(function) static BenchRegistration BENCH_CONCAT(bench_registration_, __LINE__)(#function, function)
+#define BENCH_ARGS(function, ...) static BenchRegistration BENCH_CONCAT(bench_registration_, __LINE__)(#function, function, { __VA_ARGS__ })
+#define BENCH_NAMED(name, function) static BenchRegistration BENCH_CONCAT(bench_registration_, __LINE__)(name, function)
+
+// Keeps the compiler from optimizing away a value that is otherwise unused
+void bench_escape(const void* ptr);
+template <typename T>
+inline void bench_keep(const T& value)
+{
+	bench_escape(&value);
+}
+
+// Whether the game's GL context and textures are available, fighters and attacks need
+// them to init. Defined by the executable's main
+bool bench_has_game_assets();
+
+// Runs the registered benchmarks selected by the command line and writes the JSON
+// report, returns the process exit code. Flags:
+//   --filter <text>    only benchmarks whose name contains text
+//   --min-time <s>     minimum timed duration per benchmark, 0.2 by default
+//   --json <path>      JSON report destination, stdout by default
+int bench_main(int argc, char* argv[]);
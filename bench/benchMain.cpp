@@ -0,0 +1,56 @@
+// internal
+#include "common.hpp"
+#include "fighterInfo.hpp"
+#include "fighterDefinition.hpp"
+#include "benchHarness.hpp"
+
+#define GL3W_IMPLEMENTATION
+#include <gl3w.h>
+
+namespace
+{
+	GLFWwindow* g_window = nullptr;
+	bool g_has_game_assets = false;
+
+	// Fighters load their textures and fonts on init, a hidden window provides the context
+	bool load_game_assets()
+	{
+		if (!glfwInit())
+			return false;
+
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+		glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+		glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#if __APPLE__
+		glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+		glfwWindowHint(GLFW_VISIBLE, 0);
+		g_window = glfwCreateWindow(64, 64, "veggie_bench", nullptr, nullptr);
+		if (g_window == nullptr)
+			return false;
+
+		glfwMakeContextCurrent(g_window);
+		gl3w_init();
+
+		return load_all_sprites_from_file() && load_fighter_definitions();
+	}
+}
+
+bool bench_has_game_assets()
+{
+	return g_has_game_assets;
+}
+
+int main(int argc, char* argv[])
+{
+	g_has_game_assets = load_game_assets();
+	if (!g_has_game_assets)
+		fprintf(stderr, "No GL context, the fighter benchmarks are skipped\n");
+
+	int result = bench_main(argc, argv);
+
+	if (g_window != nullptr)
+		glfwDestroyWindow(g_window);
+	glfwTerminate();
+	return result;
+}
@@ -0,0 +1,279 @@
+// Microbenchmarks of the per-frame simulation code
+#include "benchHarness.hpp"
+#include "common.hpp"
+#include "boundingBox.hpp"
+#include "particle.hpp"
+#include "fighter.hpp"
+#include "platform.hpp"
+#include "world.hpp"
+
+#include <random>
+#include <vector>
+
+namespace
+{
+	const BoundingBox SCREEN(0.f, 0.f, 1200.f, 800.f);
+	const float FRAME_MS = 1000.f / 60.f;
+
+	// Stands in for the platforms and attacks the game inserts into its trees
+	struct BenchBox : public Renderable
+	{
+		BoundingBox box;
+
+		BenchBox(BoundingBox b) : box(b) {}
+		void draw(const mat3 &projection) override {}
+		BoundingBox get_bounding_box() override { return box; }
+	};
+
+	// Fixed seed so every run measures the same layout
+	std::vector<BenchBox> make_boxes(int count, float min_size, float max_size)
+	{
+		std::mt19937 rng(1234);
+		std::uniform_real_distribution<float> size(min_size, max_size);
+		std::uniform_real_distribution<float> unit(0.f, 1.f);
+
+		std::vector<BenchBox> boxes;
+		boxes.reserve(count);
+		for (int i = 0; i < count; i++)
+		{
+			float width = size(rng);
+			float height = size(rng);
+			boxes.push_back(BenchBox(BoundingBox(unit(rng) * (SCREEN.width - width), unit(rng) * (SCREEN.height - height), width, height)));
+		}
+		return boxes;
+	}
+
+	// Drives a fighter through walking, punching and both abilities every two seconds
+	void apply_input_script(Fighter& fighter, int frame)
+	{
+		switch (frame % 120)
+		{
+		case 0:
+			fighter.set_movement(MOVING_FORWARD);
+			break;
+		case 20:
+			fighter.set_movement(STOP_MOVING_FORWARD);
+			fighter.set_movement(PUNCHING);
+			break;
+		case 25:
+			fighter.set_movement(STOP_PUNCHING);
+			break;
+		case 40:
+			fighter.set_movement(MOVING_BACKWARD);
+			break;
+		case 60:
+			fighter.set_movement(STOP_MOVING_BACKWARD);
+			fighter.set_movement(ABILITY_1);
+			break;
+		case 80:
+			fighter.set_movement(STOP_ABILITIES);
+			fighter.set_movement(ABILITY_2);
+			break;
+		case 85:
+			fighter.set_movement(STOP_ABILITIES);
+			break;
+		case 100:
+			fighter.set_movement(START_JUMPING);
+			break;
+		}
+	}
+
+	// Same ownership rules as World::attack_deletion(), the fighter may hold on to it
+	void release_attack(Attack* attack)
+	{
+		attack->deincrement_pointer_references();
+		if (attack->get_pointer_references() == 0)
+			delete attack;
+	}
+}
+
+void bench_quadtree_insert(BenchState& state)
+{
+	std::vector<BenchBox> boxes = make_boxes((int)state.arg(), 5.f, 50.f);
+	QuadTree tree(SCREEN);
+	while (state.keep_running())
+	{
+		tree.clear();
+		for (BenchBox& box : boxes)
+			tree.insert(&box);
+	}
+	state.set_items_per_iteration(state.arg());
+}
+BENCH_ARGS(bench_quadtree_insert, 10, 100, 1000, 10000);
+
+void bench_quadtree_retrieve(BenchState& state)
+{
+	std::vector<BenchBox> boxes = make_boxes((int)state.arg(), 5.f, 50.f);
+	QuadTree tree(SCREEN);
+	for (BenchBox& box : boxes)
+		tree.insert(&box);
+
+	// Fighter sized queries, the common case in the game
+	std::vector<BenchBox> queries = make_boxes(64, 60.f, 120.f);
+	int i = 0;
+	while (state.keep_running())
+	{
+		std::vector<Renderable*> found = tree.retrieve(queries[i++ & 63].box, {});
+		bench_keep(found.size());
+	}
+	state.set_items_per_iteration(1);
+}
+BENCH_ARGS(bench_quadtree_retrieve, 10, 100, 1000, 10000);
+
+void bench_bounding_box_check_collision(BenchState& state)
+{
+	std::vector<BenchBox> boxes = make_boxes(256, 20.f, 200.f);
+	int i = 0;
+	while (state.keep_running())
+	{
+		bench_keep(boxes[i & 255].box.check_collision(boxes[(i + 1) & 255].box));
+		i++;
+	}
+}
+BENCH(bench_bounding_box_check_collision);
+
+void bench_mat3_mul(BenchState& state)
+{
+	mat3 matrices[8];
+	for (int i = 0; i < 8; i++)
+	{
+		float c = cosf(i * 0.7f);
+		float s = sinf(i * 0.7f);
+		matrices[i] = { { c, s, 0.f }, { -s, c, 0.f }, { i * 10.f, i * 5.f, 1.f } };
+	}
+
+	int i = 0;
+	while (state.keep_running())
+	{
+		mat3 product = mul(matrices[i & 7], matrices[(i + 3) & 7]);
+		bench_keep(product);
+		i++;
+	}
+}
+BENCH(bench_mat3_mul);
+
+// The chain every sprite's draw() runs
+void bench_renderable_transform(BenchState& state)
+{
+	BenchBox renderable(BoundingBox(0.f, 0.f, 10.f, 10.f));
+	float angle = 0.f;
+	while (state.keep_running())
+	{
+		renderable.transform_begin();
+		renderable.transform_translate({ 600.f, 400.f });
+		renderable.transform_rotate(angle);
+		renderable.transform_scale({ 0.5f, -0.5f });
+		renderable.transform_end();
+		bench_keep(renderable.transform);
+		angle += 0.01f;
+	}
+}
+BENCH(bench_renderable_transform);
+
+void bench_particle_update(BenchState& state)
+{
+	std::vector<Particle> particles((size_t)state.arg());
+	std::mt19937 rng(1234);
+	std::uniform_real_distribution<float> angle(0.f, 360.f);
+	std::uniform_real_distribution<float> speed(1.f, 10.f);
+	for (Particle& particle : particles)
+		particle.init({ 600.f, 400.f }, 1e9f, angle(rng), speed(rng), { 1.f, 1.f, 1.f }, 5.f);
+
+	while (state.keep_running())
+	{
+		for (Particle& particle : particles)
+			particle.update(FRAME_MS);
+	}
+	bench_keep(particles[0]);
+	state.set_items_per_iteration(state.arg());
+}
+BENCH_ARGS(bench_particle_update, 100, 1000, 10000, 100000);
+
+// World::attack_collision() is private, this is its only other caller
+struct WorldBench
+{
+	static void attack_collision(BenchState& state)
+	{
+		if (!bench_has_game_assets())
+		{
+			state.skip("needs a GL context to init fighters");
+			return;
+		}
+
+		World world;
+		world.m_player1.init(1, "bench 1", POTATO, world.m_components);
+		world.m_player2.init(2, "bench 2", BROCCOLI, world.m_components);
+		world.m_player1.set_in_play(true);
+		world.m_player2.set_in_play(true);
+		world.update_fighter_list();
+
+		world.m_platforms_tree = new QuadTree(SCREEN);
+		Platform floor(0.f, 600.f, 1200.f, 200.f);
+		world.m_platforms_tree->insert(&floor);
+
+		// Punches of both players and a third fighter, spread over the screen
+		std::vector<BenchBox> boxes = make_boxes((int)state.arg(), 40.f, 80.f);
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			const BoundingBox& b = boxes[i].box;
+			Punch* punch = new Punch(1 + (int)(i % 3), { b.xpos, b.ypos }, { b.width, b.height }, 1, i % 2 == 0);
+			world.m_attacks.push_back(punch);
+		}
+
+		while (state.keep_running())
+			world.attack_collision();
+		state.set_items_per_iteration(state.arg());
+
+		for (Attack* attack : world.m_attacks)
+			delete attack;
+		world.m_attacks.clear();
+		delete world.m_platforms_tree;
+		world.m_player1.destroy();
+		world.m_player2.destroy();
+	}
+};
+
+void bench_attack_collision(BenchState& state)
+{
+	WorldBench::attack_collision(state);
+}
+BENCH_ARGS(bench_attack_collision, 10, 100, 1000);
+
+template <FighterCharacter fc>
+void bench_fighter_update(BenchState& state)
+{
+	if (!bench_has_game_assets())
+	{
+		state.skip("needs a GL context to init fighters");
+		return;
+	}
+
+	ComponentStore components;
+	Fighter fighter(1);
+	if (!fighter.init(1, "bench", fc, components))
+	{
+		state.skip("fighter init failed");
+		return;
+	}
+
+	QuadTree platforms(SCREEN);
+	Platform floor(0.f, 600.f, 1200.f, 200.f);
+	platforms.insert(&floor);
+
+	int frame = 0;
+	while (state.keep_running())
+	{
+		apply_input_script(fighter, frame++);
+		Attack* attack = fighter.update(FRAME_MS, &platforms);
+		if (attack != nullptr)
+		{
+			attack->init();
+			release_attack(attack);
+		}
+	}
+	fighter.destroy();
+}
+BENCH_NAMED("fighter_update/POTATO", bench_fighter_update<POTATO>);
+BENCH_NAMED("fighter_update/BROCCOLI", bench_fighter_update<BROCCOLI>);
+BENCH_NAMED("fighter_update/EGGPLANT", bench_fighter_update<EGGPLANT>);
+BENCH_NAMED("fighter_update/YAM", bench_fighter_update<YAM>);
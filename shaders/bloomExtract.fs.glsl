@@ -0,0 +1,21 @@
+#version 330
+uniform sampler2D source;
+uniform vec2 texel_size;
+uniform float bloom_threshold;
+
+in vec2 uv;
+
+layout(location = 0) out vec4 color;
+
+// Downsamples with a 2x2 box and keeps what is brighter than the threshold
+void main()
+{
+    vec3 sum = texture(source, uv + texel_size * vec2(-0.5, -0.5)).rgb;
+    sum += texture(source, uv + texel_size * vec2(0.5, -0.5)).rgb;
+    sum += texture(source, uv + texel_size * vec2(-0.5, 0.5)).rgb;
+    sum += texture(source, uv + texel_size * vec2(0.5, 0.5)).rgb;
+    sum *= 0.25;
+
+    float brightness = max(sum.r, max(sum.g, sum.b));
+    color = vec4(sum * max(brightness - bloom_threshold, 0.0) / max(brightness, 0.0001), 1.0);
+}
@@ -0,0 +1,23 @@
+#version 330
+uniform sampler2D source;
+uniform vec2 texel_size;
+
+in vec2 uv;
+
+layout(location = 0) out vec4 color;
+
+// 3x3 tent blur over the input texels
+void main()
+{
+    vec3 sum = vec3(0.0);
+    sum += texture(source, uv + texel_size * vec2(-1.0, -1.0)).rgb;
+    sum += texture(source, uv + texel_size * vec2(0.0, -1.0)).rgb * 2.0;
+    sum += texture(source, uv + texel_size * vec2(1.0, -1.0)).rgb;
+    sum += texture(source, uv + texel_size * vec2(-1.0, 0.0)).rgb * 2.0;
+    sum += texture(source, uv).rgb * 4.0;
+    sum += texture(source, uv + texel_size * vec2(1.0, 0.0)).rgb * 2.0;
+    sum += texture(source, uv + texel_size * vec2(-1.0, 1.0)).rgb;
+    sum += texture(source, uv + texel_size * vec2(0.0, 1.0)).rgb * 2.0;
+    sum += texture(source, uv + texel_size * vec2(1.0, 1.0)).rgb;
+    color = vec4(sum / 16.0, 1.0);
+}
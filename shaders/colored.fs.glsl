@@ -15,4 +15,5 @@ layout(location = 0) out  vec4 color;
 void main()
 {
 	color = vec4(fcolor * vcolor, 1.0);
+	color.rgb += vec3(0.1); // scene color shift, shared by all scene shaders
 }
\ No newline at end of file
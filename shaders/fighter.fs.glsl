@@ -35,4 +35,5 @@ void main()
 	    color = vec4(0.7, 1.0, 0.7, 1.0) * texture(sampler0, vec2(texcoord.x, texcoord.y));
 	}
 	else { color = vec4(1.0, 1.0, 1.0, 1.0) * texture(sampler0, vec2(texcoord.x, texcoord.y)); }	
+	color.rgb += vec3(0.1); // scene color shift, shared by all scene shaders
 }
@@ -0,0 +1,15 @@
+#version 330
+in vec2 texcoord;
+in vec4 vcolor;
+
+uniform sampler2D text_texture;
+
+layout(location = 0) out vec4 color;
+
+// Untextured quads (graph, panel) have negative texcoords
+void main()
+{
+	color = vcolor;
+	if (texcoord.x >= 0.0)
+		color *= texture(text_texture, texcoord);
+}
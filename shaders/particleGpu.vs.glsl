@@ -0,0 +1,27 @@
+#version 330 
+// Input attributes
+in vec3 in_position;
+
+// Per-instance attributes, read straight from the simulation buffer
+in vec2 in_offset;
+in float in_life;
+in float in_scale;
+in vec3 in_color;
+
+out vec3 vcolor;
+
+// Application data
+uniform mat3 projection;
+
+void main()
+{
+	vcolor = in_color;
+	if (in_life < 0.0)
+	{
+		// Dead slot, move it outside the clip volume
+		gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+		return;
+	}
+	vec3 pos = projection * vec3(in_offset + in_position.xy * in_scale, 1.0);
+	gl_Position = vec4(pos.xy, in_position.z, 1.0);
+}
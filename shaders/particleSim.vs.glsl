@@ -0,0 +1,97 @@
+#version 330
+// Current particle state
+in vec2 in_position;
+in vec2 in_velocity;
+in float in_life;
+in float in_scale;
+in vec3 in_color;
+
+// Next particle state, captured with transform feedback
+out vec2 out_position;
+out vec2 out_velocity;
+out float out_life;
+out float out_scale;
+out vec3 out_color;
+
+#define MAX_EMIT_COMMANDS 16
+#define PI 3.14159265
+
+// Application data
+uniform int num_commands;
+uniform int emit_start[MAX_EMIT_COMMANDS];
+uniform int emit_count[MAX_EMIT_COMMANDS];
+uniform vec4 emit_origin[MAX_EMIT_COMMANDS]; // xy position, z scale, w lifespan
+uniform vec3 emit_color[MAX_EMIT_COMMANDS];
+uniform float emit_angle[MAX_EMIT_COMMANDS]; // degrees, negative for random
+uniform int capacity;
+uniform uint seed;
+uniform float elapsed_ms;
+uniform bool step;
+
+// Drag, same constants as Particle::update
+const float p = 1.293;
+const float A = 0.1;
+const float Cd = 0.47;
+const float m = 1.0;
+
+uint hash(uint x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+float random(inout uint state)
+{
+	state = hash(state);
+	return float(state & 0xffffffu) / 16777216.0;
+}
+
+void main()
+{
+	vec2 position = in_position;
+	vec2 velocity = in_velocity;
+	float life = in_life;
+	float scale = in_scale;
+	vec3 color = in_color;
+
+	// Spawn if a queued burst covers this slot
+	for (int i = 0; i < num_commands; i++)
+	{
+		int offset = gl_VertexID - emit_start[i];
+		if (offset < 0)
+			offset += capacity;
+		if (offset < emit_count[i])
+		{
+			uint state = seed ^ hash(uint(gl_VertexID));
+			float angle = emit_angle[i] < 0.0 ? random(state) * 359.99 : emit_angle[i];
+			float speed = random(state) * 3.0 + 3.0;
+			float radians = angle * PI / 180.0;
+			position = emit_origin[i].xy;
+			velocity = vec2(speed * cos(radians), -speed * sin(radians));
+			scale = emit_origin[i].z;
+			life = emit_origin[i].w;
+			color = emit_color[i];
+		}
+	}
+
+	if (step && life >= 0.0)
+	{
+		life -= elapsed_ms;
+		if (life >= 0.0)
+		{
+			vec2 fd = -velocity * 0.5 * p * Cd * A * velocity * velocity;
+			velocity += (fd / m) * (elapsed_ms / 1000.0);
+			position += velocity;
+		}
+	}
+
+	out_position = position;
+	out_velocity = velocity;
+	out_life = life;
+	out_scale = scale;
+	out_color = color;
+}
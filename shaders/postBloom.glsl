@@ -0,0 +1,8 @@
+// Adds the blurred highlights back onto the image
+uniform float bloom_strength;
+
+vec4 bloom(vec4 color, vec2 uv)
+{
+    color.rgb += texture(bloom_blur, uv).rgb * bloom_strength;
+    return color;
+}
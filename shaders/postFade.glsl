@@ -0,0 +1,9 @@
+// Darkens the screen after the game is over
+uniform float game_over_timer;
+
+vec4 game_over_fade(vec4 color, vec2 uv)
+{
+    if (game_over_timer > 0)
+        color -= 0.1 * game_over_timer * vec4(0.1, 0.1, 0.1, 0);
+    return color;
+}
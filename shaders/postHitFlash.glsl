@@ -0,0 +1,8 @@
+// Flashes the screen white when a fighter takes a hit
+uniform float hit_flash_amount;
+
+vec4 hit_flash(vec4 color, vec2 uv)
+{
+    color.rgb = mix(color.rgb, vec3(1.0), hit_flash_amount);
+    return color;
+}
@@ -0,0 +1,6 @@
+// Heat wave distortion, reads the pass input at a moved coordinate
+vec4 wave(vec4 color, vec2 uv)
+{
+    uv.y += cos(uv.x * 25.0) * 0.01 * cos(time * 10.0);
+    return texture(source, uv);
+}
@@ -0,0 +1,18 @@
+#version 330 
+// Input attributes, unit quad
+in vec2 in_texcoord;
+
+// Passed to fragment shader
+out vec2 texcoord;
+
+// Application data
+uniform mat3 transform;
+uniform mat3 projection;
+uniform vec4 rect; // local origin and size of the sprite quad
+
+void main()
+{
+	texcoord = in_texcoord;
+	vec3 pos = projection * transform * vec3(rect.xy + in_texcoord * rect.zw, 1.0);
+	gl_Position = vec4(pos.xy, -0.02, 1.0);
+}
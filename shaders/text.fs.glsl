@@ -9,4 +9,5 @@ void main()
 {
     vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
     color = vec4(textColor, 1.0) * sampled;
+    color.rgb += vec3(0.1); // scene color shift, shared by all scene shaders
 }
\ No newline at end of file
@@ -12,4 +12,5 @@ layout(location = 0) out  vec4 color;
 void main()
 {
 	color = vec4(fcolor, 1.0) * texture(sampler0, vec2(texcoord.x, texcoord.y));
+	color.rgb += vec3(0.1); // scene color shift, shared by all scene shaders
 }
@@ -2,7 +2,6 @@
 
 #include "fighter.hpp"
 #include "ai.hpp"
-#include <time.h>
 #include <random>
 
 #define ABILITY_RATE 10
@@ -13,10 +12,20 @@ vec2 d;
 int engagingDistance = 75;
 int verticalEngagingDistance = 30;
 int randNum;
-long t = time(0); //initialize time
+long t = 0; //initialize time
 float stageLowerXBound = 200;
 float stageUpperXBound = 1000;
 
+namespace
+{
+	// Whole seconds on the GLFW clock rather than the wall clock, so replays that set
+	// the clock see the same decisions
+	long ai_time()
+	{
+		return (long)glfwGetTime();
+	}
+}
+
 AI::AI(unsigned int id, AIType type) : Fighter(id)
 {
     this->aitype = type;
@@ -34,7 +43,13 @@ void AI::set_in_play(bool value)
 
 Attack * AI::update(float ms, QuadTree* platform_tree, vec2 player1Position, bool player1FacingFront, int player1HP, bool player1isBlocking)
 {
-	Attack * attack = NULL;
+	if (!think(player1Position, player1FacingFront, player1HP, player1isBlocking))
+		return NULL;
+	return act(ms, platform_tree);
+}
+
+bool AI::think(vec2 player1Position, bool player1FacingFront, int player1HP, bool player1isBlocking)
+{
 	switch (aitype) {
 	case CHASE:
 	{
@@ -47,16 +62,12 @@ Attack * AI::update(float ms, QuadTree* platform_tree, vec2 player1Position, boo
 		{
 			this->set_movement(MOVING_BACKWARD);
 		}
-
-		attack = Fighter::update(ms, platform_tree);
-		this->set_movement(STOP_MOVING_FORWARD);
-		this->set_movement(STOP_MOVING_BACKWARD);
 	}
 		break;
 	
 	case AVOID:
 	{	
-		if (time(0) % RESET_RATE == 0) {
+		if (ai_time() % RESET_RATE == 0) {
 			this->aitype = INIT;
 		}
 		d.x = abs(player1Position.x - this->get_position().x);
@@ -71,7 +82,7 @@ Attack * AI::update(float ms, QuadTree* platform_tree, vec2 player1Position, boo
 		else if (d.x <= engagingDistance ) {
 			this->set_movement(BLOCKING);
 			
-			if (time(0) % DISENGAGE_RATE == 0) {
+			if (ai_time() % DISENGAGE_RATE == 0) {
 				this->set_movement(STOP_BLOCKING);
 				
 				if (d.x <= engagingDistance && facingP1) {
@@ -79,78 +90,74 @@ Attack * AI::update(float ms, QuadTree* platform_tree, vec2 player1Position, boo
 						this->set_movement(PUNCHING);
 					else if (d.y < -70 && d.y > -100) this->set_movement(ABILITY_1);
 				}
-				break;
+				return false;
 			}
 			
 			
 		}
-
-		attack = Fighter::update(ms, platform_tree);
-		this->set_movement(STOP_MOVING_FORWARD);
-		this->set_movement(STOP_MOVING_BACKWARD);
-
 	}
 		break;
 	
 	case INIT:
 	{
-		if (player1HP - this->get_health() >= 50) this->aitype = AVOID;
-		else {
-			d.x = abs(player1Position.x - this->get_position().x);
-			d.y = player1Position.y - this->get_position().y;
-			bool facingP1 = is_in_Front(player1Position.x);
-
-			if (d.x > engagingDistance || !facingP1 || abs(d.y) > 100) {
-				this->set_movement(STOP_PUNCHING);
-				this->set_movement(STOP_ABILITIES);
-				move_Randomly();
-			}
-			else if (d.x <= engagingDistance && facingP1) {
-				if (time(0) % DISENGAGE_RATE) move_Randomly();
-
-				else if (abs(d.y) <= verticalEngagingDistance)
-					this->set_movement(PUNCHING);
-				else if (d.y < -70 && d.y > -100) this->set_movement(ABILITY_1);
-				
-			}
+		if (player1HP - this->get_health() >= 50) {
+			this->aitype = AVOID;
+			return false;
+		}
 
+		d.x = abs(player1Position.x - this->get_position().x);
+		d.y = player1Position.y - this->get_position().y;
+		bool facingP1 = is_in_Front(player1Position.x);
 
-			if (time(0) % ABILITY_RATE == 0 && facingP1) {
-				this->set_movement(ABILITY_2);
-			}
+		if (d.x > engagingDistance || !facingP1 || abs(d.y) > 100) {
+			this->set_movement(STOP_PUNCHING);
+			this->set_movement(STOP_ABILITIES);
+			move_Randomly();
+		}
+		else if (d.x <= engagingDistance && facingP1) {
+			if (ai_time() % DISENGAGE_RATE) move_Randomly();
 
-			attack = Fighter::update(ms, platform_tree);
-			this->set_movement(STOP_MOVING_FORWARD);
-			this->set_movement(STOP_MOVING_BACKWARD);
+			else if (abs(d.y) <= verticalEngagingDistance)
+				this->set_movement(PUNCHING);
+			else if (d.y < -70 && d.y > -100) this->set_movement(ABILITY_1);
+			
 		}
 
+
+		if (ai_time() % ABILITY_RATE == 0 && facingP1) {
+			this->set_movement(ABILITY_2);
+		}
 	}
 		break;
 	case RANDOM:
 	{
 		move_Randomly();
-
-		attack = Fighter::update(ms, platform_tree);
-		this->set_movement(STOP_MOVING_FORWARD);
-		this->set_movement(STOP_MOVING_BACKWARD);
 	}
 		break;
 	}
-	
+
+	return true;
+}
+
+Attack * AI::act(float ms, QuadTree* platform_tree)
+{
+	Attack * attack = Fighter::update(ms, platform_tree);
+	this->set_movement(STOP_MOVING_FORWARD);
+	this->set_movement(STOP_MOVING_BACKWARD);
+
 	//may return either NULL or the punch collision object depending if the character was punching
 	return attack;
 }
 
 void AI::move_Randomly(){
-	std::random_device rd; // non-deterministic generator
-	std::mt19937 gen(rd());
+	std::mt19937 gen(next_random_seed());
 	std::uniform_int_distribution<> dist(0, 2); //ADD FOR MORE ACTIONS
-	if (time(0) > t) {
+	if (ai_time() > t) {
 		//if (randNum == 2)
 		//	std::uniform_int_distribution<> dist(0, 1); //add if AI can not double jump
 		randNum = dist(gen);                            
 
-		t = time(0);
+		t = ai_time();
 	}
 
 	if (this->get_position().x < stageLowerXBound)
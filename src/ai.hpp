@@ -12,6 +12,11 @@ class AI : public Fighter
     bool get_in_play() const;
     void set_in_play(bool value);
     Attack * update(float ms, QuadTree* platform_tree, vec2 player1Position, bool player1FacingFront, int player1HP, bool player1isBlocking);
+    // update() in two steps. think() picks the moves, it shares state with every other AI
+    // so AIs think one after the other. act() only touches this AI, it moves the fighter
+    // and may run in parallel with the others. act() is skipped when think() returns false
+    bool think(vec2 player1Position, bool player1FacingFront, int player1HP, bool player1isBlocking);
+    Attack * act(float ms, QuadTree* platform_tree);
     float distance(vec2 pos1, vec2 pos2);
 
   private:
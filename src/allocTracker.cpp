@@ -0,0 +1,245 @@
+// Header
+#include "allocTracker.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// Counted by whichever thread allocates, folded into the totals by alloc_tracker_end_frame()
+	struct Site
+	{
+		std::atomic<const char*> tag;
+		std::atomic<uint64_t> frame_allocations;
+		std::atomic<uint64_t> frame_bytes;
+		AllocStats total;
+	};
+
+	const int UNTAGGED_SITE = 0;
+	const int OTHER_SITE = 1;
+
+	std::atomic<int> g_enabled_count(0);
+	Site g_sites[ALLOC_TRACKER_MAX_SITES];
+
+	// Only touched by the thread ending frames
+	AllocStats g_last_frame = { 0, 0 };
+	AllocStats g_total = { 0, 0 };
+	AllocStats g_worst_frame = { 0, 0 };
+	int g_frame_count = 0;
+	int g_skip_frames = 0;
+
+	thread_local int t_site = UNTAGGED_SITE;
+
+	// Looks the tag up by address, claiming a free site the first time it is seen
+	int find_site(const char* tag)
+	{
+		for (int i = OTHER_SITE + 1; i < ALLOC_TRACKER_MAX_SITES; i++)
+		{
+			const char* site_tag = g_sites[i].tag.load(std::memory_order_acquire);
+			if (site_tag == tag)
+				return i;
+			if (site_tag == nullptr)
+			{
+				const char* expected = nullptr;
+				if (g_sites[i].tag.compare_exchange_strong(expected, tag, std::memory_order_acq_rel) || expected == tag)
+					return i;
+			}
+		}
+		return OTHER_SITE;
+	}
+
+	const char* get_site_tag(int site)
+	{
+		if (site == UNTAGGED_SITE)
+			return "untagged";
+		if (site == OTHER_SITE)
+			return "other";
+		return g_sites[site].tag.load(std::memory_order_acquire);
+	}
+
+	void* tracked_alloc(std::size_t size)
+	{
+		if (g_enabled_count.load(std::memory_order_relaxed) > 0)
+		{
+			Site& site = g_sites[t_site];
+			site.frame_allocations.fetch_add(1, std::memory_order_relaxed);
+			site.frame_bytes.fetch_add(size, std::memory_order_relaxed);
+		}
+
+		void* ptr = std::malloc(size != 0 ? size : 1);
+		if (ptr == nullptr)
+			throw std::bad_alloc();
+		return ptr;
+	}
+}
+
+void alloc_tracker_enable()
+{
+	g_enabled_count.fetch_add(1, std::memory_order_relaxed);
+}
+
+void alloc_tracker_disable()
+{
+	g_enabled_count.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool alloc_tracker_is_enabled()
+{
+	return g_enabled_count.load(std::memory_order_relaxed) > 0;
+}
+
+void alloc_tracker_end_frame()
+{
+	bool counted = g_skip_frames == 0;
+	if (!counted)
+		g_skip_frames--;
+
+	AllocStats frame = { 0, 0 };
+	for (Site& site : g_sites)
+	{
+		uint64_t allocations = site.frame_allocations.exchange(0, std::memory_order_relaxed);
+		uint64_t bytes = site.frame_bytes.exchange(0, std::memory_order_relaxed);
+		frame.allocations += allocations;
+		frame.bytes += bytes;
+		if (counted)
+		{
+			site.total.allocations += allocations;
+			site.total.bytes += bytes;
+		}
+	}
+	g_last_frame = frame;
+
+	if (!counted)
+		return;
+
+	g_total.allocations += frame.allocations;
+	g_total.bytes += frame.bytes;
+	if (frame.allocations > g_worst_frame.allocations)
+		g_worst_frame = frame;
+	g_frame_count++;
+}
+
+AllocStats alloc_tracker_last_frame()
+{
+	return g_last_frame;
+}
+
+void alloc_tracker_skip_frames(int frames)
+{
+	g_skip_frames = std::max(g_skip_frames, frames);
+}
+
+void alloc_tracker_reset()
+{
+	for (Site& site : g_sites)
+		site.total = { 0, 0 };
+	g_total = { 0, 0 };
+	g_worst_frame = { 0, 0 };
+	g_frame_count = 0;
+}
+
+int alloc_tracker_frame_count()
+{
+	return g_frame_count;
+}
+
+AllocStats alloc_tracker_total()
+{
+	return g_total;
+}
+
+AllocStats alloc_tracker_worst_frame()
+{
+	return g_worst_frame;
+}
+
+int alloc_tracker_top_sites(AllocSite* sites, int max_sites)
+{
+	// Fixed size so that ranking the sites does not allocate itself
+	AllocSite all[ALLOC_TRACKER_MAX_SITES];
+	int count = 0;
+	for (int i = 0; i < ALLOC_TRACKER_MAX_SITES; i++)
+	{
+		if (g_sites[i].total.allocations == 0)
+			continue;
+		all[count].tag = get_site_tag(i);
+		all[count].stats = g_sites[i].total;
+		count++;
+	}
+
+	std::sort(all, all + count, [](const AllocSite& a, const AllocSite& b) {
+		return a.stats.allocations > b.stats.allocations;
+	});
+
+	count = std::min(count, max_sites);
+	std::copy(all, all + count, sites);
+	return count;
+}
+
+void alloc_tracker_report(FILE* file, int max_sites)
+{
+	int frames = std::max(g_frame_count, 1);
+	fprintf(file, "Heap allocations over %d frames: %.1f per frame (%.0f bytes), worst frame %llu (%llu bytes)\n",
+		g_frame_count, (double)g_total.allocations / frames, (double)g_total.bytes / frames,
+		(unsigned long long)g_worst_frame.allocations, (unsigned long long)g_worst_frame.bytes);
+
+	AllocSite sites[ALLOC_TRACKER_MAX_SITES];
+	int count = alloc_tracker_top_sites(sites, std::min(max_sites, ALLOC_TRACKER_MAX_SITES));
+	for (int i = 0; i < count; i++)
+	{
+		fprintf(file, "  %-32s %10.1f per frame %12.0f bytes\n", sites[i].tag,
+			(double)sites[i].stats.allocations / frames, (double)sites[i].stats.bytes / frames);
+	}
+}
+
+bool alloc_tracker_check_budget(uint64_t max_allocations_per_frame)
+{
+	if (g_worst_frame.allocations <= max_allocations_per_frame)
+		return true;
+
+	fprintf(stderr, "Allocation budget exceeded: worst frame made %llu allocations, budget is %llu\n",
+		(unsigned long long)g_worst_frame.allocations, (unsigned long long)max_allocations_per_frame);
+	alloc_tracker_report(stderr, 10);
+	return false;
+}
+
+AllocScope::AllocScope(const char* tag)
+{
+	if (!alloc_tracker_is_enabled())
+	{
+		m_previous_site = -1;
+		return;
+	}
+	m_previous_site = t_site;
+	t_site = find_site(tag);
+}
+
+AllocScope::~AllocScope()
+{
+	if (m_previous_site >= 0)
+		t_site = m_previous_site;
+}
+
+// Replacements of the global allocation functions. Everything comes from malloc, so
+// the forms left to the standard library (nothrow, sized delete) stay compatible
+void* operator new(std::size_t size)
+{
+	return tracked_alloc(size);
+}
+
+void* operator new[](std::size_t size)
+{
+	return tracked_alloc(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
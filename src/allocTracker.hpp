@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+// Counts heap allocations made through the global operator new, per frame and per
+// call site. Counting is off until enabled, then every allocation costs a few relaxed
+// atomic adds.
+//
+//   std::vector<Renderable*> QuadTree::retrieve(...) {
+//       ALLOC_SCOPE("QuadTree::retrieve");
+//       ...
+//   }
+//
+// Allocations are charged to the innermost ALLOC_SCOPE of their thread, "untagged"
+// outside of any. Tags must be string literals.
+
+// Call sites told apart, tags beyond that are charged to "other"
+const int ALLOC_TRACKER_MAX_SITES = 64;
+
+struct AllocStats
+{
+	uint64_t allocations;
+	uint64_t bytes;
+};
+
+struct AllocSite
+{
+	const char* tag;
+	AllocStats stats;
+};
+
+// Calls nest, counting stays on until every enable has been matched by a disable
+void alloc_tracker_enable();
+void alloc_tracker_disable();
+bool alloc_tracker_is_enabled();
+
+// Closes the current frame, call once per frame while enabled
+void alloc_tracker_end_frame();
+// Allocations of the frame closed by the last alloc_tracker_end_frame()
+AllocStats alloc_tracker_last_frame();
+
+// The next frames are left out of the totals, e.g. while a level loads
+void alloc_tracker_skip_frames(int frames);
+// Drops the totals, worst frame and site counts
+void alloc_tracker_reset();
+
+// Frames counted since the last reset, skipped frames excluded
+int alloc_tracker_frame_count();
+AllocStats alloc_tracker_total();
+AllocStats alloc_tracker_worst_frame();
+// Fills sites with the call sites that allocated the most, returns how many were written
+int alloc_tracker_top_sites(AllocSite* sites, int max_sites);
+
+// Per-frame averages of the top call sites and the worst frame
+void alloc_tracker_report(FILE* file, int max_sites);
+// Whether no counted frame allocated more than the budget, reports the offenders when one did
+bool alloc_tracker_check_budget(uint64_t max_allocations_per_frame);
+
+// Charges the allocations of the surrounding scope to a call site
+class AllocScope
+{
+public:
+	explicit AllocScope(const char* tag);
+	~AllocScope();
+
+private:
+	int m_previous_site; // -1 when the tracker was off at construction
+};
+
+#define ALLOC_SCOPE_CONCAT_(a, b) a##b
+#define ALLOC_SCOPE_CONCAT(a, b) ALLOC_SCOPE_CONCAT_(a, b)
+#define ALLOC_SCOPE(tag) AllocScope ALLOC_SCOPE_CONCAT(alloc_scope_, __LINE__)(tag)
@@ -1,4 +1,5 @@
 #include "attack.hpp"
+#include "renderQueue.hpp"
 
 Attack::~Attack() {
 }
@@ -23,4 +24,18 @@ void Attack::deincrement_pointer_references() {
 }
 void Attack::increment_pointer_references() {
 	m_pointer_references++;
-}
\ No newline at end of file
+}
+
+// Punches, uppercuts and dashes are hitboxes only, there is nothing to draw
+void Attack::submit(RenderQueue &queue) {
+}
+
+void Attack::submit_sprite(RenderQueue &queue, const Texture &texture) {
+	transform_begin();
+	transform_translate(m_position);
+	transform_scale(m_scale);
+	transform_end();
+
+	vec2 size = { (float)texture.width, (float)texture.height };
+	queue.submit_sprite(LAYER_ATTACKS, texture, transform, { -size.x * 0.5f, -size.y * 0.5f }, size);
+}
@@ -11,11 +11,17 @@ public:
 	BoundingBox get_bounding_box();
 	DamageEffect * get_damage_effect() const;
 	virtual void draw(const mat3 &projection) override = 0;
+	virtual void submit(RenderQueue &queue) override;
 	vec2 getPosition();
 	unsigned int get_pointer_references();
 	void deincrement_pointer_references();
 	void increment_pointer_references();
 
+protected:
+	// Queues a plain textured quad the size of the texture, centered on m_position
+	void submit_sprite(RenderQueue &queue, const Texture &texture);
+
+public:
 	int m_fighter_id;
 	vec2 m_scale;
 	vec2 m_position;
@@ -38,6 +38,7 @@ bool Background::init(vec2 screen, GameMode mode, Stage stage)
 	glBufferData(GL_ARRAY_BUFFER, sizeof(TexturedVertex) * 4, vertices, GL_STATIC_DRAW);
 
 	// Index Buffer creation
+	gl_bind_vertex_array(0);
 	glGenBuffers(1, &mesh.ibo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * 6, indices, GL_STATIC_DRAW);
@@ -79,6 +80,7 @@ bool Background::init(vec2 screen, GameMode mode, Stage stage)
 	width = lives2->get_width_of_string("XXX");
 	lives1->setPosition({ 50.f, 180.f });
 	lives2->setPosition({ screen.x-(width*1.05f), 180.f });
+	fightersLeft = new TextRenderer(mainFont, 44);
 
 	isPausedText = new TextRenderer(mainFontBold, 60);
 	width = isPausedText->get_width_of_string("PAUSED");
@@ -161,6 +163,7 @@ void Background::destroy()
 	delete block2;
 	delete lives1;
 	delete lives2;
+	delete fightersLeft;
 	delete isPausedText;
 	delete jump;
 	delete left;
@@ -181,6 +184,13 @@ void Background::destroy()
 }
 
 void Background::draw(const mat3& projection)
+{
+	ScreenFrame frame;
+	capture(frame);
+	frame.draw(projection);
+}
+
+void Background::capture(ScreenFrame& frame)
 {
 	// Transformation code, see Rendering and Transformation in the template specification for more info
 	// Incrementally updates transformation matrix, thus ORDER IS IMPORTANT
@@ -190,62 +200,23 @@ void Background::draw(const mat3& projection)
 	transform_scale(m_scale);
 	transform_end();
 
-	// Setting shaders
-	glUseProgram(effect.program);
-
-	// Enabling alpha channel for textures
-	glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDisable(GL_DEPTH_TEST);
-
-	// Getting uniform locations for glUniform* calls
-	GLint transform_uloc = glGetUniformLocation(effect.program, "transform");
-	GLint color_uloc = glGetUniformLocation(effect.program, "fcolor");
-	GLint projection_uloc = glGetUniformLocation(effect.program, "projection");
-	GLuint time_uloc = glGetUniformLocation(effect.program, "time");
-
-	// Setting vertices and indices
-	glBindVertexArray(mesh.vao);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
-
-	// Input data location as in the vertex buffer
-	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
-	GLint in_texcoord_loc = glGetAttribLocation(effect.program, "in_texcoord");
-	glEnableVertexAttribArray(in_position_loc);
-	glEnableVertexAttribArray(in_texcoord_loc);
-	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
-	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
+	frame.add_quad(mesh, effect.program, bg_texture.id, transform);
 
-	// Enabling and binding texture to slot 0
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, bg_texture.id);
-
-	// Setting uniform values to the currently bound program
-	glUniformMatrix3fv(transform_uloc, 1, GL_FALSE, (float*)&transform);
-	float color[] = { 1.f, 1.f, 1.f };
-	glUniform3fv(color_uloc, 1, color);
-	glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
-	glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
-
-	/////////////////////////
-
-	// Drawing!
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
-	drawPlayerInfo(projection);
+	capturePlayerInfo(frame);
 
 	if (m_help_on) {
-		drawTutorialText(projection);
+		captureTutorialText(frame);
 	}
 
 	if (m_mode == TUTORIAL || m_paused || m_is_game_over) {
-		handleText(projection);
+		handleText(frame);
 	} else if (warningText != "") {
 		float width = winnerText->get_width_of_string(warningText);
 		winnerText->setPosition({ screen.x / 2.f - width / 2.f, 100.f });
-		winnerText->renderString(projection, warningText);
+		frame.add_text(winnerText, warningText);
 	}
 
-	drawNameplates(projection);
+	captureNameplates(frame);
 }
 
 vec2 Background::get_position()const
@@ -280,90 +251,106 @@ void Background::setPlayerInfo(int p1Lives, int p1HP, int p1BL, int p2Lives, int
 	this->p2BL = p2BL;
 }
 
-void Background::drawPlayerInfo(const mat3& projection) {
+void Background::setFightersLeft(int left, int total) {
+	this->aisLeft = left;
+	this->aisTotal = total;
+}
+
+void Background::capturePlayerInfo(ScreenFrame& frame) {
 	std::stringstream ss1, ss2;
 	ss1 << "HP: " << p1HP;
 	ss2 << "HP: " << p2HP;
 
-	health1->renderString(projection, ss1.str());
-	health2->renderString(projection, ss2.str());
+	frame.add_text(health1, ss1.str());
+	// Too many AIs in a party to list, only how many are still standing
+	if (m_mode == PARTY) {
+		std::stringstream ss;
+		ss << "LEFT: " << aisLeft << "/" << aisTotal;
+		float width = fightersLeft->get_width_of_string(ss.str());
+		fightersLeft->setPosition({ screen.x - width * 1.1f, 100.f });
+		frame.add_text(fightersLeft, ss.str());
+	}
+	else {
+		frame.add_text(health2, ss2.str());
+	}
 
 	/*std::stringstream blss1, blss2;
 	blss1 << "BLOCK: " << p1BL;
 	blss2 << "BLOCK: " << p2BL;
 
-	block1->renderString(projection, blss1.str());
-	block2->renderString(projection, blss2.str());*/
+	frame.add_text(block1, blss1.str());
+	frame.add_text(block2, blss2.str());*/
 
 	switch (p1Lives) {
 	case 3:
-		lives1->renderString(projection, "XXX");
+		frame.add_text(lives1, "XXX");
 		break;
 	case 2:
-		lives1->renderString(projection, "XX");
+		frame.add_text(lives1, "XX");
 		break;
 	case 1:
-		lives1->renderString(projection, "X");
+		frame.add_text(lives1, "X");
 		break;
 	}
 	switch (p2Lives) {
 	case 3:
-		lives2->renderString(projection, "XXX");
+		frame.add_text(lives2, "XXX");
 		break;
 	case 2:
-		lives2->renderString(projection, "XX");
+		frame.add_text(lives2, "XX");
 		break;
 	case 1:
-		lives2->renderString(projection, "X");
+		frame.add_text(lives2, "X");
 		break;
 	}
 }
 
-void Background::handleText(const mat3& projection) {
+void Background::handleText(ScreenFrame& frame) {
+	color_buttons();
 	if (m_is_game_over) {
 		float width = winnerText->get_width_of_string("CREAM OF CROP:aaaa" + winnerName);
 		winnerText->setPosition({ screen.x / 2.f - width / 2.f, 100.f });
-		winnerText->renderString(projection, "CREAM OF THE CROP: " + winnerName);
-		buttons[0]->renderString(projection, "RESTART");
-		buttons[1]->renderString(projection, "MAIN MENU");
-		buttons[2]->renderString(projection, "QUIT");
+		frame.add_text(winnerText, "CREAM OF THE CROP: " + winnerName);
+		frame.add_text(buttons[0], "RESTART");
+		frame.add_text(buttons[1], "MAIN MENU");
+		frame.add_text(buttons[2], "QUIT");
 	}
 	else if (m_paused) {
-		isPausedText->renderString(projection, "PAUSED");
-		buttons[0]->renderString(projection, "RESUME");
-		buttons[1]->renderString(projection, "MAIN MENU");
-		buttons[2]->renderString(projection, "QUIT");
+		frame.add_text(isPausedText, "PAUSED");
+		frame.add_text(buttons[0], "RESUME");
+		frame.add_text(buttons[1], "MAIN MENU");
+		frame.add_text(buttons[2], "QUIT");
 	}
 	else {
-		drawTutorialText(projection);
+		captureTutorialText(frame);
 	}
 }
 
-void Background::drawTutorialText(const mat3& projection) {
-	jump->renderString(projection, "W/I: Jump");
-	left->renderString(projection, "A/J: Move left");
-	right->renderString(projection, "D/L: Move right");
-	crouch->renderString(projection, "S/K: Crouch");
-	pause->renderString(projection, "Esc: Pause");
-	reset->renderString(projection, "F5: Reset");
-	ability1->renderString(projection, "V/NUM2/Comma: Special Ability");
-	ability2->renderString(projection, "B/NUM3/Period: Special Ability");
-	shield->renderString(projection, "L Shift/R Shift: Block");
-	punch->renderString(projection, "C/NUM1/Slash: Punch");
-	pauseMusic->renderString(projection, "Insert: Pause/Resume song");
-	randomSong->renderString(projection, "Home: Random song");
-	changeSong->renderString(projection, "Delete/End: Prev/Next song");
-	changeVolume->renderString(projection, "Page Up/Down: Inc./Dec. volume");
+void Background::captureTutorialText(ScreenFrame& frame) {
+	frame.add_text(jump, "W/I: Jump");
+	frame.add_text(left, "A/J: Move left");
+	frame.add_text(right, "D/L: Move right");
+	frame.add_text(crouch, "S/K: Crouch");
+	frame.add_text(pause, "Esc: Pause");
+	frame.add_text(reset, "F5: Reset");
+	frame.add_text(ability1, "V/NUM2/Comma: Special Ability");
+	frame.add_text(ability2, "B/NUM3/Period: Special Ability");
+	frame.add_text(shield, "L Shift/R Shift: Block");
+	frame.add_text(punch, "C/NUM1/Slash: Punch");
+	frame.add_text(pauseMusic, "Insert: Pause/Resume song");
+	frame.add_text(randomSong, "Home: Random song");
+	frame.add_text(changeSong, "Delete/End: Prev/Next song");
+	frame.add_text(changeVolume, "Page Up/Down: Inc./Dec. volume");
 }
 
 void Background::addNameplate(TextRenderer* td, std::string name) {
 	nameplates[td] = name;
 }
-void Background::drawNameplates(const mat3& projection) {
+void Background::captureNameplates(ScreenFrame& frame) {
 	std::map<TextRenderer*, std::string>::iterator it = nameplates.begin();
 	while (it != nameplates.end())
 	{
-		it->first->renderString(projection, it->second);
+		frame.add_text(it->first, it->second);
 		it++;
 	}
 }
@@ -4,6 +4,7 @@
 #include "fighterInfo.hpp"
 #include "textRenderer.hpp"
 #include "mainMenu.hpp"
+#include "screenFrame.hpp"
 #include <string.h>
 
 // Background
@@ -19,6 +20,7 @@ class Background : public Renderable, public Screen
 	TextRenderer* block2;
 	TextRenderer* lives1;
 	TextRenderer* lives2;
+	TextRenderer* fightersLeft;
 	TextRenderer* isPausedText;
 	TextRenderer* jump;
 	TextRenderer* left;
@@ -46,6 +48,8 @@ public:
 
 	// projection is the 2D orthographic projection matrix
 	void draw(const mat3& projection)override;
+	// Records what draw() shows, the HUD and nameplates take their places here
+	void capture(ScreenFrame& frame);
 
 	// Returns the current bubble position
 	vec2 get_position()const;
@@ -57,13 +61,14 @@ public:
 	void setHelp(bool isHelpOn);
 	bool getHelp();
 	void setPlayerInfo(int p1Lives, int p1HP, int p1BL, int p2Lives, int p2HP, int p2BL); // set to -1 if player is not initialized
-	void drawPlayerInfo(const mat3& projection);
-	void handleText(const mat3& projection);
-	void drawTutorialText(const mat3& projection);
+	void setFightersLeft(int left, int total); // party mode, shown instead of player 2's info
+	void capturePlayerInfo(ScreenFrame& frame);
+	void handleText(ScreenFrame& frame);
+	void captureTutorialText(ScreenFrame& frame);
 	//void drawWarning(const mat3& projection, std::string t);
 
 	void addNameplate(TextRenderer* td, std::string name);
-	void drawNameplates(const mat3& projection);
+	void captureNameplates(ScreenFrame& frame);
 	void init_buttons();
 	PauseMenuOption get_selected();
 	void set_game_over(bool go, std::string wn);
@@ -88,6 +93,8 @@ private:
 	int p2HP = -1;
 	std::string winnerName = "";
 	int p2BL = -1;
+	int aisLeft = 0;
+	int aisTotal = 0;
 
 	std::map<TextRenderer*, std::string> nameplates;
 };
\ No newline at end of file
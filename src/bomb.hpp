@@ -11,8 +11,12 @@ public:
 	Bomb(int id, vec2 pos, unsigned int damage, float vert_force, float ms);
 	~Bomb();
 	bool init();
+	// Loaded with the other sprites before the first tick, attacks are created mid-tick
+	// where no GL calls are made
+	static bool load_texture();
 	void update(float ms);
 	void draw(const mat3 &projection) override;
+	void submit(RenderQueue &queue) override;
 private:
 	float m_velocity_y = 0;
 	const vec2 gravity = { 0.0, 800.0 };
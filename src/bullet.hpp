@@ -13,5 +13,6 @@ public:
 	bool init();
 	void update(float ms);
 	void draw(const mat3 &projection) override;
+	void submit(RenderQueue &queue) override;
 private:
 };
\ No newline at end of file
@@ -1,9 +1,16 @@
 #include "common.hpp"
+#include "renderQueue.hpp"
+#include "allocTracker.hpp"
+#include "shaderCache.hpp"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../ext/stb_image/stb_image.h"
 
 // stlib
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <mutex>
 #include <vector>
 #include <iostream>
 #include <sstream>
@@ -48,6 +55,206 @@ bool gl_has_errors()
 	return true;
 }
 
+namespace
+{
+	const GLuint GL_STATE_UNKNOWN = 0xFFFFFFFF;
+	const int GL_STATE_TEXTURE_UNITS = 8;
+
+	struct GLStateCache
+	{
+		GLuint program;
+		GLuint vao;
+		GLuint array_buffer;
+		GLuint element_buffer;
+		GLenum active_texture;
+		GLuint textures[GL_STATE_TEXTURE_UNITS];
+		GLuint blend; // 0, 1 or unknown
+		GLuint depth_test;
+		GLuint rasterizer_discard;
+		GLenum blend_src;
+		GLenum blend_dst;
+	};
+
+	GLStateCache g_gl_state;
+	GLuint g_screen_frame_buffer = 0;
+	GLStateStats g_gl_stats = { 0, 0, 0 };
+	GLStateStats g_gl_last_stats = { 0, 0, 0 };
+
+	// Updates the cached value, returns true if the call has to reach the driver
+	bool gl_state_changed(GLuint& cached, GLuint value)
+	{
+		if (cached == value)
+		{
+			g_gl_stats.elided++;
+			return false;
+		}
+		cached = value;
+		g_gl_stats.issued++;
+		return true;
+	}
+
+	GLuint* gl_state_cap(GLenum cap)
+	{
+		switch (cap)
+		{
+		case GL_BLEND: return &g_gl_state.blend;
+		case GL_DEPTH_TEST: return &g_gl_state.depth_test;
+		case GL_RASTERIZER_DISCARD: return &g_gl_state.rasterizer_discard;
+		default: return nullptr;
+		}
+	}
+}
+
+void gl_use_program(GLuint program)
+{
+	if (gl_state_changed(g_gl_state.program, program))
+		glUseProgram(program);
+}
+
+void gl_bind_vertex_array(GLuint vao)
+{
+	if (gl_state_changed(g_gl_state.vao, vao))
+	{
+		glBindVertexArray(vao);
+		// The element buffer binding is part of the vertex array state
+		g_gl_state.element_buffer = GL_STATE_UNKNOWN;
+	}
+}
+
+void gl_bind_buffer(GLenum target, GLuint buffer)
+{
+	if (target == GL_ARRAY_BUFFER)
+	{
+		if (gl_state_changed(g_gl_state.array_buffer, buffer))
+			glBindBuffer(target, buffer);
+	}
+	else if (target == GL_ELEMENT_ARRAY_BUFFER)
+	{
+		if (gl_state_changed(g_gl_state.element_buffer, buffer))
+			glBindBuffer(target, buffer);
+	}
+	else
+	{
+		g_gl_stats.issued++;
+		glBindBuffer(target, buffer);
+	}
+}
+
+void gl_active_texture(GLenum unit)
+{
+	if (gl_state_changed(g_gl_state.active_texture, unit))
+		glActiveTexture(unit);
+}
+
+void gl_bind_texture(GLenum target, GLuint texture)
+{
+	GLuint unit = g_gl_state.active_texture - GL_TEXTURE0;
+	if (target == GL_TEXTURE_2D && g_gl_state.active_texture != GL_STATE_UNKNOWN && unit < GL_STATE_TEXTURE_UNITS)
+	{
+		if (gl_state_changed(g_gl_state.textures[unit], texture))
+			glBindTexture(target, texture);
+	}
+	else
+	{
+		g_gl_stats.issued++;
+		glBindTexture(target, texture);
+	}
+}
+
+void gl_enable(GLenum cap)
+{
+	GLuint* cached = gl_state_cap(cap);
+	if (cached == nullptr)
+	{
+		g_gl_stats.issued++;
+		glEnable(cap);
+	}
+	else if (gl_state_changed(*cached, 1))
+		glEnable(cap);
+}
+
+void gl_disable(GLenum cap)
+{
+	GLuint* cached = gl_state_cap(cap);
+	if (cached == nullptr)
+	{
+		g_gl_stats.issued++;
+		glDisable(cap);
+	}
+	else if (gl_state_changed(*cached, 0))
+		glDisable(cap);
+}
+
+void gl_blend_func(GLenum sfactor, GLenum dfactor)
+{
+	if (g_gl_state.blend_src == sfactor && g_gl_state.blend_dst == dfactor)
+	{
+		g_gl_stats.elided++;
+		return;
+	}
+	g_gl_state.blend_src = sfactor;
+	g_gl_state.blend_dst = dfactor;
+	g_gl_stats.issued++;
+	glBlendFunc(sfactor, dfactor);
+}
+
+void gl_draw_arrays(GLenum mode, GLint first, GLsizei count)
+{
+	g_gl_stats.draw_calls++;
+	glDrawArrays(mode, first, count);
+}
+
+void gl_draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instances)
+{
+	g_gl_stats.draw_calls++;
+	glDrawArraysInstanced(mode, first, count, instances);
+}
+
+void gl_draw_elements(GLenum mode, GLsizei count, GLenum type, const void* indices)
+{
+	g_gl_stats.draw_calls++;
+	glDrawElements(mode, count, type, indices);
+}
+
+void gl_state_invalidate()
+{
+	g_gl_state.program = GL_STATE_UNKNOWN;
+	g_gl_state.vao = GL_STATE_UNKNOWN;
+	g_gl_state.array_buffer = GL_STATE_UNKNOWN;
+	g_gl_state.element_buffer = GL_STATE_UNKNOWN;
+	g_gl_state.active_texture = GL_STATE_UNKNOWN;
+	for (int i = 0; i < GL_STATE_TEXTURE_UNITS; i++)
+		g_gl_state.textures[i] = GL_STATE_UNKNOWN;
+	g_gl_state.blend = GL_STATE_UNKNOWN;
+	g_gl_state.depth_test = GL_STATE_UNKNOWN;
+	g_gl_state.rasterizer_discard = GL_STATE_UNKNOWN;
+	g_gl_state.blend_src = GL_STATE_UNKNOWN;
+	g_gl_state.blend_dst = GL_STATE_UNKNOWN;
+}
+
+void gl_state_begin_frame()
+{
+	// Objects may have been deleted or recreated since the last frame
+	gl_state_invalidate();
+	g_gl_last_stats = g_gl_stats;
+	g_gl_stats = { 0, 0, 0 };
+}
+
+GLStateStats gl_state_frame_stats()
+{
+	return g_gl_last_stats;
+}
+
+void gl_set_screen_framebuffer(GLuint frame_buffer)
+{
+	g_screen_frame_buffer = frame_buffer;
+}
+
+GLuint gl_screen_framebuffer()
+{
+	return g_screen_frame_buffer;
+}
+
 float dot(vec2 l, vec2 r)
 {
 	return l.x * r.x + l.y * r.y;
@@ -85,20 +292,63 @@ vec2 normalize(vec2 v)
 	return { v.x / m, v.y / m };
 }
 
+namespace
+{
+	bool g_fixed_seed = false;
+	std::mt19937 g_seed_sequence;
+	std::mutex g_seed_mutex; // fighters and attacks spawned by job workers draw seeds too
+}
+
+void set_random_seed(unsigned seed)
+{
+	g_fixed_seed = seed != 0;
+	g_seed_sequence.seed(seed);
+	srand(seed);
+}
+
+unsigned next_random_seed()
+{
+	if (g_fixed_seed)
+	{
+		std::lock_guard<std::mutex> lock(g_seed_mutex);
+		return g_seed_sequence();
+	}
+	return std::random_device()();
+}
+
 int get_random_number(int max) {
-	std::random_device rd; // non-deterministic generator
-	std::mt19937 gen(rd());
+	std::mt19937 gen(next_random_seed());
 	std::uniform_int_distribution<> dist(0, max);
 	return dist(gen);
 }
 
-Texture::Texture()
+namespace
+{
+	// Textures loaded from a file, found by reload_texture_file() when the file changes.
+	// Never destroyed, global textures of other files unregister after it would be
+	std::multimap<std::string, Texture*>& texture_files()
+	{
+		static std::multimap<std::string, Texture*>* files = new std::multimap<std::string, Texture*>();
+		return *files;
+	}
+}
+
+Texture::Texture() : id(0), depth_render_buffer_id(0), width(0), height(0)
 {
 
 }
 
 Texture::~Texture()
 {
+	std::multimap<std::string, Texture*>& files = texture_files();
+	for (auto it = files.begin(); id != 0 && it != files.end(); ++it)
+	{
+		if (it->second == this)
+		{
+			files.erase(it);
+			break;
+		}
+	}
 	if (id != 0) glDeleteTextures(1, &id);
 	if (depth_render_buffer_id != 0) glDeleteRenderbuffers(1, &depth_render_buffer_id);
 }
@@ -119,9 +369,45 @@ bool Texture::load_from_file(const char* path)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 	stbi_image_free(data);
+	if (gl_has_errors())
+		return false;
+
+	texture_files().insert({ path, this });
+	return true;
+}
+
+bool Texture::reload_from_file(const char* path)
+{
+	int new_width, new_height;
+	stbi_uc* data = stbi_load(path, &new_width, &new_height, NULL, 4);
+	if (data == NULL)
+		return false;
+
+	// Same texture object, whoever holds the id sees the new picture
+	gl_flush_errors();
+	glBindTexture(GL_TEXTURE_2D, id);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, new_width, new_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
+	stbi_image_free(data);
+	width = new_width;
+	height = new_height;
 	return !gl_has_errors();
 }
 
+int reload_texture_file(const std::string& path)
+{
+	int reloaded = 0;
+	auto range = texture_files().equal_range(path);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (it->second->reload_from_file(path.c_str()))
+			reloaded++;
+		else
+			fprintf(stderr, "Failed to reload %s\n", path.c_str());
+	}
+	gl_state_invalidate();
+	return reloaded;
+}
+
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
 bool Texture::create_from_screen(GLFWwindow const * const window) {
 	gl_flush_errors();
@@ -183,24 +469,14 @@ namespace
 
 bool Effect::load_from_file(const char* vs_path, const char* fs_path)
 {
-	gl_flush_errors();
-
-	// Opening files
-	std::ifstream vs_is(vs_path);
-	std::ifstream fs_is(fs_path);
+	// Shared with the other effects loaded from the same files
+	return shader_cache_load(vs_path, fs_path, *this);
+}
 
-	if (!vs_is.good() || !fs_is.good())
-	{
-		fprintf(stderr, "Failed to load shader files %s, %s", vs_path, fs_path);
-		return false;
-	}
+bool Effect::load_from_source(const std::string& vs_str, const std::string& fs_str)
+{
+	gl_flush_errors();
 
-	// Reading sources
-	std::stringstream vs_ss, fs_ss;
-	vs_ss << vs_is.rdbuf();
-	fs_ss << fs_is.rdbuf();
-	std::string vs_str = vs_ss.str();
-	std::string fs_str = fs_ss.str();
 	const char* vs_src = vs_str.c_str();
 	const char* fs_src = fs_str.c_str();
 	GLsizei vs_len = (GLsizei)vs_str.size();
@@ -253,13 +529,75 @@ bool Effect::load_from_file(const char* vs_path, const char* fs_path)
 	return true;
 }
 
+bool Effect::load_feedback_from_file(const char* vs_path, const char* const* varyings, int num_varyings)
+{
+	gl_flush_errors();
+
+	std::ifstream vs_is(vs_path);
+	if (!vs_is.good())
+	{
+		fprintf(stderr, "Failed to load shader file %s", vs_path);
+		return false;
+	}
+
+	std::stringstream vs_ss;
+	vs_ss << vs_is.rdbuf();
+	std::string vs_str = vs_ss.str();
+	const char* vs_src = vs_str.c_str();
+	GLsizei vs_len = (GLsizei)vs_str.size();
+
+	fragment = 0;
+	vertex = glCreateShader(GL_VERTEX_SHADER);
+	glShaderSource(vertex, 1, &vs_src, &vs_len);
+	if (!gl_compile_shader(vertex))
+		return false;
+
+	// Varyings have to be declared before linking
+	program = glCreateProgram();
+	glAttachShader(program, vertex);
+	glTransformFeedbackVaryings(program, num_varyings, varyings, GL_INTERLEAVED_ATTRIBS);
+	glLinkProgram(program);
+	{
+		GLint is_linked = 0;
+		glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+		if (is_linked == GL_FALSE)
+		{
+			GLint log_len;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_len);
+			std::vector<char> log(log_len);
+			glGetProgramInfoLog(program, log_len, &log_len, log.data());
+
+			release();
+			fprintf(stderr, "Link error: %s", log.data());
+			return false;
+		}
+	}
+
+	if (gl_has_errors())
+	{
+		release();
+		fprintf(stderr, "OpenGL errors occured while compiling Effect");
+		return false;
+	}
+
+	return true;
+}
+
 void Effect::release()
 {
+  if (shader_cache_release(program))
+  {
+    program = 0; // released twice must not take another user's reference
+    return;
+  }
   glDetachShader(program, vertex);
   glDeleteShader(vertex);
   //
-  glDetachShader(program, fragment);
-  glDeleteShader(fragment);
+  if (fragment != 0)
+  {
+    glDetachShader(program, fragment);
+    glDeleteShader(fragment);
+  }
   //
   glDeleteProgram(program);
 }
@@ -271,6 +609,11 @@ std::string fonts_path(std::string name) {
 	return ss.str();
 }
 
+void Renderable::submit(RenderQueue &queue)
+{
+	queue.submit_custom(LAYER_BACKGROUND, this);
+}
+
 void Renderable::transform_begin()
 {
 	transform = { { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f}, { 0.f, 0.f, 1.f} };
@@ -278,22 +621,30 @@ void Renderable::transform_begin()
 
 void Renderable::transform_scale(vec2 scale)
 {
-	mat3 S = { { scale.x, 0.f, 0.f },{ 0.f, scale.y, 0.f },{ 0.f, 0.f, 1.f } };
-	transform = mul(transform, S);
+	transform.c0.x *= scale.x;
+	transform.c0.y *= scale.x;
+	transform.c1.x *= scale.y;
+	transform.c1.y *= scale.y;
 }
 
 void Renderable::transform_rotate(float radians)
 {
+	// Fighters standing up and most sprites are never rotated
+	if (radians == 0.f)
+		return;
 	float c = cosf(radians);
 	float s = sinf(radians);
-	mat3 R = { { c, s, 0.f },{ -s, c, 0.f },{ 0.f, 0.f, 1.f } };
-	transform = mul(transform, R);
+	vec3 c0 = transform.c0;
+	transform.c0.x = c0.x * c + transform.c1.x * s;
+	transform.c0.y = c0.y * c + transform.c1.y * s;
+	transform.c1.x = c0.x * -s + transform.c1.x * c;
+	transform.c1.y = c0.y * -s + transform.c1.y * c;
 }
 
 void Renderable::transform_translate(vec2 offset)
 {
-	mat3 T = { { 1.f, 0.f, 0.f },{ 0.f, 1.f, 0.f },{ offset.x, offset.y, 1.f } };
-	transform = mul(transform, T);
+	transform.c2.x = transform.c0.x * offset.x + transform.c1.x * offset.y + transform.c2.x;
+	transform.c2.y = transform.c0.y * offset.x + transform.c1.y * offset.y + transform.c2.y;
 }
 
 void Renderable::transform_end()
@@ -472,8 +823,28 @@ void QuadTree::insertIntoSubtree(Quadrant quadrant, Renderable* renderable)
 /*
  * Return all objects that could collide with the given BoundingBox
  */
+namespace
+{
+	std::atomic<int> g_quadtree_queries{ 0 };
+	thread_local int g_quadtree_depth = 0; // so recursing into subtrees is not counted as more queries
+}
+
+int QuadTree::get_query_count()
+{
+	return g_quadtree_queries;
+}
+
+void QuadTree::reset_query_count()
+{
+	g_quadtree_queries = 0;
+}
+
 std::vector<Renderable*> QuadTree::retrieve(BoundingBox boundingBox, std::vector<Renderable*> returnObjs) 
 {
+	ALLOC_SCOPE("QuadTree::retrieve");
+	if (g_quadtree_depth++ == 0)
+		g_quadtree_queries++;
+
 	Quadrant quadrant = getQuadrant(boundingBox);
 	if (quadrant != NONE && m_botLeftTree != NULL) {
 		std::vector<Renderable*> platforms;
@@ -499,5 +870,6 @@ std::vector<Renderable*> QuadTree::retrieve(BoundingBox boundingBox, std::vector
 
 	returnObjs.insert(returnObjs.end(), m_objects.begin(), m_objects.end());
 
+	g_quadtree_depth--;
 	return returnObjs;
 }
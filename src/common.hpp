@@ -23,6 +23,9 @@
 #define textures_path(name) data_path "/textures/" name
 #define audio_path(name) data_path "/audio/" name
 #define mesh_path(name) data_path "/meshes/" name
+#define replays_path(name) data_path "/replays/" name
+#define golden_path(name) data_path "/golden/" name
+#define fighters_path(name) data_path "/fighters/" name
 
 #define PI 3.14159265
 
@@ -52,11 +55,53 @@ mat3 mul(const mat3 &l, const mat3 &r);
 vec2 normalize(vec2 v);
 int get_random_number(int max);
 
+// Seeds for the game's random generators, from std::random_device unless a fixed
+// seed was set. With one set, runs that make the same calls in the same order repeat
+// exactly (rand() is seeded too). 0 goes back to random seeds
+void set_random_seed(unsigned seed);
+unsigned next_random_seed();
+
 // OpenGL utilities
 // cleans error buffer
 void gl_flush_errors();
 bool gl_has_errors();
 
+// OpenGL state cache, skips binds and toggles that would not change anything.
+// Draw code should go through these instead of the raw gl* calls; anything that
+// bypasses them must be followed by gl_state_invalidate()
+void gl_use_program(GLuint program);
+// The element buffer binding belongs to the bound vertex array, bind 0 before creating
+// an index buffer outside of one or the last drawn vertex array takes it on
+void gl_bind_vertex_array(GLuint vao);
+void gl_bind_buffer(GLenum target, GLuint buffer);
+void gl_active_texture(GLenum unit);
+void gl_bind_texture(GLenum target, GLuint texture);
+void gl_enable(GLenum cap);
+void gl_disable(GLenum cap);
+void gl_blend_func(GLenum sfactor, GLenum dfactor);
+void gl_state_invalidate();
+
+// Draw calls, counted for the frame stats
+void gl_draw_arrays(GLenum mode, GLint first, GLsizei count);
+void gl_draw_arrays_instanced(GLenum mode, GLint first, GLsizei count, GLsizei instances);
+void gl_draw_elements(GLenum mode, GLsizei count, GLenum type, const void *indices);
+
+// Number of state calls issued to / elided from the driver, and draw calls
+struct GLStateStats
+{
+	int issued;
+	int elided;
+	int draw_calls;
+};
+// Call once at the start of each frame, also invalidates the cache
+void gl_state_begin_frame();
+GLStateStats gl_state_frame_stats(); // totals of the last completed frame
+
+// Framebuffer that stands for the screen, 0 (the window) unless the world renders
+// offscreen. Passes that finish on the screen bind this instead of 0
+void gl_set_screen_framebuffer(GLuint frame_buffer);
+GLuint gl_screen_framebuffer();
+
 // Single Vertex Buffer element for non-textured meshes (colored.vs.glsl)
 struct Vertex
 {
@@ -84,12 +129,17 @@ struct Texture
 
 	// Loads texture from file specified by path
 	bool load_from_file(const char *path);
+	// Uploads the file again into the same GL texture, its size may change
+	bool reload_from_file(const char *path);
 
 	// Screen texture
 	bool create_from_screen(GLFWwindow const *const window);
 	bool is_valid() const; // True if texture is valid
 };
 
+// Reloads every texture loaded from path in place, returns how many
+int reload_texture_file(const std::string& path);
+
 // A Mesh is a collection of a VertexBuffer and an IndexBuffer. A VAO
 // represents a Vertex Array Object and is the container for 1 or more Vertex Buffers and
 // an Index Buffer
@@ -105,6 +155,10 @@ struct Mesh
 struct Effect
 {
 	bool load_from_file(const char *vs_path, const char *fs_path);
+	// Same as above from in-memory sources, e.g. shaders generated at runtime
+	bool load_from_source(const std::string &vs_src, const std::string &fs_src);
+	// Vertex-only program whose outputs are captured with transform feedback
+	bool load_feedback_from_file(const char *vs_path, const char *const *varyings, int num_varyings);
 	void release();
 
 	GLuint vertex;
@@ -112,6 +166,8 @@ struct Effect
 	GLuint program;
 };
 
+class RenderQueue;
+
 // Helper container for all the information we need when rendering an object together
 // with its transform.
 struct Renderable
@@ -124,8 +180,13 @@ struct Renderable
 	// renders itself it needs it to correctly bind it to its shader.
 	virtual void draw(const mat3 &projection) = 0;
 
+	// Queues this object for drawing, by default as a custom command on the background
+	// layer that calls back into draw()
+	virtual void submit(RenderQueue &queue);
+
 	// gl Immediate mode equivalent, see the Rendering and Transformations section in the
-	// specification pdf
+	// specification pdf. The transform stays affine, so each step only updates its top
+	// two rows instead of multiplying full matrices
 	void transform_begin();
 	void transform_scale(vec2 scale);
 	void transform_rotate(float radians);
@@ -168,6 +229,10 @@ public:
     void insert(Renderable* renderable); 
 	void insertIntoSubtree(Quadrant quadrant, Renderable* renderable);
     std::vector<Renderable*> retrieve(BoundingBox boundingBox, std::vector<Renderable*> returnObjs);
+
+	// Top level retrieve() calls on any tree since the last reset
+	static int get_query_count();
+	static void reset_query_count();
 }; 
   
 enum AIType
@@ -230,6 +295,7 @@ enum GameMode
 	PVC, // single player
 	PVP, // 2 player
 	TUTORIAL,
+	PARTY, // free-for-all, player 1 against many AIs
 	DEV,
 };
 
@@ -242,4 +308,4 @@ enum PauseMenuOption
 };
 
 // For console log printing
-static const char* ModeMap[] = { "MENU", "CHARSELECT", "STAGESELECT", "FIGHTINTRO", "PVC", "PVP", "TUTORIAL", "DEV" };
+static const char* ModeMap[] = { "MENU", "CHARSELECT", "STAGESELECT", "FIGHTINTRO", "PVC", "PVP", "TUTORIAL", "PARTY", "DEV" };
@@ -0,0 +1,247 @@
+// Header
+#include "componentStore.hpp"
+#include "fighter.hpp"
+#include "attack.hpp"
+#include "fighterDefinition.hpp"
+
+#include <algorithm>
+#include <limits>
+
+void FighterRows::resize(int count)
+{
+	fighter.resize(count);
+	id.resize(count);
+	x.resize(count);
+	y.resize(count);
+	box_x.resize(count);
+	box_y.resize(count);
+	box_w.resize(count);
+	box_h.resize(count);
+	alive.resize(count);
+	blocking.resize(count);
+}
+
+void HitboxRows::resize(int count)
+{
+	attack.resize(count);
+	owner.resize(count);
+	x.resize(count);
+	y.resize(count);
+	w.resize(count);
+	h.resize(count);
+}
+
+void BodyRows::resize(int count)
+{
+	force_x.resize(count);
+	force_y.resize(count);
+	mass.resize(count);
+	friction.resize(count);
+	velocity_y.resize(count);
+	health.resize(count);
+	block_tank_ms.resize(count);
+}
+
+void YamRows::resize(int count)
+{
+	is_healing.resize(count);
+	heal_cooldown_ms.resize(count);
+	heal_animation_ms.resize(count);
+	start_dashing.resize(count);
+	dash_cooldown_ms.resize(count);
+	dash_timer_ms.resize(count);
+}
+
+int ComponentStore::add_fighter()
+{
+	int slot;
+	if (m_free_bodies.empty())
+	{
+		slot = bodies.size();
+		bodies.resize(slot + 1);
+	}
+	else
+	{
+		slot = m_free_bodies.back();
+		m_free_bodies.pop_back();
+	}
+	bodies.force_x[slot] = 0.f;
+	bodies.force_y[slot] = 0.f;
+	bodies.mass[slot] = 1.f;
+	bodies.friction[slot] = 1.f;
+	bodies.velocity_y[slot] = 0.f;
+	bodies.health[slot] = 0;
+	bodies.block_tank_ms[slot] = 0;
+	return slot;
+}
+
+void ComponentStore::remove_fighter(int slot)
+{
+	m_free_bodies.push_back(slot);
+}
+
+int ComponentStore::add_yam()
+{
+	int row;
+	if (m_free_yams.empty())
+	{
+		row = yams.size();
+		yams.resize(row + 1);
+	}
+	else
+	{
+		row = m_free_yams.back();
+		m_free_yams.pop_back();
+	}
+	yams.is_healing[row] = false;
+	yams.heal_cooldown_ms[row] = 0.f;
+	yams.heal_animation_ms[row] = 0.f;
+	yams.start_dashing[row] = false;
+	yams.dash_cooldown_ms[row] = 0.f;
+	yams.dash_timer_ms[row] = 0.f;
+	return row;
+}
+
+void ComponentStore::remove_yam(int row)
+{
+	m_free_yams.push_back(row);
+}
+
+float ComponentStore::push(int slot)
+{
+	float& force_x = bodies.force_x[slot];
+	float speed = force_x / bodies.mass[slot];
+	if (force_x > 0.f)
+		force_x = std::max(force_x - bodies.friction[slot], 0.f);
+	else if (force_x < 0.f)
+		force_x = std::min(force_x + bodies.friction[slot], 0.f);
+	return speed;
+}
+
+float ComponentStore::fall(int slot, float ms, const FighterDefinition& def)
+{
+	float& velocity_y = bodies.velocity_y[slot];
+	float s = ms / 1000;
+	float dy = velocity_y * s;
+	velocity_y += def.gravity * s;
+	if (velocity_y > def.terminal_velocity)
+		velocity_y = def.terminal_velocity;
+	else if (velocity_y < -def.terminal_velocity)
+		velocity_y = -def.terminal_velocity;
+	return dy;
+}
+
+bool ComponentStore::heal(int row, float ms, const FighterDefinition& def)
+{
+	bool lands = false;
+	if (yams.is_healing[row])
+	{
+		if (yams.heal_cooldown_ms[row] <= 0.f)
+		{
+			lands = true;
+			yams.heal_cooldown_ms[row] = def.heal_cooldown_ms;
+			yams.heal_animation_ms[row] = def.heal_animation_ms;
+		}
+		yams.is_healing[row] = false;
+	}
+	if (yams.heal_cooldown_ms[row] > 0.f)
+		yams.heal_cooldown_ms[row] -= ms;
+	if (yams.heal_animation_ms[row] > 0.f)
+		yams.heal_animation_ms[row] -= ms;
+	return lands;
+}
+
+DashStep ComponentStore::dash(int row, float ms, const FighterDefinition& def)
+{
+	if (yams.start_dashing[row])
+	{
+		if (yams.dash_cooldown_ms[row] <= 0.f)
+			yams.dash_timer_ms[row] = def.dash_ms;
+		yams.start_dashing[row] = false;
+	}
+	if (yams.dash_cooldown_ms[row] > 0.f)
+		yams.dash_cooldown_ms[row] -= ms;
+	if (yams.dash_timer_ms[row] <= 0.f)
+		return NOT_DASHING;
+	yams.dash_timer_ms[row] -= ms;
+	if (yams.dash_timer_ms[row] > 0.f)
+		return DASHING;
+	yams.dash_cooldown_ms[row] = def.dash_cooldown_ms;
+	return DASH_ENDED;
+}
+
+void ComponentStore::gather_fighters(const std::vector<Fighter*>& list)
+{
+	fighters.resize((int)list.size());
+	for (int i = 0; i < (int)list.size(); i++)
+	{
+		Fighter* fighter = list[i];
+		vec2 position = fighter->get_position();
+		BoundingBox box = fighter->get_bounding_box();
+		fighters.fighter[i] = fighter;
+		fighters.id[i] = fighter->get_id();
+		fighters.x[i] = position.x;
+		fighters.y[i] = position.y;
+		fighters.box_x[i] = box.xpos;
+		fighters.box_y[i] = box.ypos;
+		fighters.box_w[i] = box.width;
+		fighters.box_h[i] = box.height;
+		fighters.alive[i] = fighter->get_alive() != 0;
+		fighters.blocking[i] = fighter->is_blocking();
+	}
+}
+
+void ComponentStore::gather_hitboxes(const std::vector<Attack*>& list)
+{
+	hitboxes.resize((int)list.size());
+	for (int i = 0; i < (int)list.size(); i++)
+	{
+		const BoundingBox& box = list[i]->m_damageEffect->m_bounding_box;
+		hitboxes.attack[i] = list[i];
+		hitboxes.owner[i] = list[i]->m_fighter_id;
+		hitboxes.x[i] = box.xpos;
+		hitboxes.y[i] = box.ypos;
+		hitboxes.w[i] = box.width;
+		hitboxes.h[i] = box.height;
+	}
+}
+
+void ComponentStore::find_hits(int row, std::vector<int>& hits) const
+{
+	if (fighters.blocking[row])
+		return;
+
+	// Same test as BoundingBox::check_collision()
+	int id = (int)fighters.id[row];
+	float left = fighters.box_x[row];
+	float top = fighters.box_y[row];
+	float right = left + fighters.box_w[row];
+	float bottom = top + fighters.box_h[row];
+	for (int i = 0; i < hitboxes.size(); i++)
+	{
+		bool overlaps = hitboxes.x[i] < right && hitboxes.x[i] + hitboxes.w[i] > left &&
+			hitboxes.y[i] < bottom && hitboxes.y[i] + hitboxes.h[i] > top;
+		if (overlaps && hitboxes.owner[i] != id)
+			hits.push_back(i);
+	}
+}
+
+int ComponentStore::find_closest(int row) const
+{
+	int closest = -1;
+	float closest_distance = std::numeric_limits<float>::max();
+	for (int i = 0; i < fighters.size(); i++)
+	{
+		if (i == row || !fighters.alive[i])
+			continue;
+		float dx = fighters.x[i] - fighters.x[row];
+		float dy = fighters.y[i] - fighters.y[row];
+		float distance = dx * dx + dy * dy;
+		if (distance < closest_distance)
+		{
+			closest_distance = distance;
+			closest = i;
+		}
+	}
+	return closest;
+}
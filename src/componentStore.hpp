@@ -0,0 +1,126 @@
+#pragma once
+
+#include <vector>
+
+class Fighter;
+class Attack;
+struct FighterDefinition;
+
+// Components every attached fighter has, one dense array per field. Row i is the fighter
+// given slot i by ComponentStore::add_fighter()
+struct BodyRows
+{
+	// Physics body, stepped by ComponentStore::push() and fall()
+	std::vector<float> force_x; // in Newtons
+	std::vector<float> force_y;
+	std::vector<float> mass; // in kg
+	std::vector<float> friction;
+	std::vector<float> velocity_y;
+	std::vector<int> health;
+	std::vector<int> block_tank_ms; // whole ms, the tick time added to it is truncated
+
+	int size() const { return (int)mass.size(); }
+	void resize(int count);
+};
+
+// Yam's heal and dash, only the fighters playing Yam have a row. Every timer counts down to 0
+struct YamRows
+{
+	std::vector<unsigned char> is_healing; // asked for, lands next tick unless on cooldown
+	std::vector<float> heal_cooldown_ms;
+	std::vector<float> heal_animation_ms;
+	std::vector<unsigned char> start_dashing; // asked for, starts next tick unless on cooldown
+	std::vector<float> dash_cooldown_ms;
+	std::vector<float> dash_timer_ms; // left of the dash under way
+
+	int size() const { return (int)heal_cooldown_ms.size(); }
+	void resize(int count);
+};
+
+// Where a Yam dash is at after ComponentStore::dash()
+enum DashStep
+{
+	NOT_DASHING,
+	DASHING,
+	DASH_ENDED // moved for the last time this tick
+};
+
+// Fighter fields the world's systems read every tick, one dense array per field. Row i
+// is the i-th fighter gathered, so a system that only needs positions walks two float
+// arrays instead of hopping between fighters several hundred bytes apart
+struct FighterRows
+{
+	std::vector<Fighter*> fighter;
+	std::vector<unsigned> id;
+	// Transform, the position is the center of the sprite
+	std::vector<float> x;
+	std::vector<float> y;
+	// Hurtbox, top left corner and size
+	std::vector<float> box_x;
+	std::vector<float> box_y;
+	std::vector<float> box_w;
+	std::vector<float> box_h;
+	std::vector<unsigned char> alive;
+	std::vector<unsigned char> blocking;
+
+	int size() const { return (int)fighter.size(); }
+	void resize(int count);
+};
+
+// Damage boxes of the attacks in play, row i is the i-th attack gathered
+struct HitboxRows
+{
+	std::vector<Attack*> attack;
+	std::vector<int> owner; // fighter id, attacks never hit their own fighter
+	std::vector<float> x;
+	std::vector<float> y;
+	std::vector<float> w;
+	std::vector<float> h;
+
+	int size() const { return (int)attack.size(); }
+	void resize(int count);
+};
+
+// Component arrays of the fighters and attacks in play. bodies and yams are owned here:
+// Fighter::attach() takes a row in them, which the fighter steps with the systems below
+// from its own update. Fighters tick one after the other, an AI deciding from the players
+// it sees after their whole tick, so the systems step one row at a time rather than loop
+// over the arrays. fighters and hitboxes are structure of arrays copies of the entities,
+// refreshed by the world before the systems that loop over them
+class ComponentStore
+{
+public:
+	// Row in bodies for a new fighter, freed rows are reused
+	int add_fighter();
+	void remove_fighter(int slot);
+	// Row in yams for a fighter playing Yam, freed rows are reused
+	int add_yam();
+	void remove_yam(int row);
+
+	// Speed the body's force adds this tick, friction then wears the force down
+	float push(int slot);
+	// Distance the body falls over ms, gravity then speeds it up to terminal velocity
+	float fall(int slot, float ms, const FighterDefinition& def);
+	// Counts down the heal timers of a yams row, true if a heal asked for lands this tick
+	bool heal(int row, float ms, const FighterDefinition& def);
+	// Starts a dash asked for and counts down the dash timers of a yams row
+	DashStep dash(int row, float ms, const FighterDefinition& def);
+
+	void gather_fighters(const std::vector<Fighter*>& fighters);
+	void gather_hitboxes(const std::vector<Attack*>& attacks);
+
+	// Appends to hits the rows of the hitboxes overlapping fighter row, skipping the
+	// fighter's own attacks and everything while it blocks
+	void find_hits(int fighter, std::vector<int>& hits) const;
+	// Closest other fighter still standing to fighter row, -1 if there is none
+	int find_closest(int fighter) const;
+
+	FighterRows fighters;
+	HitboxRows hitboxes;
+	BodyRows bodies;
+	YamRows yams;
+
+private:
+	std::vector<int> m_free_bodies;
+	std::vector<int> m_free_yams;
+};
@@ -0,0 +1,142 @@
+// Header
+#include "dynamicResolution.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	// Frames between two changes, gives the smoothed times a chance to settle
+	const int ADJUST_INTERVAL = 20;
+	// Scales are rounded to this step so only a few target sizes ever get allocated
+	const float SCALE_STEP = 0.05f;
+	const float SMOOTHING = 0.1f;
+	// One-off hitches (shader compiles, the first frame) would dominate the average for seconds
+	const float MAX_SAMPLE_MS = 100.f;
+	// Shrink above this fraction of the target frame time, grow below the other one
+	const float SHRINK_THRESHOLD = 0.9f;
+	const float GROW_THRESHOLD = 0.6f;
+}
+
+DynamicResolution::DynamicResolution() :
+	m_enabled(false),
+	m_min_scale(1.f),
+	m_max_scale(1.f),
+	m_target_ms(1000.f / 60.f),
+	m_scale(1.f),
+	m_issued(0),
+	m_read(0),
+	m_timing(false),
+	m_gpu_ms(0.f),
+	m_cpu_ms(0.f),
+	m_frames_since_change(0)
+{
+}
+
+bool DynamicResolution::init(float min_scale, float max_scale, float target_frame_ms)
+{
+	gl_flush_errors();
+	glGenQueries(QUERY_COUNT, m_queries);
+	if (gl_has_errors())
+	{
+		fprintf(stderr, "Failed to create timer queries, dynamic resolution is off\n");
+		return false;
+	}
+
+	m_min_scale = min_scale;
+	m_max_scale = max_scale;
+	m_target_ms = target_frame_ms;
+	m_scale = max_scale;
+	m_issued = 0;
+	m_read = 0;
+	m_gpu_ms = 0.f;
+	m_cpu_ms = 0.f;
+	m_frames_since_change = 0;
+	m_enabled = true;
+	return true;
+}
+
+void DynamicResolution::destroy()
+{
+	if (!m_enabled)
+		return;
+
+	glDeleteQueries(QUERY_COUNT, m_queries);
+	m_enabled = false;
+	m_scale = 1.f;
+}
+
+void DynamicResolution::begin_frame()
+{
+	if (!m_enabled)
+		return;
+
+	read_queries();
+
+	// Every query still in flight, skip timing this frame rather than wait on the GPU
+	m_timing = m_issued - m_read < QUERY_COUNT;
+	if (m_timing)
+		glBeginQuery(GL_TIME_ELAPSED, m_queries[m_issued % QUERY_COUNT]);
+}
+
+void DynamicResolution::end_frame()
+{
+	if (!m_timing)
+		return;
+
+	glEndQuery(GL_TIME_ELAPSED);
+	m_issued++;
+	m_timing = false;
+}
+
+void DynamicResolution::read_queries()
+{
+	while (m_read < m_issued)
+	{
+		GLuint query = m_queries[m_read % QUERY_COUNT];
+		GLint available = 0;
+		glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			break;
+
+		GLuint64 ns = 0;
+		glGetQueryObjectui64v(query, GL_QUERY_RESULT, &ns);
+		float ms = std::min((float)(ns / 1e6), MAX_SAMPLE_MS);
+		m_gpu_ms = (m_gpu_ms > 0.f) ? m_gpu_ms + (ms - m_gpu_ms) * SMOOTHING : ms;
+		m_read++;
+	}
+}
+
+void DynamicResolution::update(float cpu_ms)
+{
+	if (!m_enabled)
+		return;
+
+	m_cpu_ms = (m_cpu_ms > 0.f) ? m_cpu_ms + (cpu_ms - m_cpu_ms) * SMOOTHING : cpu_ms;
+
+	if (m_gpu_ms <= 0.f || ++m_frames_since_change < ADJUST_INTERVAL)
+		return;
+
+	// Software renderers rasterize on the CPU when the frame is flushed, so the CPU
+	// side can be the part that depends on resolution
+	float frame_ms = std::max(m_gpu_ms, m_cpu_ms);
+
+	float scale = m_scale;
+	if (frame_ms > m_target_ms * SHRINK_THRESHOLD)
+	{
+		// Fill cost grows with the square of the scale, aim a bit under the threshold
+		scale *= std::sqrt(m_target_ms * SHRINK_THRESHOLD * 0.9f / frame_ms);
+		scale = std::floor(scale / SCALE_STEP) * SCALE_STEP;
+	}
+	else if (frame_ms < m_target_ms * GROW_THRESHOLD)
+	{
+		scale = std::round(scale / SCALE_STEP) * SCALE_STEP + SCALE_STEP;
+	}
+	scale = std::min(m_max_scale, std::max(m_min_scale, scale));
+
+	if (std::fabs(scale - m_scale) > SCALE_STEP * 0.5f)
+	{
+		m_scale = scale;
+		m_frames_since_change = 0;
+	}
+}
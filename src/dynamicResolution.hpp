@@ -0,0 +1,46 @@
+#pragma once
+#include "common.hpp"
+
+// Picks the internal render resolution from measured frame times. The scene is drawn
+// smaller and upscaled by the last post pass when the GPU cannot hold the target frame
+// time, trading sharpness for frame rate on slow GPUs and software renderers.
+class DynamicResolution {
+public:
+	static const int QUERY_COUNT = 4; // frames the GPU may lag behind before we stop timing
+
+	DynamicResolution();
+
+	bool init(float min_scale, float max_scale, float target_frame_ms);
+	void destroy();
+
+	// Bracket the GPU work of a frame, nothing can be timed with GL_TIME_ELAPSED in between
+	void begin_frame();
+	void end_frame();
+
+	// Adjusts the scale from the latest measurements, cpu_ms is the time the CPU
+	// spent building the frame
+	void update(float cpu_ms);
+
+	bool is_enabled() const { return m_enabled; }
+	float get_scale() const { return m_scale; }
+	float get_gpu_ms() const { return m_gpu_ms; }
+	float get_cpu_ms() const { return m_cpu_ms; }
+
+private:
+	void read_queries();
+
+	bool m_enabled;
+	float m_min_scale;
+	float m_max_scale;
+	float m_target_ms;
+	float m_scale;
+
+	GLuint m_queries[QUERY_COUNT];
+	int m_issued; // queries begun so far
+	int m_read; // queries whose result has been read
+	bool m_timing; // a query is open this frame
+
+	float m_gpu_ms; // smoothed, 0 until the first result comes back
+	float m_cpu_ms; // smoothed
+	int m_frames_since_change;
+};
@@ -17,6 +17,7 @@ public:
 	bool init();
 	void update(float ms);
 	void draw(const mat3 &projection) override;
+	void submit(RenderQueue &queue) override;
 	void fire_emoji(bool direction);
 	void set_fighter_pos(vec2 pos);
 	bool is_circling();
@@ -1,5 +1,7 @@
 // Header
 #include "fighter.hpp"
+#include "renderQueue.hpp"
+#include "allocTracker.hpp"
 
 #define _USE_MATH_DEFINES
 
@@ -13,11 +15,13 @@ Texture Fighter::f_texture;
 Fighter::Fighter(unsigned int id) : m_id(id) {
 }
 
-bool Fighter::init(int init_position, std::string name, FighterCharacter fc)
+bool Fighter::init(int init_position, std::string name, FighterCharacter fc, ComponentStore& components)
 {	
 	// Load shared texture
 	m_fc = fc;
+	m_def = &get_fighter_definition(fc);
 	set_sprite(ORIGINAL);
+	m_sprite = ORIGINAL;
 
 	// The position corresponds to the center of the texture
 	float wr = f_texture.width * 0.5f;
@@ -45,6 +49,7 @@ bool Fighter::init(int init_position, std::string name, FighterCharacter fc)
 	glBufferData(GL_ARRAY_BUFFER, sizeof(TexturedVertex) * 4, vertices, GL_STATIC_DRAW);
 
 	// Index Buffer creation
+	gl_bind_vertex_array(0);
 	glGenBuffers(1, &mesh.ibo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * 6, indices, GL_STATIC_DRAW);
@@ -60,7 +65,19 @@ bool Fighter::init(int init_position, std::string name, FighterCharacter fc)
 	if (!effect.load_from_file(shader_path("fighter.vs.glsl"), shader_path("fighter.fs.glsl")))
 		return false;
 
-	m_rng = std::default_random_engine(std::random_device()());
+	// Input data location as in the vertex buffer, stored in the vertex array
+	glBindVertexArray(mesh.vao);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
+	GLint in_texcoord_loc = glGetAttribLocation(effect.program, "in_texcoord");
+	glEnableVertexAttribArray(in_position_loc);
+	glEnableVertexAttribArray(in_texcoord_loc);
+	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void *)0);
+	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void *)sizeof(vec3));
+	glBindVertexArray(0);
+
+	m_rng = std::default_random_engine(next_random_seed());
 	float rng = m_dist(m_rng);
 
 	// Setting initial values, scale is negative to make it face the opposite way
@@ -70,26 +87,20 @@ bool Fighter::init(int init_position, std::string name, FighterCharacter fc)
 	m_is_idle = true;
 	m_is_hurt = false;
 	m_is_blocking = false;
-	m_blocking_tank = FULL_BLOCK_TANK;
+
+	// A fighter set up again starts over with fresh components
+	detach();
+	attach(components);
+	block_tank() = m_def->block_tank_ms;
 
 	m_scale.x = FIGHTER_SPRITE_SCALE;
 	m_scale.y = FIGHTER_SPRITE_SCALE;
-	//m_sprite_appearance_size = { f_texture.width / 2.0f, f_texture.height / 1.4f }; // works for original scale and for 1.5f
-	m_sprite_appearance_size = { f_texture.width / 2.1f, f_texture.height / 1.42f };
 	m_rotation = 0.f;
-
-	// initialized in fighterInfo.cpp
-	MAX_HEALTH = fighterMap[m_fc].health;
-	m_speed = fighterMap[m_fc].speed * 1.5f;
-	m_strength = fighterMap[m_fc].strength;
-	m_mass = 1.f;
+	apply_definition();
 	
-	m_health = MAX_HEALTH;
+	health() = MAX_HEALTH;
 	m_lives = STARTING_LIVES;
-	m_velocity_y = 0.0;
 	m_name = name;
-	m_force = { 0.f, 0.f };
-	m_friction = 1.f;
 	
   	reset_potato_flags();
  	reset_broccoli_flags();
@@ -125,8 +136,22 @@ bool Fighter::init(int init_position, std::string name, FighterCharacter fc)
 
 // Call if init() was successful
 // Releases all graphics resources
+void Fighter::apply_definition()
+{
+	// loaded from data/fighters/fighters.txt
+	const Texture& original = *m_def->sprites[ORIGINAL];
+	//m_sprite_appearance_size = { original.width / 2.0f, original.height / 1.4f }; // works for original scale and for 1.5f
+	m_sprite_appearance_size = { original.width / m_def->hurtbox_divisor_x, original.height / m_def->hurtbox_divisor_y };
+	MAX_HEALTH = m_def->health;
+	m_speed = m_def->speed * 1.5f;
+	m_strength = m_def->strength;
+	if (health() > MAX_HEALTH)
+		health() = MAX_HEALTH;
+}
+
 void Fighter::destroy()
 {
+	detach();
 	clear_emojis();
 	glDeleteBuffers(1, &mesh.vbo);
 	glDeleteBuffers(1, &mesh.ibo);
@@ -138,8 +163,30 @@ void Fighter::destroy()
 	effect.release();
 }
 
+void Fighter::attach(ComponentStore& components)
+{
+	if (m_slot != -1)
+		return;
+	m_components = &components;
+	m_slot = components.add_fighter();
+	if (m_fc == YAM)
+		m_yam_row = components.add_yam();
+}
+
+void Fighter::detach()
+{
+	if (m_slot == -1)
+		return;
+	m_components->remove_fighter(m_slot);
+	m_slot = -1;
+	if (m_yam_row != -1)
+		m_components->remove_yam(m_yam_row);
+	m_yam_row = -1;
+}
+
 Attack * Fighter::update(float ms, QuadTree* platform_tree)
 {
+	ALLOC_SCOPE("Fighter::update");
 	vec2 oldPos = m_position;
 	Attack * attack = NULL;
 
@@ -148,10 +195,11 @@ Attack * Fighter::update(float ms, QuadTree* platform_tree)
 	die();	
 	check_respawn(ms);
 
+	input_buffer_update(ms);
+
 	if(m_is_alive){
 		crouch_update();
-		float added_speed = m_force.x / m_mass;
-		apply_friction();
+		float added_speed = m_components->push(m_slot);
 		x_position_update(added_speed, ms, platform_tree);
 
 		// GENERAL
@@ -193,6 +241,8 @@ Attack * Fighter::update(float ms, QuadTree* platform_tree)
 			m_rotation = M_PI / 2;
 	}
 	
+	release_buffered_inputs();
+
 	y_position_update(ms);
 	platform_collision(platform_tree, oldPos);
 	//return null if not attacking, or the collision object if attacking
@@ -201,6 +251,15 @@ Attack * Fighter::update(float ms, QuadTree* platform_tree)
 
 void Fighter::draw(const mat3 &projection)
 {
+	FighterFrame frame;
+	capture(frame);
+	frame.draw(projection);
+}
+
+void Fighter::capture(FighterFrame &frame)
+{
+	ALLOC_SCOPE("Fighter::capture");
+
 	// Transformation code, see Rendering and Transformation in the template specification for more info
 	// Incrementally updates transformation matrix, thus ORDER IS IMPORTANT
 	transform_begin();
@@ -209,13 +268,73 @@ void Fighter::draw(const mat3 &projection)
 	transform_scale(m_scale);
 	transform_end();
 
+	frame.mesh = mesh;
+	frame.effect = effect;
+	frame.transform = transform;
+	frame.texture = m_def->sprites[m_sprite]->id;
+	frame.is_hurt = m_is_hurt;
+	frame.is_blocking = m_is_blocking;
+	frame.blocking_tank = (float)block_tank();
+	frame.heal_animation_ms = get_heal_animation();
+
+	int sWidth = m_nameplate->get_width_of_string(m_name);
+	m_nameplate->setPosition({ m_position.x - sWidth*.45f, m_position.y - 70.0f });
+}
+
+void Fighter::animate(float ms)
+{
+	if (!get_alive())
+	{
+		m_animator.play(DEATH);
+		m_sprite = m_animator.get_sprite();
+		return;
+	}
+	if (is_paused())
+		return;
+
+	// Poses by priority, each one starts the animation of its first sprite
+	SpriteType pose;
+	if (m_shows_tired_out && is_tired_out())
+	{
+		set_power_punch(false);
+		pose = TIRED_1;
+	}
+	else if (is_uppercutting())
+		pose = UPPERCUT;
+	else if (is_punching())
+		pose = is_crouching() ? CROUCH_PUNCH : PUNCH;
+	else if (is_crouching())
+		pose = CROUCH;
+	else if (is_holding_power_punch() || (m_fc == POTATO && m_potato_is_holding_fries) || (m_fc == BROCCOLI && m_broccoli_is_holding_cauliflowers))
+		pose = CHARGING;
+	else if (is_power_punching())
+		pose = POWER_PUNCH;
+	else
+		pose = IDLE;
+
+	m_animator.play(pose);
+	m_animator.advance(ms);
+	m_sprite = m_animator.get_sprite();
+
+	// Both attacks last as long as their animation
+	if (m_animator.is_finished())
+	{
+		if (pose == UPPERCUT)
+			set_uppercut(false);
+		else if (pose == POWER_PUNCH)
+			set_power_punch(false);
+	}
+}
+
+void FighterFrame::draw(const mat3 &projection)
+{
 	// Setting shaders
-	glUseProgram(effect.program);
+	gl_use_program(effect.program);
 
 	// Enabling alpha channel for textures
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDisable(GL_DEPTH_TEST);
+	gl_enable(GL_BLEND);
+	gl_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	gl_disable(GL_DEPTH_TEST);
 
 	// Getting uniform locations for glUniform* calls
 	GLint transform_uloc = glGetUniformLocation(effect.program, "transform");
@@ -227,98 +346,31 @@ void Fighter::draw(const mat3 &projection)
 	GLint blocking_tank_uloc = glGetUniformLocation(effect.program, "blocking_tank");
 	GLuint time_uloc = glGetUniformLocation(effect.program, "time");
 
-	// Setting vertices and indices
-	glBindVertexArray(mesh.vao);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
-
-	// Input data location as in the vertex buffer
-	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
-	GLint in_texcoord_loc = glGetAttribLocation(effect.program, "in_texcoord");
-	glEnableVertexAttribArray(in_position_loc);
-	glEnableVertexAttribArray(in_texcoord_loc);
-	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void *)0);
-	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void *)sizeof(vec3));
+	// Setting vertices and indices, attributes are already stored in the vertex array
+	gl_bind_vertex_array(mesh.vao);
 
 	// Enabling and binding texture to slot 0
-	glActiveTexture(GL_TEXTURE0);
-
-	if (get_alive())
-	{
-		if (is_paused()) {
-
-		}
-
-		else if (is_uppercutting())
-		{
-			m_punch_counter++;
-			set_sprite(UPPERCUT);
-
-			if (m_punch_counter > 30)
-			{
-				m_punch_counter = 0;
-				set_uppercut(false);
-			}
-		}
-
-		else if (is_punching()) {
-			if (!is_crouching()) { set_sprite(PUNCH); }
-			else if (is_crouching()) { set_sprite(CROUCH_PUNCH); }
-		}
-
-		else if (!is_punching() && is_crouching()) { set_sprite(CROUCH); }
-
-		else if (is_holding_power_punch() || (m_fc == POTATO && m_potato_is_holding_fries) || (m_fc == BROCCOLI && m_broccoli_is_holding_cauliflowers)) { 
-			set_sprite(CHARGING); 
-		}
-
-		else if (is_power_punching())
-		{
-			m_punch_counter++;
-			set_sprite(POWER_PUNCH);
-
-			if (m_punch_counter > 20)
-			{
-				m_punch_counter = 0;
-				set_power_punch(false);
-			}
-		}
-		else if (!is_punching())
-		{
-			if (get_alive() && !is_crouching())
-			{
-				m_anim_counter++;
-				if (m_anim_counter < 25) { set_sprite(IDLE); }
-				else if (m_anim_counter > 25 && m_anim_counter < 50) { set_sprite(ORIGINAL); }
-				else if (m_anim_counter >= 50)
-					m_anim_counter = 0;
-			}
-		}
-	}
-	else if (!get_alive())
-	{
-		set_sprite(DEATH);
-	}
-
-
-	glBindTexture(GL_TEXTURE_2D, f_texture.id);
+	gl_active_texture(GL_TEXTURE0);
+	gl_bind_texture(GL_TEXTURE_2D, texture);
 
 	// Setting uniform values to the currently bound program
 	glUniformMatrix3fv(transform_uloc, 1, GL_FALSE, (float *)&transform);
 	float color[] = {1.f, 1.f, 1.f};
 	glUniform3fv(color_uloc, 1, color);
 	glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float *)&projection);
-	glUniform1i(is_hurt_uloc, m_is_hurt);
-	glUniform1i(is_blocking_uloc, m_is_blocking);
-	glUniform1f(blocking_tank_uloc, (float)  m_blocking_tank);
+	glUniform1i(is_hurt_uloc, is_hurt);
+	glUniform1i(is_blocking_uloc, is_blocking);
+	glUniform1f(blocking_tank_uloc, blocking_tank);
 	glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
-	glUniform1f(heal_animation_uloc, m_yam_heal_animation_ms);
+	glUniform1f(heal_animation_uloc, heal_animation_ms);
 
 	// Drawing!
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
-	
-	int sWidth = m_nameplate->get_width_of_string(m_name);
-	m_nameplate->setPosition({ m_position.x - sWidth*.45f, m_position.y - 70.0f });
+	gl_draw_elements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+}
+
+void FighterFrame::submit(RenderQueue &queue)
+{
+	queue.submit_custom(LAYER_FIGHTERS, this);
 }
 
 
@@ -343,6 +395,16 @@ void Fighter::set_position(vec2 position)
 	m_position = position;
 }
 
+void Fighter::set_spawn_position(vec2 position)
+{
+	m_position = position;
+	m_facing_front = position.x < 600.f;
+	m_scale.x = m_facing_front ? std::fabs(m_scale.x) : -std::fabs(m_scale.x);
+	m_initial_pos = m_position;
+	m_initial_dir = m_facing_front;
+	m_initial_scale_x = m_scale.x;
+}
+
 void Fighter::move(vec2 off)
 {
 	m_position.x += off.x;
@@ -363,6 +425,174 @@ BoundingBox Fighter::get_bounding_box() const
 
 // set fighter's movements
 void Fighter::set_movement(int mov)
+{
+	if (m_input_buffer.get_window_ms() <= 0.f)
+	{
+		apply_movement(mov);
+		return;
+	}
+
+	if (feed_motion(mov))
+		return;
+
+	switch (mov)
+	{
+	case START_JUMPING:
+	case PUNCHING:
+	case ABILITY_1:
+	case ABILITY_2:
+		if (!can_act(mov))
+			m_input_buffer.push(mov, m_input_time_ms);
+		break;
+	case STOP_PUNCHING:
+		m_input_buffer.release(PUNCHING);
+		break;
+	case HOLDING_POWER_PUNCH:
+		// The press turned into a charge, it is not a punch anymore
+		for (int i = 0; i < m_input_buffer.size(); i++)
+		{
+			if (m_input_buffer.at(i).movement == PUNCHING)
+				m_input_buffer.remove(i);
+		}
+		break;
+	case STOP_ABILITIES:
+		m_input_buffer.release(ABILITY_1);
+		m_input_buffer.release(ABILITY_2);
+		break;
+	}
+	apply_movement(mov);
+}
+
+void Fighter::set_input_buffer_ms(float window_ms)
+{
+	m_input_buffer.set_window_ms(window_ms);
+	m_input_buffer.clear();
+	m_motion_state = MotionRecognizer::START;
+}
+
+// Whether a press would take effect right now, otherwise it is buffered
+bool Fighter::can_act(int mov) const
+{
+	if (!m_is_alive || m_is_blocking || m_tired_out)
+		return false;
+
+	switch (mov)
+	{
+	case START_JUMPING:
+		return !m_is_jumping && (m_fc != BROCCOLI || m_broccoli_jump_left > 0);
+	case PUNCHING:
+		return !m_punch_on_cooldown;
+	case ABILITY_1:
+		if (m_fc == POTATO)
+			return m_potato_bomb_planted || !m_potato_bomb_on_cooldown;
+		if (m_fc == BROCCOLI)
+			return !m_broccoli_uppercut_on_cooldown;
+		if (m_fc == YAM)
+			return yams().dash_cooldown_ms[m_yam_row] <= 0.f && yams().dash_timer_ms[m_yam_row] <= 0.f;
+		if (m_fc == EGGPLANT)
+			return m_eggplant_spawn_cooldown <= 0.f && (int)m_eggplant_emoji_count < m_def->max_emojis;
+		break;
+	case ABILITY_2:
+		if (m_fc == POTATO)
+			return !m_potato_fries_on_cooldown;
+		if (m_fc == BROCCOLI)
+			return !m_broccoli_cauliflowers_on_cooldown;
+		if (m_fc == YAM)
+			return yams().heal_cooldown_ms[m_yam_row] <= 0.f;
+		if (m_fc == EGGPLANT)
+			return m_eggplant_emoji_count > 0;
+		break;
+	}
+	return true;
+}
+
+// Steps the special move automaton, true when a motion ending on a button completed
+// and took the place of the button's own action
+bool Fighter::feed_motion(int mov)
+{
+	MotionInput input;
+	switch (mov)
+	{
+	case MOVING_FORWARD:
+		input = m_facing_front ? MOTION_FORWARD : MOTION_BACK;
+		break;
+	case MOVING_BACKWARD:
+		input = m_facing_front ? MOTION_BACK : MOTION_FORWARD;
+		break;
+	case START_JUMPING:
+		input = MOTION_UP;
+		break;
+	case CROUCHING:
+		input = MOTION_DOWN;
+		break;
+	case PUNCHING:
+		input = MOTION_PUNCH;
+		break;
+	case ABILITY_1:
+		input = MOTION_ABILITY_1;
+		break;
+	case ABILITY_2:
+		input = MOTION_ABILITY_2;
+		break;
+	case BLOCKING:
+		input = MOTION_BLOCK;
+		break;
+	default:
+		return false;
+	}
+
+	if (m_input_time_ms - m_last_motion_ms > MOTION_STEP_MS)
+		m_motion_state = MotionRecognizer::START;
+	m_last_motion_ms = m_input_time_ms;
+
+	const MotionRecognizer& recognizer = get_motion_recognizer(m_fc);
+	m_motion_state = recognizer.step(m_motion_state, input);
+	int match = recognizer.get_match(m_motion_state);
+	if (match < 0)
+		return false;
+
+	// A tap of the special's movement, through the buffer so a cooldown that is
+	// about to end does not swallow it
+	m_motion_state = MotionRecognizer::START;
+	m_input_buffer.push(get_special_moves(m_fc)[match].movement, m_input_time_ms, true);
+	return input >= MOTION_PUNCH;
+}
+
+// Acts on the buffered presses the fighter is ready for, before this update handles
+// the movement flags
+void Fighter::input_buffer_update(float ms)
+{
+	m_input_time_ms += ms;
+	if (m_input_buffer.get_window_ms() <= 0.f)
+		return;
+
+	m_input_buffer.expire(m_input_time_ms);
+	for (int i = 0; i < m_input_buffer.size(); i++)
+	{
+		BufferedInput& input = m_input_buffer.at(i);
+		if (input.movement < 0 || !can_act(input.movement))
+			continue;
+		apply_movement(input.movement);
+		if (input.released)
+			m_pending_releases[m_pending_release_count++] = input.movement;
+		m_input_buffer.remove(i);
+	}
+}
+
+// Presses whose key already went up last a single update, like a tap
+void Fighter::release_buffered_inputs()
+{
+	for (int i = 0; i < m_pending_release_count; i++)
+	{
+		if (m_pending_releases[i] == PUNCHING)
+			apply_movement(STOP_PUNCHING);
+		else if (m_pending_releases[i] == ABILITY_1 || m_pending_releases[i] == ABILITY_2)
+			apply_movement(STOP_ABILITIES);
+	}
+	m_pending_release_count = 0;
+}
+
+void Fighter::apply_movement(int mov)
 {
 	switch (mov)
 	{
@@ -400,7 +630,7 @@ void Fighter::set_movement(int mov)
 			m_is_idle = false;
 		}
 		else if (m_fc == YAM && !m_is_blocking && !m_tired_out) {
-			m_yam_start_dashing = true;
+			yams().start_dashing[m_yam_row] = true;
 			m_is_idle = false;
 		}
 		else if (m_fc == EGGPLANT && !m_is_blocking && !m_tired_out) {
@@ -417,7 +647,7 @@ void Fighter::set_movement(int mov)
 			m_is_idle = false;
 		}
 		else if (m_fc == YAM && !m_is_blocking && !m_tired_out) {
-			m_yam_is_healing = true;
+			yams().is_healing[m_yam_row] = true;
 			m_is_idle = false;
 		}
 		else if (m_fc == EGGPLANT && !m_is_blocking && !m_tired_out) {
@@ -492,7 +722,7 @@ void Fighter::set_movement(int mov)
 		break;
 	case BLOCKING:
 		//CANNOT BLOCK UNTIL BLOCKING TANK IS ATLEAST 1000 (1second of recharge)
-		if (!m_is_punching && m_blocking_tank >= 1000)
+		if (!m_is_punching && block_tank() >= 1000)
 			m_is_blocking = true;
 		break;
 	case STOP_BLOCKING:
@@ -513,47 +743,48 @@ void Fighter::set_hurt(bool hurt) {
 }
 
 void Fighter::apply_damage(DamageEffect * damage_effect) {
-	if (damage_effect->m_damage <= m_health) {
-		m_health -= damage_effect->m_damage;
+	if (damage_effect->m_damage <= health()) {
+		health() -= damage_effect->m_damage;
 		if (damage_effect->m_bounding_box.xpos + (damage_effect->m_bounding_box.width / 2) > m_position.x) {
 			if (damage_effect->m_vert_force > 0) {
-				m_force.x -= 0.3f * damage_effect->m_damage;
-				m_velocity_y = -damage_effect->m_vert_force;
+				bodies().force_x[m_slot] -= 0.3f * damage_effect->m_damage;
+				bodies().velocity_y[m_slot] = -damage_effect->m_vert_force;
 			} else {
-				m_force.x -= 1.f * damage_effect->m_damage;
+				bodies().force_x[m_slot] -= 1.f * damage_effect->m_damage;
 			}
 		}
 		else {
 			if (damage_effect->m_vert_force > 0) {
-				m_force.x += 0.3f * damage_effect->m_damage;
-				m_velocity_y = -damage_effect->m_vert_force;
+				bodies().force_x[m_slot] += 0.3f * damage_effect->m_damage;
+				bodies().velocity_y[m_slot] = -damage_effect->m_vert_force;
 			}
 			else {
-				m_force.x += 1.f * damage_effect->m_damage;
+				bodies().force_x[m_slot] += 1.f * damage_effect->m_damage;
 			}
 		}
 	} else {
-		m_health = 0;
+		health() = 0;
 	}
 }
 
 void Fighter::apply_damage(int effect) { // for stage effects
-	if (effect <= m_health) { m_health -= effect; }
-	else { m_health = 0; }
+	if (effect <= health()) { health() -= effect; }
+	else { health() = 0; }
 }
 
 void Fighter::set_blocking(bool blocking) {
 	m_is_blocking = blocking;
 }
 
+// Menus read the fighters they keep around without setting them up, these have no health
 int Fighter::get_health() const
 {
-	return m_health;
+	return m_slot != -1 ? bodies().health[m_slot] : 0;
 }
 
 int Fighter::get_block_tank() const
 {
-	return m_blocking_tank;
+	return m_slot != -1 ? bodies().block_tank_ms[m_slot] : 0;
 }
 
 int Fighter::get_lives() const
@@ -574,20 +805,12 @@ void Fighter::start_jumping()
 		Mix_PlayChannel(1, m_jump_audio, 0);
 		m_is_jumping = true;
 		m_is_idle = false;
-		m_velocity_y = -INITIAL_JUMP_VELOCITY;
+		bodies().velocity_y[m_slot] = -m_def->jump_velocity;
 		if (m_fc == BROCCOLI)
 			m_broccoli_jump_left--;
 	}
 }
 
-void Fighter::apply_friction() {
-	if (m_force.x > 0.f) {
-		m_force.x = std::max(m_force.x - m_friction, 0.f);
-	} else if (m_force.x < 0.f) {
-		m_force.x = std::min(m_force.x + m_friction, 0.f);
-	}
-}
-
 void Fighter::x_position_update(float added_speed, float ms, QuadTree* platform_tree) {
 
 	//!!! need to include this before merge
@@ -649,7 +872,7 @@ void Fighter::crouch_update() {
 }
 
 void Fighter::die() {
-	if (m_health <= 0 && m_is_alive || (m_position.y > (800 + 100) && m_is_alive))
+	if (health() <= 0 && m_is_alive || (m_position.y > (800 + 100) && m_is_alive))
 	{
 		m_is_alive = false;
 		m_lives--;
@@ -671,7 +894,7 @@ void Fighter::die() {
 
 		if (m_lives > 0)
 		{
-			m_respawn_timer = RESPAWN_TIME;
+			m_respawn_timer = m_def->respawn_ms;
 			m_respawn_flag = true;
 		}
 	}
@@ -693,21 +916,21 @@ void Fighter::check_respawn(float ms) {
 			m_respawn_timer = 0;
 			m_is_alive = true;
 			m_is_hurt = false;
-			m_health = MAX_HEALTH;
+			health() = MAX_HEALTH;
 			m_rotation = 0;
 			m_position = m_initial_pos;
 			m_facing_front = m_initial_dir;
 			m_scale.x = m_initial_scale_x;
 			m_crouch_state = NOT_CROUCHING;
-			m_blocking_tank = FULL_BLOCK_TANK;
+			block_tank() = m_def->block_tank_ms;
 			m_is_blocking = true;
 			m_tired_out = false;
 			m_is_jumping = false;
 			m_is_punching = false;
 			m_is_holding_power_punch = false;
 			m_is_power_punching = false;
-			m_force.x = 0;
-			m_force.y = 0;
+			bodies().force_x[m_slot] = 0.f;
+			bodies().force_y[m_slot] = 0.f;
 
 			if (m_fc == POTATO) reset_potato_flags();
 			if (m_fc == BROCCOLI) reset_broccoli_flags();
@@ -780,7 +1003,7 @@ bool Fighter::is_tired_out() const {
 }
 
 int Fighter::get_blocking_tank() const{
-	return m_blocking_tank;
+	return get_block_tank();
 }
 
 int Fighter::get_crouch_state() {
@@ -842,7 +1065,7 @@ bool Fighter::is_uppercutting() const {
 //void Fighter::reset(int init_position)
 void Fighter::reset()
 {
-	m_health = MAX_HEALTH;
+	health() = MAX_HEALTH;
 	m_lives = STARTING_LIVES;
 	m_is_alive = true;
 	m_rotation = 0;
@@ -852,9 +1075,12 @@ void Fighter::reset()
 	if (m_fc == BROCCOLI) reset_broccoli_flags();
 	m_is_holding_power_punch = false;
 	m_is_power_punching = false;
-	m_velocity_y = 0.0;
+	bodies().velocity_y[m_slot] = 0.f;
 	m_moving_forward = false;
 	m_moving_backward = false;
+	m_input_buffer.clear();
+	m_motion_state = MotionRecognizer::START;
+	m_pending_release_count = 0;
 	m_position = m_initial_pos;
 	m_facing_front = m_initial_dir;
 	m_scale.x = m_initial_scale_x;
@@ -864,13 +1090,7 @@ void Fighter::reset()
 		m_position.y += 25.f;
 	}
 
-	//yam reset
-	m_yam_is_healing = false;
-	m_yam_heal_cooldown_ms = 0;
-	m_yam_heal_animation_ms = 0.0;
-	m_yam_start_dashing = false;
-	m_yam_dash_cooldown_ms = 0.0;
-	m_yam_dash_timer_ms = 0.0;
+	reset_yam_flags();
 
 	//eggplant reset
 	m_eggplant_spawn_emoji = false;
@@ -881,7 +1101,7 @@ void Fighter::reset()
 
 Punch * Fighter::punch() {
 	//create the bounding box based on fighter position
-	float sizeMultiplier = 1.75;
+	float sizeMultiplier = m_def->punch_reach;
 	BoundingBox b = get_bounding_box();
 	Punch* punch;
 	if (get_facing_front()) {
@@ -901,7 +1121,7 @@ Punch * Fighter::punch() {
 
 Punch * Fighter::powerPunch() {
 	//create the bounding box based on fighter position
-	float sizeMultiplier = 1.75;
+	float sizeMultiplier = m_def->punch_reach;
 	BoundingBox b = get_bounding_box();
 	Punch* punch;
 	if (get_facing_front()) {
@@ -922,20 +1142,20 @@ Punch * Fighter::powerPunch() {
 
 Uppercut * Fighter::broccoliUppercut() {
 	//create the bounding box based on fighter position
-	float sizeMultiplier = 1.75;
+	float sizeMultiplier = m_def->punch_reach;
 	BoundingBox b = get_bounding_box();
 	Uppercut* uppercut;
 	if (get_facing_front()) {
 		//right facing
 		float xpos = b.xpos + (b.width / 2.0);
 		float width = sizeMultiplier * (b.width / 2.0);
-		uppercut = new Uppercut(get_id(), { xpos, b.ypos }, { width, b.height }, 1, true, BROCCOLI_UPPERCUT_VERT_VELO, 20);
+		uppercut = new Uppercut(get_id(), { xpos, b.ypos }, { width, b.height }, m_def->uppercut_damage, true, m_def->uppercut_force, m_def->uppercut_ms);
 	}
 	else {
 		//left facing
 		float xpos = b.xpos - ((sizeMultiplier - 1) * (b.width / 2.0));
 		float width = sizeMultiplier * (b.width / 2.0);
-		uppercut = new Uppercut(get_id(), { xpos, b.ypos }, { width, b.height }, 1, false, BROCCOLI_UPPERCUT_VERT_VELO, 20);
+		uppercut = new Uppercut(get_id(), { xpos, b.ypos }, { width, b.height }, m_def->uppercut_damage, false, m_def->uppercut_force, m_def->uppercut_ms);
 	}
 	return uppercut;
 }
@@ -952,30 +1172,30 @@ void Fighter::platform_collision(QuadTree* platform_tree, vec2 oldPosition) {
 		if (platform->check_collision(b)) {
 			if (platform->check_collision_outer_left(b)) {
 				m_position = oldPosition;
-				m_velocity_y = 0.0;
+				bodies().velocity_y[m_slot] = 0.f;
 				m_is_jumping = false;
 			}
 			else if (platform->check_collision_outer_right(b)) {
 				m_position = oldPosition;
-				m_velocity_y = 0.0f;
+				bodies().velocity_y[m_slot] = 0.f;
 				m_is_jumping = false;
 			}
 
 			if (platform->check_collision_outer_top(b)) {
 				m_position.y = oldPosition.y;
-				m_velocity_y = 0.0f;
+				bodies().velocity_y[m_slot] = 0.f;
 				m_is_jumping = false;
 				m_broccoli_jump_left = 2;
 			}
 			else if (platform->check_collision_outer_bottom(b)) {
 				m_position.y = oldPosition.y;
-				m_velocity_y = 0.0f;
+				bodies().velocity_y[m_slot] = 0.f;
 			}
 
 			if (!platform->check_collision_outer_left(b) && !platform->check_collision_outer_right(b) &&
 				!platform->check_collision_outer_top(b) && !platform->check_collision_outer_bottom(b)) {
 				m_position = oldPosition;
-				m_velocity_y = 0.0;
+				bodies().velocity_y[m_slot] = 0.f;
 				m_is_jumping = false;
 			}
 		}
@@ -1000,22 +1220,14 @@ void Fighter::platform_pass_through(QuadTree* platform_tree, vec2 oldPosition) {
 }
 
 void Fighter::y_position_update(float ms) {
-	float s = ms / 1000;
-	m_position.y += m_velocity_y * s;
-	m_velocity_y += GRAVITY.y * s;
-	if (m_velocity_y > TERMINAL_VELOCITY_Y) {
-		m_velocity_y = TERMINAL_VELOCITY_Y;
-	}
-	else if (m_velocity_y < -TERMINAL_VELOCITY_Y) {
-		m_velocity_y = -TERMINAL_VELOCITY_Y;
-	}
+	m_position.y += m_components->fall(m_slot, ms, *m_def);
 }
 
 void Fighter::charging_up_power_punch() {
 	m_holding_too_much_timer += 0.5;
 	// Charging up
-	if (m_holding_power_punch_timer < MAX_POWER_PUNCH_DMG)
-		m_holding_power_punch_timer += POWER_PUNCH_CHARGE_RATE;
+	if (m_holding_power_punch_timer < m_def->power_punch_max_damage)
+		m_holding_power_punch_timer += m_def->power_punch_charge_rate;
 	// Held too long, tired out
 	if (m_holding_too_much_timer >= 120) {
 		m_tired_out = true;
@@ -1028,8 +1240,8 @@ void Fighter::charging_up_power_punch() {
 void Fighter::broccoli_charging_up_cauliflowers() {
 	m_holding_too_much_timer += 0.5;
 	// Charging up
-	if (m_broccoli_holding_cauliflowers_timer < MAX_CAULIFLOWERS_VELOCITY)
-		m_broccoli_holding_cauliflowers_timer += CAULIFLOWERS_CHARGE_RATE;
+	if (m_broccoli_holding_cauliflowers_timer < m_def->charge_max)
+		m_broccoli_holding_cauliflowers_timer += m_def->charge_rate;
 	// Held too long, tired out
 	if (m_holding_too_much_timer >= 120) {
 		m_tired_out = true;
@@ -1042,8 +1254,8 @@ void Fighter::broccoli_charging_up_cauliflowers() {
 void Fighter::potato_charging_up_fries() {
 	m_holding_too_much_timer += 0.5;
 	// Charging up
-	if (m_potato_holding_fries_timer < MAX_CAULIFLOWERS_VELOCITY)
-		m_potato_holding_fries_timer += CAULIFLOWERS_CHARGE_RATE;
+	if (m_potato_holding_fries_timer < m_def->charge_max)
+		m_potato_holding_fries_timer += m_def->charge_rate;
 	// Held too long, tired out
 	if (m_holding_too_much_timer >= 120) {
 		m_tired_out = true;
@@ -1054,7 +1266,7 @@ void Fighter::potato_charging_up_fries() {
 }
 
 float Fighter::get_heal_animation() {
-	return m_yam_heal_animation_ms;
+	return m_yam_row != -1 ? yams().heal_animation_ms[m_yam_row] : 0.f;
 }
 
 Dash * Fighter::dash() {
@@ -1069,62 +1281,7 @@ Emoji * Fighter::emoji() {
 }
 
 void Fighter::set_sprite(SpriteType st) const {
-	if (m_fc == POTATO) {
-		switch (st) {
-			default: f_texture = POTATO_TEXTURE; break;
-			case IDLE: f_texture = POTATO_IDLE_TEXTURE; break;
-			case PUNCH: f_texture = POTATO_PUNCH_TEXTURE; break;
-			case POWER_PUNCH: f_texture = POTATO_POWER_PUNCH_TEXTURE; break;
-			case CROUCH_PUNCH: f_texture = POTATO_CROUCH_PUNCH_TEXTURE; break;
-			case CROUCH: f_texture = POTATO_CROUCH_TEXTURE; break;
-			case CHARGING: f_texture = POTATO_CHARGING_TEXTURE; break;
-			case DEATH: f_texture = POTATO_DEATH_TEXTURE; break;
-			case TIRED_1: f_texture = POTATO_TIRED_1_TEXTURE; break;
-			case TIRED_2: f_texture = POTATO_TIRED_2_TEXTURE; break;
-		}
-	}
-	else if (m_fc == BROCCOLI) {
-		switch (st) {
-			default: f_texture = BROCCOLI_TEXTURE; break;
-			case IDLE: f_texture = BROCCOLI_IDLE_TEXTURE; break;
-			case PUNCH: f_texture = BROCCOLI_PUNCH_TEXTURE; break;
-			case POWER_PUNCH: f_texture = BROCCOLI_PUNCH_TEXTURE; break; // TODO: STUB
-			case CROUCH_PUNCH: f_texture = BROCCOLI_CROUCH_PUNCH_TEXTURE; break;
-			case CROUCH: f_texture = BROCCOLI_CROUCH_TEXTURE; break;
-			case DEATH: f_texture = BROCCOLI_DEATH_TEXTURE; break;
-			case UPPERCUT: f_texture = BROCCOLI_UPPERCUT_TEXTURE; break;
-			case TIRED_1: f_texture = BROCCOLI_TIRED_1_TEXTURE; break;
-			case TIRED_2: f_texture = BROCCOLI_TIRED_2_TEXTURE; break;
-			case CHARGING: f_texture = BROCCOLI_CHARGING_TEXTURE; break;
-		}
-	}
-	else if (m_fc == EGGPLANT) { // TODO: STUB
-		switch (st) {
-		default: f_texture = EGGPLANT_TEXTURE; break;
-		case IDLE: f_texture = EGGPLANT_IDLE_TEXTURE; break;
-		case PUNCH: f_texture = EGGPLANT_PUNCH_TEXTURE; break;
-		case POWER_PUNCH: f_texture = EGGPLANT_POWER_PUNCH_TEXTURE; break;
-		case CROUCH_PUNCH: f_texture = EGGPLANT_CROUCH_PUNCH_TEXTURE; break;
-		case CROUCH: f_texture = EGGPLANT_CROUCH_TEXTURE; break;
-		case CHARGING: f_texture = EGGPLANT_CHARGING_TEXTURE; break;
-		case DEATH: f_texture = EGGPLANT_DEATH_TEXTURE; break;
-		case TIRED_1: f_texture = EGGPLANT_TIRED_1_TEXTURE; break;
-		case TIRED_2: f_texture = EGGPLANT_TIRED_2_TEXTURE; break;
-		}
-	} else if (m_fc == YAM) {
-		switch (st) {
-		default: f_texture = YAM_TEXTURE; break;
-		case IDLE: f_texture = YAM_IDLE_TEXTURE; break;
-		case PUNCH: f_texture = YAM_PUNCH_TEXTURE; break;
-		case POWER_PUNCH: f_texture = YAM_POWER_PUNCH_TEXTURE; break;
-		case CROUCH_PUNCH: f_texture = YAM_CROUCH_PUNCH_TEXTURE; break;
-		case CROUCH: f_texture = YAM_CROUCH_TEXTURE; break;
-		case CHARGING: f_texture = YAM_CHARGING_TEXTURE; break;
-		case DEATH: f_texture = YAM_DEATH_TEXTURE; break;
-		case TIRED_1: f_texture = YAM_TIRED_1_TEXTURE; break;
-		case TIRED_2: f_texture = YAM_TIRED_2_TEXTURE; break;
-		}
-	}
+	f_texture = *m_def->sprites[st];
 }
 
 
@@ -1181,13 +1338,14 @@ void Fighter::reset_broccoli_flags() {
 }
 
 void Fighter::reset_yam_flags() {
-	//yam reset
-	m_yam_is_healing = false;
-	m_yam_heal_cooldown_ms = 0;
-	m_yam_heal_animation_ms = 0.0;
-	m_yam_start_dashing = false;
-	m_yam_dash_cooldown_ms = 0.0;
-	m_yam_dash_timer_ms = 0.0;
+	if (m_yam_row == -1)
+		return;
+	yams().is_healing[m_yam_row] = false;
+	yams().heal_cooldown_ms[m_yam_row] = 0.f;
+	yams().heal_animation_ms[m_yam_row] = 0.f;
+	yams().start_dashing[m_yam_row] = false;
+	yams().dash_cooldown_ms[m_yam_row] = 0.f;
+	yams().dash_timer_ms[m_yam_row] = 0.f;
 }
 
 void Fighter::reset_eggplant_flags() {
@@ -1201,70 +1359,42 @@ void Fighter::reset_eggplant_flags() {
 void Fighter::block(float ms) {
 	//Deplete blocking tank if blocking
 	if (m_is_blocking) {
-		m_blocking_tank -= ms;
+		block_tank() -= ms;
 	}
 	//Stop blocking if blocking tank is empty
-	if (m_is_blocking && m_blocking_tank <= 0) set_blocking(false);
+	if (m_is_blocking && block_tank() <= 0) set_blocking(false);
 	//Recharche blocking tank
-	if (m_is_alive && m_blocking_tank < FULL_BLOCK_TANK && !m_is_blocking) {
-		m_blocking_tank += ms;
+	if (m_is_alive && block_tank() < m_def->block_tank_ms && !m_is_blocking) {
+		block_tank() += ms;
 	}
 }
 
 Dash * Fighter::yam_dash_update(float ms) {
-	Dash * dashPtr = NULL;
-	// Init dash
-	if (m_yam_start_dashing) {
-		if (m_yam_dash_cooldown_ms <= 0.0) {
-			m_yam_dash_timer_ms = MAX_DASH_TIMER;
-		}
-		m_yam_start_dashing = false;
+	DashStep step = m_components->dash(m_yam_row, ms, *m_def);
+	if (step == NOT_DASHING)
+		return NULL;
+
+	float target_ms_per_frame = 1000.f / 60.f;
+	float speed_scale = ms / target_ms_per_frame;
+	if (!m_moving_backward && !m_moving_forward)
+		speed_scale *= 2.0;
+	if (m_facing_front && m_position.x < 1150.f) {
+		move({ m_speed * speed_scale, 0.0 });
 	}
-	// Manage cooldown
-	if (m_yam_dash_cooldown_ms > 0.0) {
-		m_yam_dash_cooldown_ms -= ms;
-	}
-	// Start dash
-	if (m_yam_dash_timer_ms > 0.0) {
-		float target_ms_per_frame = 1000.f / 60.f;
-		float speed_scale = ms / target_ms_per_frame;
-		if (!m_moving_backward && !m_moving_forward)
-			speed_scale *= 2.0;
-		if (m_facing_front && m_position.x < 1150.f) {
-			move({ m_speed * speed_scale, 0.0 });
-		}
-		else if (!m_facing_front && m_position.x > 50.f) {
-			move({ -m_speed * speed_scale, 0.0 });
-		}
-		m_yam_dash_timer_ms -= ms;
-		if (m_yam_dash_timer_ms <= 0.0) {
-			m_yam_dash_cooldown_ms = MAX_DASH_COOLDOWN;
-			dashPtr = dash();
-		}
+	else if (!m_facing_front && m_position.x > 50.f) {
+		move({ -m_speed * speed_scale, 0.0 });
 	}
-
-	return dashPtr;
+	// The dash hits where it ends
+	return step == DASH_ENDED ? dash() : NULL;
 }
 
 void Fighter::yam_heal_update(float ms) {
-	if (m_yam_is_healing) {
-		if (m_yam_heal_cooldown_ms <= 0.0) {
-			// heal, but don't go over the health cap
-			if (RECOVERY_POINTS + m_health < MAX_HEALTH) { m_health += RECOVERY_POINTS; }
-			else { 
-				m_health = MAX_HEALTH; 
-			}
-			//reset cooldown and state
-			m_yam_heal_cooldown_ms = MAX_HEAL_COOLDOWN;
-			m_yam_heal_animation_ms = MAX_HEAL_ANIMATION;
+	if (m_components->heal(m_yam_row, ms, *m_def)) {
+		// heal, but don't go over the health cap
+		if (m_def->heal_points + health() < MAX_HEALTH) { health() += m_def->heal_points; }
+		else { 
+			health() = MAX_HEALTH; 
 		}
-		m_yam_is_healing = false;
-	}
-	if (m_yam_heal_cooldown_ms > 0.0) {
-		m_yam_heal_cooldown_ms -= ms;
-	}
-	if (m_yam_heal_animation_ms > 0.0) {
-		m_yam_heal_animation_ms -= ms;
 	}
 }
 
@@ -1292,11 +1422,11 @@ Emoji * Fighter::eggplant_spawn_emoji_update(float ms) {
 	Emoji * e = NULL;
 	// Spawn in new emoji
 	if (m_eggplant_spawn_emoji) {
-		if (m_eggplant_spawn_cooldown <= 0.0 && m_eggplant_emoji_count < MAX_EMOJI_COUNT) {
+		if (m_eggplant_spawn_cooldown <= 0.0 && (int)m_eggplant_emoji_count < m_def->max_emojis) {
 			e = emoji();
 			m_eggplant_emojis.push_back(e);
 			e->increment_pointer_references();
-			m_eggplant_spawn_cooldown = MAX_EMOJI_SPAWN_COOLDOWN;
+			m_eggplant_spawn_cooldown = m_def->emoji_cooldown_ms;
 			m_eggplant_emoji_count++;
 		}
 		m_eggplant_spawn_emoji = false;
@@ -1372,7 +1502,7 @@ Attack * Fighter::broccoli_update() {
 
 void Fighter::broccoli_double_jump_update() {
 	if (m_broccoli_is_double_jumping && m_broccoli_jump_left == 1) {
-		m_velocity_y = -INITIAL_JUMP_VELOCITY;
+		bodies().velocity_y[m_slot] = -m_def->jump_velocity;
 		m_is_jumping = false;
 		m_broccoli_jump_left = 0;
 		m_broccoli_is_double_jumping = false;
@@ -1383,13 +1513,13 @@ Uppercut * Fighter::broccoli_uppercut_update() {
 	Uppercut * u = NULL;
 	// Start Uppercut
 	if (m_broccoli_is_uppercutting && !m_broccoli_uppercut_on_cooldown) {
-		m_velocity_y = -BROCCOLI_UPPERCUT_VERT_VELO;
+		bodies().velocity_y[m_slot] = -m_def->uppercut_force;
 		u = broccoliUppercut();
 		m_broccoli_uppercut_on_cooldown = true;
 	}
 	// Manage Cooldown
 	if (m_broccoli_uppercut_on_cooldown) {
-		if (m_broccoli_uppercut_cooldown >= BROCCOLI_MAX_UPPERCUT_COOLDOWN) {
+		if (m_broccoli_uppercut_cooldown >= m_def->uppercut_cooldown) {
 			m_broccoli_uppercut_on_cooldown = false;
 			m_broccoli_uppercut_cooldown = 0;
 		}
@@ -1406,7 +1536,7 @@ Projectile * Fighter::broccoli_projectile_update() {
 	if (m_broccoli_is_holding_cauliflowers) broccoli_charging_up_cauliflowers();
 	// Shoot charged projectile
 	else if (m_broccoli_is_shooting_charged_cauliflowers && !m_broccoli_cauliflowers_on_cooldown) {
-		p = new Projectile(get_id(), m_position, m_broccoli_holding_cauliflowers_timer, 10 + m_broccoli_holding_cauliflowers_timer, m_facing_front);
+		p = new Projectile(get_id(), m_position, m_broccoli_holding_cauliflowers_timer, m_def->cauliflower_damage + m_broccoli_holding_cauliflowers_timer, m_facing_front);
 		m_broccoli_cauliflowers_on_cooldown = true;
 		m_holding_too_much_timer = 0;
 		m_broccoli_holding_cauliflowers_timer = 0;
@@ -1414,12 +1544,12 @@ Projectile * Fighter::broccoli_projectile_update() {
 	}
 	// Shoot normal projectile
 	else if (m_broccoli_is_shooting_cauliflowers && !m_broccoli_cauliflowers_on_cooldown) {
-		p = new Projectile(get_id(), m_position, 0, 10, m_facing_front);
+		p = new Projectile(get_id(), m_position, 0, m_def->cauliflower_damage, m_facing_front);
 		m_broccoli_cauliflowers_on_cooldown = true;
 	}
 	// Manage cooldown
 	if (m_broccoli_cauliflowers_on_cooldown) {
-		if (m_broccoli_cauliflowers_cooldown >= BROCCOLI_MAX_CAULIFLOWERS_COOLDOWN) {
+		if (m_broccoli_cauliflowers_cooldown >= m_def->cauliflower_cooldown) {
 			m_broccoli_cauliflowers_on_cooldown = false;
 			m_broccoli_cauliflowers_cooldown = 0;
 		}
@@ -1452,7 +1582,7 @@ Bullet * Fighter::potato_bullet_update() {
 	if (m_potato_is_holding_fries) potato_charging_up_fries();
 	// Shoot powerful bullet
 	else if (m_potato_is_shooting_charged_fries && !m_potato_fries_on_cooldown) {
-		b = new Bullet(get_id(), m_position, m_potato_holding_fries_timer, 10 + m_potato_holding_fries_timer, m_facing_front);
+		b = new Bullet(get_id(), m_position, m_potato_holding_fries_timer, m_def->fries_damage + m_potato_holding_fries_timer, m_facing_front);
 		m_potato_fries_on_cooldown = true;
 		m_holding_too_much_timer = 0;
 		m_potato_holding_fries_timer = 0;
@@ -1460,12 +1590,12 @@ Bullet * Fighter::potato_bullet_update() {
 	}
 	// Shoot normal bullet
 	else if (m_potato_is_shooting_fries && !m_potato_fries_on_cooldown) {
-		b = new Bullet(get_id(), m_position, 0, 10, m_facing_front);
+		b = new Bullet(get_id(), m_position, 0, m_def->fries_damage, m_facing_front);
 		m_potato_fries_on_cooldown = true;
 	}
 	// Manage cooldowns
 	if (m_potato_fries_on_cooldown) {
-		if (m_potato_fries_cooldown >= POTATO_MAX_FRIES_COOLDOWN) {
+		if (m_potato_fries_cooldown >= m_def->fries_cooldown) {
 			m_potato_fries_on_cooldown = false;
 			m_potato_fries_cooldown = 0;
 		}
@@ -1491,7 +1621,7 @@ Bomb * Fighter::potato_bomb_update() {
 	}
 	// Plant a bomb
 	else if (m_potato_is_planting_bomb && !m_potato_bomb_on_cooldown && !m_potato_bomb_planted) {
-		bomb_pointer = new Bomb(get_id(), m_position, 40, 300, POTATO_MAX_BOMB_TIMER);
+		bomb_pointer = new Bomb(get_id(), m_position, m_def->bomb_damage, m_def->bomb_force, m_def->bomb_timer_ms);
 		b = bomb_pointer;
 		bomb_pointer->increment_pointer_references();
 		m_potato_bomb_ticking = true;
@@ -1511,7 +1641,7 @@ Bomb * Fighter::potato_bomb_update() {
 	}
 	// Bomb tick down
 	if (m_potato_bomb_ticking) {
-		if (m_potato_bomb_selftimer >= POTATO_MAX_BOMB_TIMER) {
+		if (m_potato_bomb_selftimer >= m_def->bomb_timer_ms) {
 			m_potato_bomb_ticking = false;
 			m_potato_bomb_on_cooldown = true;
 			m_potato_bomb_selftimer = 0;
@@ -1521,7 +1651,7 @@ Bomb * Fighter::potato_bomb_update() {
 	}
 	// Manage cooldown
 	if (m_potato_bomb_on_cooldown) {
-		if (m_potato_bomb_cooldown >= POTATO_MAX_BOMB_COOLDOWN) {
+		if (m_potato_bomb_cooldown >= m_def->bomb_cooldown) {
 			m_potato_bomb_on_cooldown = false;
 			m_potato_bomb_cooldown = 0;
 		}
@@ -1534,7 +1664,7 @@ Bomb * Fighter::potato_bomb_update() {
 
 void Fighter::tired_status_update() {
 	if (m_tired_out) {
-		if (m_tired_out_timer < STATUS_TIRED_OUT_TIME)
+		if (m_tired_out_timer < m_def->tired_out_time)
 			m_tired_out_timer += 0.5;
 		else {
 			m_tired_out_timer = 0;
@@ -1554,7 +1684,7 @@ Attack * Fighter::punch_update() {
 	}
 	// Manage cooldown
 	if (m_punch_on_cooldown) {
-		if (punching_cooldown >= MAX_PUNCH_COOLDOWN) {
+		if (punching_cooldown >= m_def->punch_cooldown) {
 			m_punch_on_cooldown = false;
 			punching_cooldown = 0;
 		}
@@ -1570,4 +1700,4 @@ Attack * Fighter::punch_update() {
 	}
 
 	return attack;
-}
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 
 #include "common.hpp"
 #include "fighterInfo.hpp"
+#include "fighterDefinition.hpp"
+#include "spriteAnimation.hpp"
 #include "damageEffect.hpp"
 #include "platform.hpp"
 #include "textRenderer.hpp"
@@ -13,11 +15,28 @@
 #include "bomb.hpp"
 #include "dash.hpp"
 #include "emoji.hpp"
+#include "inputBuffer.hpp"
+#include "motionInput.hpp"
+#include "componentStore.hpp"
 #include <set>
 #include <random>
 #include <iostream>
 #include <SDL_mixer.h>
 
+// A fighter as drawn: its sprite and the state its shader shows. Captured at the end
+// of a tick, so the render thread never reads the fighter itself
+struct FighterFrame : public Renderable
+{
+	GLuint texture;
+	bool is_hurt;
+	bool is_blocking;
+	float blocking_tank;
+	float heal_animation_ms;
+
+	void draw(const mat3 &projection) override;
+	void submit(RenderQueue &queue) override;
+};
+
 class Fighter : public Renderable
 {
 	// Shared between all fighters, no need to load one for each instance
@@ -26,16 +45,30 @@ class Fighter : public Renderable
   public:
 	 Fighter(unsigned int id);
 	// Creates all the associated render resources and default transform
-	bool init(int init_position, std::string name, FighterCharacter fc);
+	bool init(int init_position, std::string name, FighterCharacter fc, ComponentStore& components);
 
 	// Releases all the associated resources
 	void destroy();
 
+	// Takes a fresh body in the component arrays unless it has one already, the fighter
+	// needs one before it moves. init() attaches the fighter and destroy() detaches it
+	void attach(ComponentStore& components);
+	void detach();
+
+	// Takes the stats and hurtbox of the current definition of m_fc, used by init() and
+	// when the definitions file is reloaded mid-fight
+	void apply_definition();
+
 	// ms represents the number of milliseconds elapsed from the previous update() call
 	Attack * update(float ms, QuadTree* platform_tree);
 
 	// projection is the 2D orthographic projection matrix
 	void draw(const mat3 &projection) override;
+	// Records what draw() shows and moves the nameplate over the fighter
+	void capture(FighterFrame &frame);
+	// Picks the pose from the fighter's state and steps its animation by ms, called once
+	// per tick after the update
+	void animate(float ms);
 
 	void block(float ms);
 
@@ -60,12 +93,19 @@ class Fighter : public Renderable
 	// Sets the new fighter position
 	void set_position(vec2 position);
 
+	// Moves the fighter and the spot it respawns at, facing the stage's center
+	void set_spawn_position(vec2 position);
+
 	// move current position by given offset
 	void move(vec2 off);
 
-	// Set fighter's movements
+	// Set fighter's movements. With an input buffer, presses the fighter cannot act on
+	// yet are retried until the buffer window ends, and special moves are recognized
 	void set_movement(int mov);
 
+	// How long early presses are kept, 0 for none and no special moves, as for the AI
+	void set_input_buffer_ms(float window_ms);
+
 	void set_hurt(bool hurt);
 
 	void apply_damage(DamageEffect * damage_effect);
@@ -100,8 +140,6 @@ class Fighter : public Renderable
 	FighterCharacter get_fc() const;
 	void set_sprite(SpriteType st) const;
 
-	void apply_friction();
-
 	void x_position_update(float added_speed, float ms, QuadTree* platform_tree);
 
 	void y_position_update(float ms);
@@ -156,7 +194,7 @@ class Fighter : public Renderable
 
 	Mix_Chunk *m_jump_audio;
 
-	FighterCharacter m_fc;
+	FighterCharacter m_fc = POTATO;
 	// Potato
 	Attack * potato_update();
 	Bullet * potato_bullet_update();
@@ -195,10 +233,10 @@ class Fighter : public Renderable
 	void reset_yam_flags();
 	Dash * yam_dash_update(float ms);
 	void yam_heal_update(float ms);
-	bool yam_is_start_dashing() { return m_yam_start_dashing; }
-	bool yam_dash_on_cooldown() { return m_yam_dash_cooldown_ms <= 0; }
-	bool yam_is_healing() { return m_yam_is_healing; }
-	bool yam_heal_on_cooldown() { return m_yam_heal_cooldown_ms <= 0; }
+	bool yam_is_start_dashing() { return m_yam_row != -1 && yams().start_dashing[m_yam_row]; }
+	bool yam_dash_on_cooldown() { return m_yam_row != -1 && yams().dash_cooldown_ms[m_yam_row] <= 0; }
+	bool yam_is_healing() { return m_yam_row != -1 && yams().is_healing[m_yam_row]; }
+	bool yam_heal_on_cooldown() { return m_yam_row != -1 && yams().heal_cooldown_ms[m_yam_row] <= 0; }
 
 	// Helpers
 	Attack * punch_update();
@@ -206,10 +244,14 @@ class Fighter : public Renderable
 	void tired_status_update();
 
   protected:
+	SpriteType m_sprite = ORIGINAL; // picked by animate()
+	SpriteAnimator m_animator;
+	bool m_shows_tired_out = false; // players slump while tired out, AIs keep their pose
+	const FighterDefinition* m_def = &fighterDefinitions[POTATO]; // stats and tuning of m_fc, set by init()
+
   	int MAX_HEALTH;
 	const int STARTING_LIVES = 3;
 
-	int m_health;
 	int m_lives; //counter for lives/stock remaining
 	vec2 m_position;  // Window coordinates
 
@@ -244,12 +286,9 @@ class Fighter : public Renderable
 	float m_tired_out_timer = 0;
 	float m_holding_too_much_timer = 0;
 	float m_holding_power_punch_timer = 0;
-	int m_blocking_tank;
 	bool m_is_blocking = false;
 	int m_respawn_timer = 0;
 	bool m_respawn_flag = false;
-	int m_anim_counter = 0;
-	int m_punch_counter = 0;
 	bool m_is_paused = false;
 
 	// POTATO states
@@ -269,10 +308,6 @@ class Fighter : public Renderable
 	bool m_potato_fries_on_cooldown = false;
 	float m_potato_holding_fries_timer = 0;
 	float m_potato_fries_cooldown = 0;
-	//CONSTANTS
-	const float POTATO_MAX_FRIES_COOLDOWN = 100.0;
-	const float POTATO_MAX_BOMB_COOLDOWN = 300.0;
-	const float POTATO_MAX_BOMB_TIMER = 500.0;
 
 	// BROCCOLI states
 	// PASSIVE: Double Jump
@@ -289,26 +324,6 @@ class Fighter : public Renderable
 	bool m_broccoli_cauliflowers_on_cooldown = false;
 	float m_broccoli_holding_cauliflowers_timer = 0;
 	float m_broccoli_cauliflowers_cooldown = 0;
-	// CONSTANTS
-	const float  BROCCOLI_MAX_UPPERCUT_COOLDOWN = 200.0;
-	const float BROCCOLI_UPPERCUT_VERT_VELO = 500.0;
-	const float BROCCOLI_MAX_CAULIFLOWERS_COOLDOWN = 100.0;
-	const unsigned int BROCCOLI_MAX_CAULIFLOWERS_ON_SCREEN = 5;
-	const float MAX_CAULIFLOWERS_VELOCITY = 20;
-	const float CAULIFLOWERS_CHARGE_RATE = 0.5;
-
-	// yam states
-	bool m_yam_is_healing = false;
-	float m_yam_heal_cooldown_ms = 0;
-	float m_yam_heal_animation_ms = 0.0;
-	const float MAX_HEAL_COOLDOWN = 1000.0;
-	const float MAX_HEAL_ANIMATION = 200.0;
-	const int RECOVERY_POINTS = 5;
-	bool m_yam_start_dashing = false;
-	float m_yam_dash_cooldown_ms = 0.0;
-	float m_yam_dash_timer_ms = 0.0;
-	const float MAX_DASH_TIMER = 500.0;
-	const float MAX_DASH_COOLDOWN = 1000.0;
 
 	//eggplant states
 	bool m_eggplant_spawn_emoji = false;
@@ -316,32 +331,39 @@ class Fighter : public Renderable
 	unsigned int m_eggplant_emoji_count = 0;
 	float m_eggplant_spawn_cooldown = 0.0;
 	float m_eggplant_shoot_cooldown = 0.0;
-	const float MAX_EMOJI_SPAWN_COOLDOWN = 500.0;
-	const unsigned int MAX_EMOJI_COUNT = 3;
 	std::vector<Emoji*> m_eggplant_emojis;
 
 	CrouchState m_crouch_state = NOT_CROUCHING;
 
-	vec2 m_force;	// in Newtons
-	float m_mass;	// mass in kg
-	float m_friction;
-	float m_velocity_y;
-
-	//CONST VALUES
-	const int RESPAWN_TIME = 1000; //in ms
-	
-	const float INITIAL_JUMP_VELOCITY = 400.0;
-	const float TERMINAL_VELOCITY_Y = 400.0;
-	const vec2 GRAVITY = {0.0, 800.0};
-	const int MAX_POWER_PUNCH_DMG = 35;		// +1 (original strength)  !!!FIX THIS, IT DOESNT TAKE INTO ACCOUNT THE FIGHTER TYPE
-	const float POWER_PUNCH_CHARGE_RATE = 0.5;
-	const float MAX_PUNCH_COOLDOWN = 20.0;
-	const int FULL_BLOCK_TANK = 4000;
-	const float STATUS_TIRED_OUT_TIME = 80.0;
-
+	// Body, health, block tank and yam states live in the world's component arrays, in row
+	// m_slot of bodies and m_yam_row of yams from attach(). Only Yam has a yams row
+	ComponentStore* m_components = NULL;
+	int m_slot = -1;
+	int m_yam_row = -1;
+	BodyRows& bodies() { return m_components->bodies; }
+	const BodyRows& bodies() const { return m_components->bodies; }
+	YamRows& yams() { return m_components->yams; }
+	const YamRows& yams() const { return m_components->yams; }
+	int& health() { return m_components->bodies.health[m_slot]; }
+	int& block_tank() { return m_components->bodies.block_tank_ms[m_slot]; }
 
 	const unsigned int m_id; //unique identifier given when created
 
+	// Input buffering and special moves
+	void apply_movement(int mov);
+	bool can_act(int mov) const;
+	bool feed_motion(int mov);
+	void input_buffer_update(float ms);
+	void release_buffered_inputs();
+
+	InputBuffer m_input_buffer;
+	float m_input_time_ms = 0.f; // time the fighter has been updated for
+	int m_motion_state = MotionRecognizer::START;
+	float m_last_motion_ms = 0.f;
+	// Buffered presses let go before they were acted on, released after this update
+	int m_pending_releases[InputBuffer::CAPACITY];
+	int m_pending_release_count = 0;
+
 	// C++ rng
 	std::default_random_engine m_rng;
 	std::uniform_real_distribution<float> m_dist; // default 0..1
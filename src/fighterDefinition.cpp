@@ -0,0 +1,355 @@
+// Header
+#include "fighterDefinition.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+FighterDefinition fighterDefinitions[FIGHTER_CHARACTER_COUNT];
+
+namespace
+{
+	const int DEFINITIONS_VERSION = 1;
+	const int ANY_FIGHTER = -1;
+
+	const char* CHARACTER_NAMES[FIGHTER_CHARACTER_COUNT] = { "potato", "broccoli", "eggplant", "yam" };
+	const char* SPRITE_NAMES[SPRITE_TYPE_COUNT] = { "original", "idle", "punch", "power_punch", "crouch_punch",
+		"crouch", "charging", "death", "tired_1", "tired_2", "uppercut" };
+
+	// Numeric key of the file, stored in either a float or an int member
+	struct Field
+	{
+		const char* key;
+		int fc; // the only character using it, or ANY_FIGHTER
+		float FighterDefinition::*real;
+		int FighterDefinition::*integer;
+	};
+
+	const Field FIELDS[] = {
+		{ "strength", ANY_FIGHTER, nullptr, &FighterDefinition::strength },
+		{ "speed", ANY_FIGHTER, nullptr, &FighterDefinition::speed },
+		{ "health", ANY_FIGHTER, nullptr, &FighterDefinition::health },
+		{ "hurtbox_divisor_x", ANY_FIGHTER, &FighterDefinition::hurtbox_divisor_x, nullptr },
+		{ "hurtbox_divisor_y", ANY_FIGHTER, &FighterDefinition::hurtbox_divisor_y, nullptr },
+		{ "punch_reach", ANY_FIGHTER, &FighterDefinition::punch_reach, nullptr },
+		{ "jump_velocity", ANY_FIGHTER, &FighterDefinition::jump_velocity, nullptr },
+		{ "terminal_velocity", ANY_FIGHTER, &FighterDefinition::terminal_velocity, nullptr },
+		{ "gravity", ANY_FIGHTER, &FighterDefinition::gravity, nullptr },
+		{ "respawn_ms", ANY_FIGHTER, nullptr, &FighterDefinition::respawn_ms },
+		{ "block_tank_ms", ANY_FIGHTER, nullptr, &FighterDefinition::block_tank_ms },
+		{ "tired_out_time", ANY_FIGHTER, &FighterDefinition::tired_out_time, nullptr },
+		{ "punch_cooldown", ANY_FIGHTER, &FighterDefinition::punch_cooldown, nullptr },
+		{ "power_punch_max_damage", ANY_FIGHTER, nullptr, &FighterDefinition::power_punch_max_damage },
+		{ "power_punch_charge_rate", ANY_FIGHTER, &FighterDefinition::power_punch_charge_rate, nullptr },
+		{ "charge_max", ANY_FIGHTER, &FighterDefinition::charge_max, nullptr },
+		{ "charge_rate", ANY_FIGHTER, &FighterDefinition::charge_rate, nullptr },
+		{ "fries_cooldown", POTATO, &FighterDefinition::fries_cooldown, nullptr },
+		{ "fries_damage", POTATO, nullptr, &FighterDefinition::fries_damage },
+		{ "bomb_cooldown", POTATO, &FighterDefinition::bomb_cooldown, nullptr },
+		{ "bomb_timer_ms", POTATO, &FighterDefinition::bomb_timer_ms, nullptr },
+		{ "bomb_damage", POTATO, nullptr, &FighterDefinition::bomb_damage },
+		{ "bomb_force", POTATO, &FighterDefinition::bomb_force, nullptr },
+		{ "uppercut_cooldown", BROCCOLI, &FighterDefinition::uppercut_cooldown, nullptr },
+		{ "uppercut_damage", BROCCOLI, nullptr, &FighterDefinition::uppercut_damage },
+		{ "uppercut_force", BROCCOLI, &FighterDefinition::uppercut_force, nullptr },
+		{ "uppercut_ms", BROCCOLI, &FighterDefinition::uppercut_ms, nullptr },
+		{ "cauliflower_cooldown", BROCCOLI, &FighterDefinition::cauliflower_cooldown, nullptr },
+		{ "cauliflower_damage", BROCCOLI, nullptr, &FighterDefinition::cauliflower_damage },
+		{ "emoji_cooldown_ms", EGGPLANT, &FighterDefinition::emoji_cooldown_ms, nullptr },
+		{ "max_emojis", EGGPLANT, nullptr, &FighterDefinition::max_emojis },
+		{ "heal_cooldown_ms", YAM, &FighterDefinition::heal_cooldown_ms, nullptr },
+		{ "heal_animation_ms", YAM, &FighterDefinition::heal_animation_ms, nullptr },
+		{ "heal_points", YAM, nullptr, &FighterDefinition::heal_points },
+		{ "dash_ms", YAM, &FighterDefinition::dash_ms, nullptr },
+		{ "dash_cooldown_ms", YAM, &FighterDefinition::dash_cooldown_ms, nullptr },
+	};
+	const int FIELD_COUNT = sizeof(FIELDS) / sizeof(FIELDS[0]);
+
+	// A definitions section while it is read, with the keys it set so far
+	struct ParsedFighter
+	{
+		FighterDefinition definition;
+		bool set[FIELD_COUNT];
+		bool has_color;
+		std::string sprite_files[SPRITE_TYPE_COUNT];
+		std::string sci_name;
+		std::vector<std::string> names;
+		std::string abilities;
+	};
+
+	// Sprites by file name, fighters sharing a picture share the texture. Entries are never
+	// removed so the pointers in the table stay valid when the definitions are loaded again
+	std::map<std::string, Texture> g_sprites;
+
+	int find_name(const char* const* names, int count, const std::string& name)
+	{
+		for (int i = 0; i < count; i++)
+			if (name == names[i])
+				return i;
+		return -1;
+	}
+
+	// "key rest of the line" without the comment and the surrounding blanks
+	bool split_line(const char* line, std::string& key, std::string& value)
+	{
+		std::string text(line);
+		text = text.substr(0, text.find('#'));
+		size_t begin = text.find_first_not_of(" \t\r\n");
+		if (begin == std::string::npos)
+			return false;
+		size_t end = text.find_last_not_of(" \t\r\n");
+		text = text.substr(begin, end - begin + 1);
+
+		size_t blank = text.find_first_of(" \t");
+		key = text.substr(0, blank);
+		value = blank == std::string::npos ? "" : text.substr(text.find_first_not_of(" \t", blank));
+		return true;
+	}
+
+	bool parse_field(const Field& field, const std::string& value, FighterDefinition& definition)
+	{
+		char* end = nullptr;
+		if (field.real != nullptr)
+		{
+			float number = strtof(value.c_str(), &end);
+			definition.*field.real = number;
+			return end != value.c_str() && *end == '\0' && number > 0.f;
+		}
+		long number = strtol(value.c_str(), &end, 10);
+		definition.*field.integer = (int)number;
+		return end != value.c_str() && *end == '\0' && number > 0;
+	}
+
+	bool check_fighter(const char* path, int fc, const ParsedFighter& fighter)
+	{
+		const char* name = CHARACTER_NAMES[fc];
+		bool ok = true;
+		for (int i = 0; i < FIELD_COUNT; i++)
+		{
+			if ((FIELDS[i].fc == ANY_FIGHTER || FIELDS[i].fc == fc) && !fighter.set[i])
+			{
+				fprintf(stderr, "%s: %s has no %s\n", path, name, FIELDS[i].key);
+				ok = false;
+			}
+		}
+
+		const FighterDefinition& definition = fighter.definition;
+		if (definition.strength > 5 || definition.speed > 5)
+		{
+			fprintf(stderr, "%s: %s strength and speed go from 1 to 5\n", path, name);
+			ok = false;
+		}
+		if (!fighter.has_color || fighter.sprite_files[ORIGINAL].empty())
+		{
+			fprintf(stderr, "%s: %s needs a particle_color and an original sprite\n", path, name);
+			ok = false;
+		}
+		if (fighter.sci_name.empty() || fighter.names.empty() || fighter.abilities.empty())
+		{
+			fprintf(stderr, "%s: %s needs a sci_name, names and abilities\n", path, name);
+			ok = false;
+		}
+		return ok;
+	}
+
+	Texture* load_sprite(const std::string& file)
+	{
+		std::map<std::string, Texture>::iterator it = g_sprites.find(file);
+		if (it != g_sprites.end())
+			return &it->second;
+
+		Texture& texture = g_sprites[file];
+		std::string path = std::string(textures_path("")) + file;
+		if (!texture.load_from_file(path.c_str()))
+		{
+			fprintf(stderr, "Failed to load sprite %s\n", path.c_str());
+			g_sprites.erase(file);
+			return nullptr;
+		}
+		return &texture;
+	}
+
+	bool parse_definitions(const char* path, FILE* file, ParsedFighter* fighters)
+	{
+		ParsedFighter defaults = ParsedFighter();
+		bool defined[FIGHTER_CHARACTER_COUNT] = {};
+		ParsedFighter* section = nullptr;
+		int section_fc = ANY_FIGHTER;
+		bool has_header = false;
+
+		char line[512];
+		int line_number = 0;
+		std::string key, value;
+		while (fgets(line, sizeof(line), file) != nullptr)
+		{
+			line_number++;
+			if (!split_line(line, key, value))
+				continue;
+
+			if (!has_header)
+			{
+				int version = 0;
+				if (key != "veggie-fighters" || sscanf(value.c_str(), "%d", &version) != 1 || version != DEFINITIONS_VERSION)
+				{
+					fprintf(stderr, "%s is not a version %d fighter definitions file\n", path, DEFINITIONS_VERSION);
+					return false;
+				}
+				has_header = true;
+				continue;
+			}
+
+			bool ok = true;
+			if (section == nullptr)
+			{
+				int fc = key == "fighter" ? find_name(CHARACTER_NAMES, FIGHTER_CHARACTER_COUNT, value) : ANY_FIGHTER;
+				if (key == "defaults" && value.empty())
+				{
+					section = &defaults;
+				}
+				else if (fc != ANY_FIGHTER && !defined[fc])
+				{
+					// Fighters start from the defaults read so far
+					fighters[fc] = defaults;
+					section = &fighters[fc];
+					section_fc = fc;
+					defined[fc] = true;
+				}
+				else
+				{
+					ok = false;
+				}
+			}
+			else if (key == "end")
+			{
+				if (section_fc != ANY_FIGHTER && !check_fighter(path, section_fc, *section))
+					return false;
+				section = nullptr;
+				section_fc = ANY_FIGHTER;
+			}
+			else if (key == "sprite")
+			{
+				size_t blank = value.find_first_of(" \t");
+				int sprite = blank == std::string::npos ? -1 : find_name(SPRITE_NAMES, SPRITE_TYPE_COUNT, value.substr(0, blank));
+				if (sprite >= 0 && section_fc != ANY_FIGHTER)
+					section->sprite_files[sprite] = value.substr(value.find_first_not_of(" \t", blank));
+				else
+					ok = false;
+			}
+			else if (key == "particle_color")
+			{
+				vec3& color = section->definition.particle_color;
+				ok = sscanf(value.c_str(), "%f %f %f", &color.x, &color.y, &color.z) == 3 &&
+					color.x >= 0.f && color.x <= 1.f && color.y >= 0.f && color.y <= 1.f && color.z >= 0.f && color.z <= 1.f;
+				section->has_color = ok;
+			}
+			else if (key == "sci_name")
+			{
+				section->sci_name = value;
+			}
+			else if (key == "abilities")
+			{
+				section->abilities = value;
+			}
+			else if (key == "names")
+			{
+				std::istringstream stream(value);
+				std::string name;
+				section->names.clear();
+				while (stream >> name)
+					section->names.push_back(name);
+			}
+			else
+			{
+				ok = false;
+				for (int i = 0; i < FIELD_COUNT; i++)
+				{
+					if (key != FIELDS[i].key)
+						continue;
+					// Another character's ability key is most likely a copy paste mistake
+					if (FIELDS[i].fc == ANY_FIGHTER || FIELDS[i].fc == section_fc)
+					{
+						ok = parse_field(FIELDS[i], value, section->definition);
+						section->set[i] = ok;
+					}
+					break;
+				}
+			}
+
+			if (!ok)
+			{
+				fprintf(stderr, "%s:%d: unexpected \"%s %s\"\n", path, line_number, key.c_str(), value.c_str());
+				return false;
+			}
+		}
+
+		if (!has_header || section != nullptr)
+		{
+			fprintf(stderr, "%s is missing its header or the end of a section\n", path);
+			return false;
+		}
+		for (int fc = 0; fc < FIGHTER_CHARACTER_COUNT; fc++)
+		{
+			if (!defined[fc])
+			{
+				fprintf(stderr, "%s does not define %s\n", path, CHARACTER_NAMES[fc]);
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+bool read_fighter_definitions(const char* path, FighterDefinitionFile& result)
+{
+	FILE* file = fopen(path, "r");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "Failed to open fighter definitions %s\n", path);
+		return false;
+	}
+
+	std::vector<ParsedFighter> fighters(FIGHTER_CHARACTER_COUNT);
+	bool ok = parse_definitions(path, file, fighters.data());
+	fclose(file);
+	if (!ok)
+		return false;
+
+	// Names are resolved here, fighters only index the table
+	for (int fc = 0; fc < FIGHTER_CHARACTER_COUNT; fc++)
+	{
+		ParsedFighter& fighter = fighters[fc];
+		for (int sprite = 0; sprite < SPRITE_TYPE_COUNT; sprite++)
+		{
+			const std::string& name = fighter.sprite_files[sprite].empty() ? fighter.sprite_files[ORIGINAL] : fighter.sprite_files[sprite];
+			fighter.definition.sprites[sprite] = load_sprite(name);
+			if (fighter.definition.sprites[sprite] == nullptr)
+				return false;
+		}
+
+		result.definitions[fc] = fighter.definition;
+		result.infos[fc].setInfo((FighterCharacter)fc, fighter.definition.strength, fighter.definition.speed,
+			fighter.definition.health, fighter.sci_name, fighter.names, fighter.abilities);
+	}
+	return true;
+}
+
+void apply_fighter_definitions(const FighterDefinitionFile& file)
+{
+	for (int fc = 0; fc < FIGHTER_CHARACTER_COUNT; fc++)
+	{
+		fighterDefinitions[fc] = file.definitions[fc];
+		fighterMap[(FighterCharacter)fc] = file.infos[fc];
+	}
+}
+
+bool load_fighter_definitions(const char* path)
+{
+	FighterDefinitionFile file;
+	if (!read_fighter_definitions(path, file))
+		return false;
+
+	apply_fighter_definitions(file);
+	fprintf(stderr, "Loaded fighter definitions\n");
+	return true;
+}
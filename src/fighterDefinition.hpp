@@ -0,0 +1,87 @@
+#pragma once
+
+#include "common.hpp"
+#include "fighterInfo.hpp"
+
+const int FIGHTER_CHARACTER_COUNT = BLANK;
+const int SPRITE_TYPE_COUNT = UPPERCUT + 1;
+
+// Everything a fighter reads while it updates, loaded from data/fighters/fighters.txt.
+// Only numbers and texture pointers, the names shown by the menus stay in fighterMap.
+// Cooldowns without a unit are counted in updates, like the timers they are compared to
+struct FighterDefinition
+{
+	// Stats, strength and speed go from 1 to 5
+	int strength;
+	int speed;
+	int health;
+	vec3 particle_color;
+
+	// Every SpriteType, the ones a fighter has no picture for show its original sprite
+	Texture* sprites[SPRITE_TYPE_COUNT];
+	// Hurtbox is the sprite size divided by these
+	float hurtbox_divisor_x;
+	float hurtbox_divisor_y;
+	// Punches and uppercuts reach this many half hurtbox widths
+	float punch_reach;
+
+	float jump_velocity;
+	float terminal_velocity;
+	float gravity;
+	int respawn_ms;
+	int block_tank_ms;
+	float tired_out_time;
+	float punch_cooldown;
+	int power_punch_max_damage;
+	float power_punch_charge_rate;
+	// Charged fries and cauliflowers
+	float charge_max;
+	float charge_rate;
+
+	// Potato
+	float fries_cooldown;
+	int fries_damage;
+	float bomb_cooldown;
+	float bomb_timer_ms;
+	int bomb_damage;
+	float bomb_force;
+	// Broccoli
+	float uppercut_cooldown;
+	int uppercut_damage;
+	float uppercut_force;
+	float uppercut_ms;
+	float cauliflower_cooldown;
+	int cauliflower_damage;
+	// Eggplant
+	float emoji_cooldown_ms;
+	int max_emojis;
+	// Yam
+	float heal_cooldown_ms;
+	float heal_animation_ms;
+	int heal_points;
+	float dash_ms;
+	float dash_cooldown_ms;
+};
+
+// A definitions file once read, checked and with its sprites loaded
+struct FighterDefinitionFile
+{
+	FighterDefinition definitions[FIGHTER_CHARACTER_COUNT];
+	FighterInfo infos[FIGHTER_CHARACTER_COUNT];
+};
+
+// Parses and checks path and loads the sprites it names, so it needs the GL context.
+// Errors are printed
+bool read_fighter_definitions(const char* path, FighterDefinitionFile& file);
+// Replaces the table and fighterMap. Fighters read the table while they update and
+// draw, so this waits for a moment where neither runs
+void apply_fighter_definitions(const FighterDefinitionFile& file);
+// Both of the above, nothing is changed if the file has an error
+bool load_fighter_definitions(const char* path = fighters_path("fighters.txt"));
+
+extern FighterDefinition fighterDefinitions[FIGHTER_CHARACTER_COUNT];
+
+inline const FighterDefinition& get_fighter_definition(FighterCharacter fc)
+{
+	return fighterDefinitions[fc];
+}
@@ -62,57 +62,10 @@ protected:
 };
 
 bool load_all_sprites_from_file();
-void load_fighter_templates();
 vec3 get_particle_color_for_fc(FighterCharacter fc);
 
 extern std::map<FighterCharacter, FighterInfo> fighterMap;
 
-extern Texture POTATO_TEXTURE;
-extern Texture POTATO_IDLE_TEXTURE;
-extern Texture POTATO_PUNCH_TEXTURE;
-extern Texture POTATO_POWER_PUNCH_TEXTURE;
-extern Texture POTATO_CROUCH_PUNCH_TEXTURE;
-extern Texture POTATO_CROUCH_TEXTURE;
-extern Texture POTATO_CHARGING_TEXTURE;
-extern Texture POTATO_DEATH_TEXTURE;
-extern Texture POTATO_TIRED_1_TEXTURE;
-extern Texture POTATO_TIRED_2_TEXTURE;
-
-extern Texture YAM_TEXTURE;
-extern Texture YAM_IDLE_TEXTURE;
-extern Texture YAM_PUNCH_TEXTURE;
-extern Texture YAM_POWER_PUNCH_TEXTURE;
-extern Texture YAM_POWER_PUNCH_TEXTURE;
-extern Texture YAM_CROUCH_PUNCH_TEXTURE;
-extern Texture YAM_CROUCH_TEXTURE;
-extern Texture YAM_CHARGING_TEXTURE;
-extern Texture YAM_DEATH_TEXTURE;
-extern Texture YAM_TIRED_1_TEXTURE;
-extern Texture YAM_TIRED_2_TEXTURE;
-
-extern Texture EGGPLANT_TEXTURE;
-extern Texture EGGPLANT_IDLE_TEXTURE;
-extern Texture EGGPLANT_CROUCH_TEXTURE;
-extern Texture EGGPLANT_PUNCH_TEXTURE;
-extern Texture EGGPLANT_CROUCH_PUNCH_TEXTURE;
-extern Texture EGGPLANT_CHARGING_TEXTURE;
-extern Texture EGGPLANT_POWER_PUNCH_TEXTURE;
-extern Texture EGGPLANT_DEATH_TEXTURE;
-extern Texture EGGPLANT_TIRED_1_TEXTURE;
-extern Texture EGGPLANT_TIRED_2_TEXTURE;
-
-extern Texture BROCCOLI_TEXTURE;
-extern Texture BROCCOLI_IDLE_TEXTURE;
-extern Texture BROCCOLI_PUNCH_TEXTURE;
-extern Texture BROCCOLI_CROUCH_PUNCH_TEXTURE;
-extern Texture BROCCOLI_CROUCH_TEXTURE;
-extern Texture BROCCOLI_DEATH_TEXTURE;
-extern Texture BROCCOLI_UPPERCUT_TEXTURE;
-extern Texture BROCCOLI_TIRED_1_TEXTURE;
-extern Texture BROCCOLI_TIRED_2_TEXTURE;
-extern Texture BROCCOLI_CHARGING_TEXTURE;
-extern Texture BROCCOLI_POWER_PUNCH_TEXTURE;
-
 extern Texture MAIN_MENU_TEXTURE;
 extern Texture KITCHEN_BACKGROUND_TEXTURE;
 extern Texture OVEN_BACKGROUND_TEXTURE;
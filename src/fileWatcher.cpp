@@ -0,0 +1,95 @@
+// Header
+#include "fileWatcher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#if __linux__
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+#if __linux__
+
+bool FileWatcher::init()
+{
+	m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (m_fd < 0)
+	{
+		fprintf(stderr, "Failed to start watching files\n");
+		return false;
+	}
+	return true;
+}
+
+void FileWatcher::destroy()
+{
+	if (m_fd >= 0)
+		close(m_fd);
+	m_fd = -1;
+	m_directories.clear();
+}
+
+bool FileWatcher::watch(const std::string& directory)
+{
+	// Editors either write the file in place or rename a finished copy over it
+	int wd = m_fd < 0 ? -1 : inotify_add_watch(m_fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+	if (wd < 0)
+	{
+		fprintf(stderr, "Failed to watch %s\n", directory.c_str());
+		return false;
+	}
+	m_directories[wd] = directory;
+	return true;
+}
+
+void FileWatcher::poll(std::vector<std::string>& changed)
+{
+	if (m_fd < 0)
+		return;
+
+	size_t first = changed.size();
+	alignas(inotify_event) char buffer[4096];
+	while (true)
+	{
+		ssize_t length = read(m_fd, buffer, sizeof(buffer));
+		if (length <= 0)
+			break; // EAGAIN, nothing more for now
+
+		for (char* p = buffer; p < buffer + length; )
+		{
+			const inotify_event* event = (const inotify_event*)p;
+			p += sizeof(inotify_event) + event->len;
+
+			auto directory = m_directories.find(event->wd);
+			if (event->len == 0 || directory == m_directories.end())
+				continue;
+			std::string path = directory->second + event->name;
+			if (std::find(changed.begin() + first, changed.end(), path) == changed.end())
+				changed.push_back(path);
+		}
+	}
+}
+
+#else
+
+bool FileWatcher::init()
+{
+	fprintf(stderr, "Watching files is only supported on Linux\n");
+	return false;
+}
+
+void FileWatcher::destroy()
+{
+}
+
+bool FileWatcher::watch(const std::string& directory)
+{
+	return false;
+}
+
+void FileWatcher::poll(std::vector<std::string>& changed)
+{
+}
+
+#endif
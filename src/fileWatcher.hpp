@@ -0,0 +1,24 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include <vector>
+
+// Reports the files written in a few directories, without the directories below them.
+// Uses inotify on Linux; elsewhere init() fails and nothing is ever reported
+class FileWatcher
+{
+public:
+	bool init();
+	void destroy();
+
+	// directory ends with a '/', reported paths are directory + file name
+	bool watch(const std::string& directory);
+
+	// Appends the paths written since the last call, each once. Never blocks
+	void poll(std::vector<std::string>& changed);
+
+private:
+	int m_fd = -1;
+	std::map<int, std::string> m_directories; // by watch descriptor
+};
@@ -0,0 +1,225 @@
+// Header
+#include "framePacer.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+	const float HISTOGRAM_MS_PER_BUCKET = 0.05f;
+	// An interval this much over the target is a frame shown one refresh too late
+	const float MISSED_FRAME_FACTOR = 1.5f;
+
+	// Bounds of the spun part of a capped wait
+	const uint64_t MIN_SPIN_NS = 500000;
+	const uint64_t INITIAL_SPIN_NS = 2000000;
+
+	struct ModeName
+	{
+		PresentMode mode;
+		const char* name;
+	};
+	const ModeName MODE_NAMES[] = {
+		{ PRESENT_VSYNC, "vsync" },
+		{ PRESENT_ADAPTIVE, "adaptive" },
+		{ PRESENT_UNCAPPED, "uncapped" },
+		{ PRESENT_CAPPED, "capped" },
+	};
+}
+
+bool FramePacer::parse_mode(const char* name, PresentMode& mode)
+{
+	for (const ModeName& entry : MODE_NAMES)
+	{
+		if (strcmp(entry.name, name) == 0)
+		{
+			mode = entry.mode;
+			return true;
+		}
+	}
+	return false;
+}
+
+const char* FramePacer::get_mode_name(PresentMode mode)
+{
+	for (const ModeName& entry : MODE_NAMES)
+	{
+		if (entry.mode == mode)
+			return entry.name;
+	}
+	return "unknown";
+}
+
+void FramePacer::init(PresentMode mode, float cap_fps, int refresh_rate)
+{
+	m_mode = mode;
+	m_target_ms = 0.f;
+	m_frame_ns = 0;
+
+	switch (mode)
+	{
+	case PRESENT_ADAPTIVE:
+		// -1 is only valid with the tear extension, plain vsync otherwise
+		if (glfwExtensionSupported("WGL_EXT_swap_control_tear") || glfwExtensionSupported("GLX_EXT_swap_control_tear"))
+		{
+			glfwSwapInterval(-1);
+		}
+		else
+		{
+			fprintf(stderr, "Adaptive vsync is not supported here, using vsync\n");
+			m_mode = PRESENT_VSYNC;
+			glfwSwapInterval(1);
+		}
+		break;
+	case PRESENT_VSYNC:
+		glfwSwapInterval(1);
+		break;
+	case PRESENT_UNCAPPED:
+		glfwSwapInterval(0);
+		break;
+	case PRESENT_CAPPED:
+		glfwSwapInterval(0);
+		if (cap_fps <= 0.f)
+			cap_fps = 60.f;
+		m_target_ms = 1000.f / cap_fps;
+		m_frame_ns = (uint64_t)(1e9 / cap_fps);
+		m_spin_ns = std::min(INITIAL_SPIN_NS, m_frame_ns);
+		break;
+	}
+
+	if ((m_mode == PRESENT_VSYNC || m_mode == PRESENT_ADAPTIVE) && refresh_rate > 0)
+		m_target_ms = 1000.f / refresh_rate;
+
+	m_next_frame_ns = 0;
+	m_last_swap_ns = 0;
+}
+
+void FramePacer::sleep_until(uint64_t deadline_ns)
+{
+	uint64_t now = profiler_now_ns();
+	if (deadline_ns > now + m_spin_ns)
+	{
+		uint64_t wanted_ns = deadline_ns - m_spin_ns - now;
+		std::this_thread::sleep_for(std::chrono::nanoseconds(wanted_ns));
+		uint64_t slept_ns = profiler_now_ns() - now;
+		uint64_t late_ns = slept_ns > wanted_ns ? slept_ns - wanted_ns : 0;
+
+		// Jumps up to a late wake up at once, then eases back down by 1% a frame
+		uint64_t spin_ns = std::max(late_ns + late_ns / 4, m_spin_ns - m_spin_ns / 100);
+		m_spin_ns = std::min(std::max(spin_ns, MIN_SPIN_NS), m_frame_ns);
+	}
+
+	while (profiler_now_ns() < deadline_ns)
+		std::this_thread::yield();
+}
+
+void FramePacer::wait_for_next_frame()
+{
+	if (m_mode != PRESENT_CAPPED)
+		return;
+
+	// The first frame, or one so late the next is due too, starts a new cadence
+	// instead of rushing frames out to catch up
+	uint64_t now = profiler_now_ns();
+	if (m_next_frame_ns == 0 || now >= m_next_frame_ns + m_frame_ns)
+		m_next_frame_ns = now;
+	else
+		sleep_until(m_next_frame_ns);
+	m_next_frame_ns += m_frame_ns;
+}
+
+void FramePacer::end_frame()
+{
+	uint64_t now = profiler_now_ns();
+	uint64_t last_swap_ns = m_last_swap_ns;
+	m_last_swap_ns = now;
+	if (last_swap_ns == 0)
+		return;
+
+	float ms = (now - last_swap_ns) / 1e6f;
+	m_last_interval_ms = ms;
+
+	m_recent[m_recent_next] = ms;
+	m_recent_next = (m_recent_next + 1) % RECENT_FRAMES;
+	if (m_recent_count < RECENT_FRAMES)
+		m_recent_count++;
+
+	m_total_frames++;
+	m_total_ms += ms;
+	m_total_squared_ms += (double)ms * ms;
+	m_total_max_ms = std::max(m_total_max_ms, ms);
+	if (m_target_ms > 0.f && ms > m_target_ms * MISSED_FRAME_FACTOR)
+		m_total_missed++;
+	int bucket = (int)(ms / HISTOGRAM_MS_PER_BUCKET);
+	m_histogram[bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS]++;
+}
+
+FramePacingStats FramePacer::get_recent_stats() const
+{
+	FramePacingStats stats = { m_recent_count, m_target_ms, 0.f, 0.f, 0.f, 0.f, 0 };
+	if (m_recent_count == 0)
+		return stats;
+
+	// On the stack, the HUD asks every frame
+	float sorted[RECENT_FRAMES];
+	std::copy(m_recent, m_recent + m_recent_count, sorted);
+
+	double total = 0.0;
+	for (int i = 0; i < m_recent_count; i++)
+	{
+		total += sorted[i];
+		stats.max_ms = std::max(stats.max_ms, sorted[i]);
+		if (m_target_ms > 0.f && sorted[i] > m_target_ms * MISSED_FRAME_FACTOR)
+			stats.missed++;
+	}
+	stats.mean_ms = (float)(total / m_recent_count);
+
+	double variance = 0.0;
+	for (int i = 0; i < m_recent_count; i++)
+		variance += (sorted[i] - stats.mean_ms) * (sorted[i] - stats.mean_ms);
+	stats.jitter_ms = (float)sqrt(variance / m_recent_count);
+
+	int p99 = (int)(0.99f * (m_recent_count - 1) + 0.5f);
+	std::nth_element(sorted, sorted + p99, sorted + m_recent_count);
+	stats.p99_ms = sorted[p99];
+	return stats;
+}
+
+FramePacingStats FramePacer::get_total_stats() const
+{
+	FramePacingStats stats = { m_total_frames, m_target_ms, 0.f, 0.f, 0.f, m_total_max_ms, m_total_missed };
+	if (m_total_frames == 0)
+		return stats;
+
+	double mean = m_total_ms / m_total_frames;
+	stats.mean_ms = (float)mean;
+	stats.jitter_ms = (float)sqrt(std::max(0.0, m_total_squared_ms / m_total_frames - mean * mean));
+
+	// Upper edge of the bucket holding the 99th percentile
+	int rank = (int)(0.99 * (m_total_frames - 1)) + 1;
+	int seen = 0;
+	for (int i = 0; i <= HISTOGRAM_BUCKETS; i++)
+	{
+		seen += m_histogram[i];
+		if (seen >= rank)
+		{
+			stats.p99_ms = i < HISTOGRAM_BUCKETS ? (i + 1) * HISTOGRAM_MS_PER_BUCKET : m_total_max_ms;
+			break;
+		}
+	}
+	return stats;
+}
+
+void FramePacer::report(FILE* file) const
+{
+	FramePacingStats stats = get_total_stats();
+	fprintf(file, "Frame pacing (%s", get_mode_name(m_mode));
+	if (stats.target_ms > 0.f)
+		fprintf(file, ", target %.2f ms", stats.target_ms);
+	fprintf(file, ") over %d frames: mean %.2f ms, jitter %.2f ms, p99 %.2f ms, max %.2f ms, %d missed\n",
+		stats.frames, stats.mean_ms, stats.jitter_ms, stats.p99_ms, stats.max_ms, stats.missed);
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <cstdint>
+#include <cstdio>
+
+// How finished frames reach the screen
+enum PresentMode
+{
+	// Swaps wait for the vertical blank
+	PRESENT_VSYNC,
+	// Vsync, but a frame that misses the blank swaps right away and tears instead of
+	// waiting a whole refresh (EXT_swap_control_tear)
+	PRESENT_ADAPTIVE,
+	// No waiting at all, for benchmarks
+	PRESENT_UNCAPPED,
+	// No vsync, frames are held back to a fixed rate by sleeping, then spinning
+	PRESENT_CAPPED
+};
+
+// Intervals between two buffer swaps
+struct FramePacingStats
+{
+	int frames;
+	float target_ms; // 0 when there is none, e.g. uncapped
+	float mean_ms;
+	float jitter_ms; // standard deviation of the intervals
+	float p99_ms;
+	float max_ms;
+	int missed; // intervals over 1.5x the target
+};
+
+// Applies the present mode and measures how evenly frames come out of it
+class FramePacer
+{
+public:
+	// Intervals behind get_recent_stats(), ten seconds at 60 fps
+	static const int RECENT_FRAMES = 600;
+
+	// "vsync", "adaptive", "uncapped" or "capped"
+	static bool parse_mode(const char* name, PresentMode& mode);
+	static const char* get_mode_name(PresentMode mode);
+
+	// Sets the swap interval, needs the window's context current. The refresh rate is
+	// the target of the vsync modes, 0 if unknown
+	void init(PresentMode mode, float cap_fps, int refresh_rate);
+
+	// Capped mode: returns once the next frame is due. Called before input is polled,
+	// so the wait does not sit between input and the frame showing it
+	void wait_for_next_frame();
+	// Call right after the swap
+	void end_frame();
+
+	PresentMode get_mode() const { return m_mode; }
+	float get_last_interval_ms() const { return m_last_interval_ms; }
+	FramePacingStats get_recent_stats() const;
+	FramePacingStats get_total_stats() const;
+
+	// One line with the stats of the whole run
+	void report(FILE* file) const;
+
+private:
+	// The p99 of the whole run comes from a histogram of 0.05 ms buckets, up to 100 ms
+	static const int HISTOGRAM_BUCKETS = 2000;
+
+	void sleep_until(uint64_t deadline_ns);
+
+	PresentMode m_mode = PRESENT_VSYNC;
+	float m_target_ms = 0.f;
+	uint64_t m_frame_ns = 0; // capped only
+	uint64_t m_next_frame_ns = 0;
+	// Sleeps wake up late by up to a scheduler tick, this much of each wait is spun
+	// instead. Follows the lateness seen
+	uint64_t m_spin_ns = 0;
+
+	uint64_t m_last_swap_ns = 0;
+	float m_last_interval_ms = 0.f;
+
+	float m_recent[RECENT_FRAMES] = {};
+	int m_recent_next = 0;
+	int m_recent_count = 0;
+
+	int m_total_frames = 0;
+	double m_total_ms = 0.0;
+	double m_total_squared_ms = 0.0;
+	float m_total_max_ms = 0.f;
+	int m_total_missed = 0;
+	int m_histogram[HISTOGRAM_BUCKETS + 1] = {}; // the last bucket holds everything longer
+};
@@ -0,0 +1,300 @@
+// Header
+#include "goldenFrames.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Every replay starts from this seed, see set_random_seed()
+	const unsigned GOLDEN_RANDOM_SEED = 1234;
+
+	struct Image
+	{
+		int width = 0;
+		int height = 0;
+		std::vector<unsigned char> rgb;
+
+		const unsigned char* pixel(int x, int y) const { return &rgb[((size_t)y * width + x) * 3]; }
+		unsigned char* pixel(int x, int y) { return &rgb[((size_t)y * width + x) * 3]; }
+	};
+
+	// Ticks to capture of one replay, in the order the replays appear in frames.txt
+	struct GoldenReplay
+	{
+		std::string name;
+		std::vector<int> ticks; // sorted
+	};
+
+	// One line per capture: <replay> <tick>, lines starting with # are comments
+	std::vector<GoldenReplay> load_frame_list(const char* path)
+	{
+		std::vector<GoldenReplay> replays;
+		std::ifstream file(path);
+		if (!file)
+		{
+			fprintf(stderr, "Failed to open %s\n", path);
+			return replays;
+		}
+
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#')
+				continue;
+			std::istringstream fields(line);
+			std::string name;
+			int tick;
+			if (!(fields >> name >> tick) || tick < 0)
+			{
+				fprintf(stderr, "Skipping malformed golden frame line: %s\n", line.c_str());
+				continue;
+			}
+
+			auto it = std::find_if(replays.begin(), replays.end(), [&](const GoldenReplay& r) { return r.name == name; });
+			if (it == replays.end())
+				it = replays.insert(replays.end(), { name, {} });
+			it->ticks.push_back(tick);
+		}
+
+		for (GoldenReplay& replay : replays)
+			std::sort(replay.ticks.begin(), replay.ticks.end());
+		return replays;
+	}
+
+	// Binary PPM, which any image viewer opens and needs no encoder
+	bool save_ppm(const std::string& path, const Image& image)
+	{
+		FILE* file = fopen(path.c_str(), "wb");
+		if (file == nullptr)
+		{
+			fprintf(stderr, "Failed to open %s for writing\n", path.c_str());
+			return false;
+		}
+		fprintf(file, "P6\n%d %d\n255\n", image.width, image.height);
+		fwrite(image.rgb.data(), 1, image.rgb.size(), file);
+		bool ok = ferror(file) == 0;
+		fclose(file);
+		return ok;
+	}
+
+	bool load_ppm(const std::string& path, Image& image)
+	{
+		FILE* file = fopen(path.c_str(), "rb");
+		if (file == nullptr)
+			return false;
+
+		int max_value = 0;
+		bool ok = fscanf(file, "P6 %d %d %d", &image.width, &image.height, &max_value) == 3 &&
+			max_value == 255 && image.width > 0 && image.height > 0 && fgetc(file) != EOF;
+		if (ok)
+		{
+			image.rgb.resize((size_t)image.width * image.height * 3);
+			ok = fread(image.rgb.data(), 1, image.rgb.size(), file) == image.rgb.size();
+		}
+		fclose(file);
+		if (!ok)
+			fprintf(stderr, "%s is not a binary 8 bit PPM\n", path.c_str());
+		return ok;
+	}
+
+	// Weighted by how sensitive eyes are to each channel, green the most
+	float perceived_distance(const unsigned char* a, const unsigned char* b)
+	{
+		float dr = (float)a[0] - b[0];
+		float dg = (float)a[1] - b[1];
+		float db = (float)a[2] - b[2];
+		return sqrtf(0.299f * dr * dr + 0.587f * dg * dg + 0.114f * db * db);
+	}
+
+	bool matches_near(const Image& expected, int x, int y, const unsigned char* actual, float threshold)
+	{
+		for (int ny = std::max(y - 1, 0); ny <= std::min(y + 1, expected.height - 1); ny++)
+		{
+			for (int nx = std::max(x - 1, 0); nx <= std::min(x + 1, expected.width - 1); nx++)
+			{
+				if (perceived_distance(expected.pixel(nx, ny), actual) <= threshold)
+					return true;
+			}
+		}
+		return false;
+	}
+
+	// Differing pixels in red over a faded copy of the reference
+	int compare(const Image& actual, const Image& expected, float threshold, Image& diff)
+	{
+		diff = expected;
+		int differing = 0;
+		for (int y = 0; y < expected.height; y++)
+		{
+			for (int x = 0; x < expected.width; x++)
+			{
+				unsigned char* out = diff.pixel(x, y);
+				if (matches_near(expected, x, y, actual.pixel(x, y), threshold))
+				{
+					unsigned char faded = (unsigned char)(170 + (out[0] * 0.299f + out[1] * 0.587f + out[2] * 0.114f) / 3.f);
+					out[0] = out[1] = out[2] = faded;
+					continue;
+				}
+				out[0] = 255;
+				out[1] = 0;
+				out[2] = 0;
+				differing++;
+			}
+		}
+		return differing;
+	}
+
+	bool capture(World& world, Image& image)
+	{
+		std::vector<unsigned char> rgba;
+		if (!world.read_frame(rgba, image.width, image.height))
+		{
+			fprintf(stderr, "Failed to read back the frame, is the world offscreen?\n");
+			return false;
+		}
+
+		// Alpha is left out, the post passes do not keep it meaningful
+		image.rgb.resize((size_t)image.width * image.height * 3);
+		for (size_t i = 0, count = (size_t)image.width * image.height; i < count; i++)
+		{
+			image.rgb[i * 3 + 0] = rgba[i * 4 + 0];
+			image.rgb[i * 3 + 1] = rgba[i * 4 + 1];
+			image.rgb[i * 3 + 2] = rgba[i * 4 + 2];
+		}
+		return true;
+	}
+
+	// Frames compared and frames without a reference, over all replays
+	struct GoldenCounts
+	{
+		int checked = 0;
+		int skipped = 0;
+	};
+
+	bool check(const std::string& name, const Image& actual, const GoldenOptions& options, GoldenCounts& counts)
+	{
+		std::string base = golden_path("") + name;
+		Image expected;
+		if (!load_ppm(base + ".ppm", expected))
+		{
+			// References are recorded per machine and not part of the checkout
+			fprintf(stderr, "SKIP %s: no reference, record one with --golden-update\n", name.c_str());
+			counts.skipped++;
+			return true;
+		}
+		counts.checked++;
+		if (expected.width != actual.width || expected.height != actual.height)
+		{
+			fprintf(stderr, "MISMATCH %s: frame is %dx%d, reference %dx%d\n", name.c_str(),
+				actual.width, actual.height, expected.width, expected.height);
+			return false;
+		}
+
+		Image diff;
+		int differing = compare(actual, expected, options.pixel_threshold, diff);
+		float fraction = (float)differing / ((float)expected.width * expected.height);
+		if (fraction <= options.max_diff_fraction)
+		{
+			fprintf(stderr, "%-24s ok, %d pixels differ\n", name.c_str(), differing);
+			return true;
+		}
+
+		// Left next to the reference for a look, they are ignored by git
+		save_ppm(base + ".actual.ppm", actual);
+		save_ppm(base + ".diff.ppm", diff);
+		fprintf(stderr, "MISMATCH %s: %d pixels (%.3f%%) differ, see %s.diff.ppm\n", name.c_str(),
+			differing, fraction * 100.f, base.c_str());
+		return false;
+	}
+
+	// Plays the whole replay even past its last capture, so the state it leaves for the
+	// next replay does not depend on which ticks are listed
+	bool play(World& world, const GoldenReplay& golden, const GoldenOptions& options, GoldenCounts& counts)
+	{
+		Replay replay;
+		if (!replay.load_from_file((replays_path("") + golden.name + ".replay").c_str()))
+			return false;
+
+		set_random_seed(GOLDEN_RANDOM_SEED);
+		world.set_paused(false);
+		world.set_mode(MENU);
+
+		bool ok = true;
+		size_t next_event = 0;
+		size_t next_tick = 0;
+		for (int frame = 0; frame < replay.frame_count && !world.is_over(); frame++)
+		{
+			// Animations and stage effects read the GLFW clock, it follows the replay instead of real time
+			glfwSetTime(frame * replay.frame_ms / 1000.0);
+
+			for (; next_event < replay.events.size() && replay.events[next_event].frame == frame; next_event++)
+			{
+				const ReplayEvent& event = replay.events[next_event];
+				world.inject_key(event.key, event.action, event.mods);
+			}
+
+			world.update(replay.frame_ms);
+			world.draw();
+
+			if (next_tick == golden.ticks.size() || golden.ticks[next_tick] != frame)
+				continue;
+			while (next_tick < golden.ticks.size() && golden.ticks[next_tick] == frame)
+				next_tick++;
+
+			std::string name = golden.name + "_" + std::to_string(frame);
+			Image image;
+			if (!capture(world, image))
+				return false;
+			if (options.update)
+			{
+				ok = save_ppm(golden_path("") + name + ".ppm", image) && ok;
+				continue;
+			}
+			ok = check(name, image, options, counts) && ok;
+		}
+
+		if (next_tick < golden.ticks.size())
+		{
+			fprintf(stderr, "%s ended before tick %d\n", golden.name.c_str(), golden.ticks[next_tick]);
+			return false;
+		}
+		return ok;
+	}
+}
+
+int run_golden_frames(World& world, const GoldenOptions& options)
+{
+	const char* list_path = golden_path("frames.txt");
+	std::vector<GoldenReplay> replays = load_frame_list(list_path);
+	if (replays.empty())
+		return EXIT_FAILURE;
+
+	bool ok = true;
+	GoldenCounts counts;
+	for (const GoldenReplay& replay : replays)
+		ok = play(world, replay, options, counts) && ok;
+
+	// Back to random seeds for whatever runs next
+	set_random_seed(0);
+
+	if (options.update)
+	{
+		if (ok)
+			fprintf(stderr, "Wrote the references listed in %s\n", list_path);
+		return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
+	fprintf(stderr, "%d frames checked, %d skipped without a reference\n", counts.checked, counts.skipped);
+	// A run that compared nothing would pass on any tree
+	if (counts.checked == 0)
+	{
+		fprintf(stderr, "No golden references found, record them with --golden-update\n");
+		return EXIT_FAILURE;
+	}
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
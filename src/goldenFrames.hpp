@@ -0,0 +1,30 @@
+#pragma once
+
+#include "world.hpp"
+
+// Render verification: plays the replays listed in data/golden/frames.txt through an
+// offscreen world with a fixed random seed and clock, reads back the frame at each
+// listed tick and compares it with data/golden/<replay>_<tick>.ppm.
+//
+// The comparison is meant to survive driver and rasterizer differences: a pixel only
+// counts as different when no pixel in the 3x3 neighbourhood of the reference is
+// within the threshold, so edges that moved by a pixel still match.
+//
+// The references are not committed: the frames depend on the GL implementation and
+// data/textures/mainMenu.jpg is not part of the repository. Record them once on the
+// machine running the check with --golden-update, from a tree known to draw correctly.
+// A listed frame without a reference is reported as skipped, but a run that finds no
+// reference at all fails: it has checked nothing.
+
+struct GoldenOptions
+{
+	// Largest luma weighted color distance (0-255) between matching pixels
+	float pixel_threshold = 16.f;
+	// Share of the pixels that may differ before a frame fails
+	float max_diff_fraction = 0.001f;
+	// Writes the captured frames as the new references instead of comparing
+	bool update = false;
+};
+
+// Expects a world initialized with set_offscreen(true), returns the process exit code
+int run_golden_frames(World& world, const GoldenOptions& options);
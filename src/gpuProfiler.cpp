@@ -0,0 +1,169 @@
+// Header
+#include "gpuProfiler.hpp"
+#include "profiler.hpp"
+
+namespace
+{
+	const int BUFFERED_FRAMES = 2;
+	const int MAX_ZONES = 32; // per frame, later zones are dropped
+	// Frames between two GPU to CPU clock calibrations
+	const int CALIBRATION_INTERVAL = 600;
+
+	struct FrameQueries
+	{
+		GLuint queries[MAX_ZONES * 2]; // begin and end timestamp of each zone
+		const char* names[MAX_ZONES];
+		int depths[MAX_ZONES];
+		int count;
+		GLuint last_query; // issued last, its result comes back last
+		bool pending; // issued, results not read yet
+		int64_t gpu_to_cpu_ns; // clock offset when the frame was issued
+	};
+
+	bool g_enabled = false;
+	FrameQueries g_frames[BUFFERED_FRAMES];
+	int g_frame = 0;
+	int g_depth = 0;
+	bool g_in_frame = false;
+	int64_t g_gpu_to_cpu_ns = 0;
+	std::vector<GpuZoneTiming> g_results;
+
+	FrameQueries& current_frame()
+	{
+		return g_frames[g_frame % BUFFERED_FRAMES];
+	}
+
+	void calibrate()
+	{
+		GLint64 gpu_now = 0;
+		glGetInteger64v(GL_TIMESTAMP, &gpu_now);
+		g_gpu_to_cpu_ns = (int64_t)profiler_now_ns() - (int64_t)gpu_now;
+	}
+
+	// Reads a finished frame, false when the GPU is not done with it yet
+	bool collect(FrameQueries& frame)
+	{
+		if (frame.count == 0)
+			return true;
+
+		GLint available = 0;
+		glGetQueryObjectiv(frame.last_query, GL_QUERY_RESULT_AVAILABLE, &available);
+		if (!available)
+			return false;
+
+		g_results.clear();
+		for (int i = 0; i < frame.count; i++)
+		{
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+			float ms = end > begin ? (float)((end - begin) / 1e6) : 0.f;
+			g_results.push_back({ frame.names[i], frame.depths[i], ms });
+
+			if (profiler_is_enabled() && end > begin)
+				profiler_record_zone("GPU", frame.names[i], (uint64_t)((int64_t)begin + frame.gpu_to_cpu_ns), end - begin);
+		}
+		return true;
+	}
+}
+
+bool gpu_profiler_init()
+{
+	gl_flush_errors();
+	for (FrameQueries& frame : g_frames)
+	{
+		glGenQueries(MAX_ZONES * 2, frame.queries);
+		frame.count = 0;
+		frame.pending = false;
+	}
+	if (gl_has_errors())
+	{
+		fprintf(stderr, "Failed to create GPU timer queries\n");
+		return false;
+	}
+
+	calibrate();
+	g_frame = 0;
+	g_enabled = true;
+	return true;
+}
+
+void gpu_profiler_destroy()
+{
+	if (!g_enabled)
+		return;
+
+	for (FrameQueries& frame : g_frames)
+		glDeleteQueries(MAX_ZONES * 2, frame.queries);
+	g_results.clear();
+	g_enabled = false;
+}
+
+bool gpu_profiler_is_enabled()
+{
+	return g_enabled;
+}
+
+void gpu_profiler_begin_frame()
+{
+	if (!g_enabled)
+		return;
+
+	if (g_frame % CALIBRATION_INTERVAL == 0)
+		calibrate();
+
+	// The frame that last used these queries had a whole frame to finish, if it has
+	// not its results are dropped and the queries reused
+	FrameQueries& frame = current_frame();
+	if (frame.pending)
+		collect(frame);
+
+	frame.count = 0;
+	frame.pending = false;
+	frame.gpu_to_cpu_ns = g_gpu_to_cpu_ns;
+	g_depth = 0;
+	g_in_frame = true;
+}
+
+void gpu_profiler_end_frame()
+{
+	if (!g_enabled || !g_in_frame)
+		return;
+
+	current_frame().pending = true;
+	g_in_frame = false;
+	g_frame++;
+}
+
+const std::vector<GpuZoneTiming>& gpu_profiler_results()
+{
+	return g_results;
+}
+
+GpuProfileZone::GpuProfileZone(const char* name)
+{
+	m_zone = -1;
+	if (!g_in_frame)
+		return;
+
+	FrameQueries& frame = current_frame();
+	if (frame.count >= MAX_ZONES)
+		return;
+
+	m_zone = frame.count++;
+	frame.names[m_zone] = name;
+	frame.depths[m_zone] = g_depth++;
+	frame.last_query = frame.queries[m_zone * 2];
+	glQueryCounter(frame.last_query, GL_TIMESTAMP);
+}
+
+GpuProfileZone::~GpuProfileZone()
+{
+	if (m_zone < 0)
+		return;
+
+	FrameQueries& frame = current_frame();
+	frame.last_query = frame.queries[m_zone * 2 + 1];
+	glQueryCounter(frame.last_query, GL_TIMESTAMP);
+	g_depth--;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include "common.hpp"
+
+#include <vector>
+
+// GPU time of render passes, measured with GL_TIMESTAMP query pairs. Queries are double
+// buffered per frame, results come back one frame late and are only read once the GPU
+// has them, a frame whose results are not ready yet is skipped instead of waited on.
+// Timestamps rather than GL_TIME_ELAPSED so zones can nest and overlap the dynamic
+// resolution frame query.
+//
+//   {
+//       GPU_PROFILE_ZONE("particles");
+//       ... draw calls ...
+//   }
+//
+// Zones are free while the GPU profiler is not initialized. Finished zones are also
+// recorded on the "GPU" track of the CPU profiler when that is enabled.
+
+struct GpuZoneTiming
+{
+	const char* name;
+	int depth; // nesting level, 0 for the outermost zones
+	float ms;
+};
+
+bool gpu_profiler_init();
+void gpu_profiler_destroy();
+bool gpu_profiler_is_enabled();
+
+// Bracket the GPU work of a frame, begin also collects the previous frame if it is ready
+void gpu_profiler_begin_frame();
+void gpu_profiler_end_frame();
+
+// Zones of the latest frame whose results are back, in the order they began
+const std::vector<GpuZoneTiming>& gpu_profiler_results();
+
+// Records the surrounding scope as a GPU zone, name has to be a literal
+class GpuProfileZone
+{
+public:
+	explicit GpuProfileZone(const char* name);
+	~GpuProfileZone();
+
+private:
+	int m_zone; // -1 when not recorded
+};
+
+#define GPU_PROFILE_ZONE_CONCAT_(a, b) a##b
+#define GPU_PROFILE_ZONE_CONCAT(a, b) GPU_PROFILE_ZONE_CONCAT_(a, b)
+#define GPU_PROFILE_ZONE(name) GpuProfileZone GPU_PROFILE_ZONE_CONCAT(gpu_profile_zone_, __LINE__)(name)
@@ -0,0 +1,54 @@
+// Header
+#include "hotReload.hpp"
+#include "shaderCache.hpp"
+
+#include <cstdio>
+
+bool HotReload::init()
+{
+	// Paths are reported as the directory + file name, the same strings the game
+	// loaded them with
+	return m_watcher.init() &&
+		m_watcher.watch(shader_path("")) &&
+		m_watcher.watch(textures_path("")) &&
+		m_watcher.watch(fighters_path(""));
+}
+
+void HotReload::destroy()
+{
+	m_watcher.destroy();
+	m_changed.clear();
+}
+
+bool HotReload::poll()
+{
+	m_watcher.poll(m_changed);
+	return !m_changed.empty();
+}
+
+const FighterDefinitionFile* HotReload::reload()
+{
+	const FighterDefinitionFile* definitions = nullptr;
+	for (const std::string& path : m_changed)
+	{
+		if (path == fighters_path("fighters.txt"))
+		{
+			// Read in full before anything is replaced, a file with errors changes nothing
+			if (read_fighter_definitions(path.c_str(), m_definitions))
+			{
+				definitions = &m_definitions;
+				fprintf(stderr, "Reloaded %s\n", path.c_str());
+			}
+			continue;
+		}
+
+		int programs = shader_cache_reload(path);
+		int textures = reload_texture_file(path);
+		if (programs > 0)
+			fprintf(stderr, "Reloaded %s, %d programs\n", path.c_str(), programs);
+		if (textures > 0)
+			fprintf(stderr, "Reloaded %s, %d textures\n", path.c_str(), textures);
+	}
+	m_changed.clear();
+	return definitions;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "fileWatcher.hpp"
+#include "fighterDefinition.hpp"
+
+#include <string>
+#include <vector>
+
+// Reloads the shaders, textures and fighter definitions written while the game runs.
+//
+// poll() only reads the watcher, so the simulation can check every tick at the cost of
+// one non-blocking read. The reload itself makes GL calls and changes data both threads
+// read, World runs it through SimThread::run_on_render_thread() between two frames,
+// with the simulation waiting. GL objects keep their names, so the fighters, the render
+// queue and the snapshots holding copies of them carry on as if nothing happened.
+class HotReload
+{
+public:
+	// Watches the shader, texture and fighter directories. False when files cannot be watched
+	bool init();
+	void destroy();
+
+	// True when files changed since the last reload()
+	bool poll();
+
+	// Reloads the changed files, needs the GL context. Returns the new fighter
+	// definitions when their file changed and reads without errors, nullptr otherwise.
+	// A shader or definitions file with errors is reported and the old one kept
+	const FighterDefinitionFile* reload();
+
+private:
+	FileWatcher m_watcher;
+	std::vector<std::string> m_changed;
+	FighterDefinitionFile m_definitions;
+};
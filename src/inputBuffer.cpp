@@ -0,0 +1,44 @@
+// Header
+#include "inputBuffer.hpp"
+
+void InputBuffer::push(int movement, float time_ms, bool released)
+{
+	for (int i = 0; i < m_count && !released; i++)
+	{
+		if (at(i).movement == movement && !at(i).released)
+			return;
+	}
+
+	if (m_count == CAPACITY)
+	{
+		m_head = (m_head + 1) % CAPACITY;
+		m_count--;
+	}
+	m_inputs[(m_head + m_count) % CAPACITY] = { movement, time_ms, released };
+	m_count++;
+}
+
+void InputBuffer::release(int movement)
+{
+	for (int i = 0; i < m_count; i++)
+	{
+		if (at(i).movement == movement)
+			at(i).released = true;
+	}
+}
+
+void InputBuffer::expire(float now_ms)
+{
+	// Only the front needs checking, the presses are in time order
+	while (m_count > 0 && (at(0).movement < 0 || now_ms - at(0).time_ms > m_window_ms))
+	{
+		m_head = (m_head + 1) % CAPACITY;
+		m_count--;
+	}
+}
+
+void InputBuffer::clear()
+{
+	m_head = 0;
+	m_count = 0;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+// A press the fighter could not act on yet, e.g. a punch still on cooldown
+struct BufferedInput
+{
+	int movement; // FighterMovementState of the press
+	float time_ms; // fighter time of the press
+	bool released; // the key went up before the press could be acted on
+};
+
+// Presses that came a little too early, kept for a short window so they still happen
+// on the first tick the fighter can act on them instead of being dropped. Times are
+// the fighter's simulation time, so the window is the same at any frame rate.
+class InputBuffer
+{
+public:
+	// Oldest presses are overwritten past this
+	static const int CAPACITY = 8;
+
+	void set_window_ms(float window_ms) { m_window_ms = window_ms; }
+	float get_window_ms() const { return m_window_ms; }
+
+	// A press already waiting and not released is not added twice
+	void push(int movement, float time_ms, bool released = false);
+	// Marks the waiting presses of movement as released
+	void release(int movement);
+	// Drops presses that waited longer than the window
+	void expire(float now_ms);
+
+	// Waiting presses, oldest first. Removed ones are skipped by the next expire()
+	int size() const { return m_count; }
+	BufferedInput& at(int i) { return m_inputs[(m_head + i) % CAPACITY]; }
+	void remove(int i) { at(i).movement = -1; }
+
+	void clear();
+
+private:
+	BufferedInput m_inputs[CAPACITY];
+	int m_head = 0;
+	int m_count = 0;
+	float m_window_ms = 0.f;
+};
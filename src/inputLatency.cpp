@@ -0,0 +1,94 @@
+// Header
+#include "inputLatency.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	const float MS_PER_BUCKET = 1.f;
+	const int BAR_WIDTH = 50; // characters of the longest bar
+}
+
+void InputLatency::add_input(uint64_t input_ns, uint64_t tick)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_pending_count < MAX_PENDING)
+		m_pending[m_pending_count++] = { input_ns, tick };
+}
+
+void InputLatency::add_presented_frame(uint64_t present_ns, uint64_t tick)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	int still_pending = 0;
+	for (int i = 0; i < m_pending_count; i++)
+	{
+		const PendingInput& input = m_pending[i];
+		if (input.tick > tick)
+		{
+			m_pending[still_pending++] = input;
+			continue;
+		}
+		float ms = present_ns > input.input_ns ? (present_ns - input.input_ns) / 1e6f : 0.f;
+		int bucket = (int)(ms / MS_PER_BUCKET);
+		m_buckets[bucket < BUCKETS ? bucket : BUCKETS]++;
+		m_count++;
+		m_total_ms += ms;
+		m_max_ms = std::max(m_max_ms, ms);
+	}
+	m_pending_count = still_pending;
+}
+
+int InputLatency::get_count() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_count;
+}
+
+float InputLatency::get_percentile_ms(float fraction) const
+{
+	if (m_count == 0)
+		return 0.f;
+
+	int rank = (int)(fraction * (m_count - 1)) + 1;
+	int seen = 0;
+	for (int i = 0; i < BUCKETS; i++)
+	{
+		seen += m_buckets[i];
+		if (seen >= rank)
+			return (i + 1) * MS_PER_BUCKET;
+	}
+	return m_max_ms;
+}
+
+void InputLatency::report(FILE* file) const
+{
+	if (m_count == 0)
+	{
+		fprintf(file, "Input latency: no key presses measured\n");
+		return;
+	}
+
+	fprintf(file, "Input latency over %d key presses: mean %.1f ms, p50 %.0f ms, p95 %.0f ms, p99 %.0f ms, max %.1f ms\n",
+		m_count, m_total_ms / m_count, get_percentile_ms(0.5f), get_percentile_ms(0.95f), get_percentile_ms(0.99f), m_max_ms);
+
+	// Only the range that has samples
+	int first = 0;
+	while (m_buckets[first] == 0)
+		first++;
+	int last = BUCKETS;
+	while (m_buckets[last] == 0)
+		last--;
+	int most = *std::max_element(m_buckets, m_buckets + BUCKETS + 1);
+
+	for (int i = first; i <= last; i++)
+	{
+		char bar[BAR_WIDTH + 1];
+		int length = (m_buckets[i] * BAR_WIDTH + most - 1) / most;
+		std::fill(bar, bar + length, '#');
+		bar[length] = '\0';
+		if (i < BUCKETS)
+			fprintf(file, "  %3.0f-%3.0f ms %6d %s\n", i * MS_PER_BUCKET, (i + 1) * MS_PER_BUCKET, m_buckets[i], bar);
+		else
+			fprintf(file, "  %3.0f+    ms %6d %s\n", i * MS_PER_BUCKET, m_buckets[i], bar);
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+// Measures input lag: from a key press arriving to the end of the buffer swap of the
+// first frame drawn after the tick that handled it, which is the first frame showing
+// its effect.
+//
+// GLFW does not pass on the time the OS received an event, the start is when
+// glfwPollEvents() delivered it. Time an event spends waiting for the poll is not
+// counted.
+//
+// With the simulation on its own thread the press is closed by the first frame drawn
+// from a snapshot of the tick that handled it or a later one.
+class InputLatency
+{
+public:
+	// 1 ms each, the last one also holds everything longer
+	static const int BUCKETS = 100;
+
+	void set_enabled(bool enabled) { m_enabled = enabled; }
+	bool is_enabled() const { return m_enabled; }
+
+	// A press handled by the given tick, arrived at input_ns
+	void add_input(uint64_t input_ns, uint64_t tick = 0);
+	// Call once the swap of a frame has completed, closes every input handled up to
+	// the tick the frame was drawn from
+	void add_presented_frame(uint64_t present_ns, uint64_t tick = UINT64_MAX);
+
+	int get_count() const;
+	// Upper edge of the bucket holding this fraction of the samples, in ms
+	float get_percentile_ms(float fraction) const;
+
+	// Percentiles and the histogram as text bars
+	void report(FILE* file) const;
+
+private:
+	// Presses per frame beyond this go unmeasured
+	static const int MAX_PENDING = 32;
+
+	struct PendingInput
+	{
+		uint64_t input_ns;
+		uint64_t tick;
+	};
+
+	mutable std::mutex m_mutex;
+	bool m_enabled = false;
+	PendingInput m_pending[MAX_PENDING] = {};
+	int m_pending_count = 0;
+
+	int m_buckets[BUCKETS + 1] = {};
+	int m_count = 0;
+	double m_total_ms = 0.0;
+	float m_max_ms = 0.f;
+};
@@ -0,0 +1,39 @@
+// Header
+#include "inputQueue.hpp"
+
+#include <algorithm>
+
+void InputQueue::push(const InputEvent& event)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_events.push_back(event);
+}
+
+const std::vector<InputEvent>& InputQueue::take_events()
+{
+	m_taken.clear();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_taken.swap(m_events);
+	}
+
+	// Events pushed from more than one source, e.g. the window and the pad thread,
+	// interleave by time. Same time keeps the push order
+	auto earlier = [](const InputEvent& a, const InputEvent& b) { return a.time_ns < b.time_ns; };
+	if (!std::is_sorted(m_taken.begin(), m_taken.end(), earlier))
+		std::stable_sort(m_taken.begin(), m_taken.end(), earlier);
+	return m_taken;
+}
+
+bool InputQueue::empty() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_events.empty();
+}
+
+void InputQueue::clear()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_events.clear();
+	m_taken.clear();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Key event as GLFW delivered it, stamped on arrival with profiler_now_ns()
+struct InputEvent
+{
+	int key;
+	int scancode;
+	int action;
+	int mods;
+	uint64_t time_ns;
+};
+
+// Key events waiting for the next simulation tick. The window callback and the pad
+// thread only queue them, World::update() handles them all at the start of the tick,
+// so a key acts on the game at the same point of the frame however the poll lined up
+// with it. Safe to push from one thread while another takes, e.g. the window on the
+// render thread and the tick on the simulation thread.
+class InputQueue
+{
+public:
+	void push(const InputEvent& event);
+
+	// Moves the queued events out, oldest time stamp first. Events pushed while these
+	// are being handled stay queued for the next call
+	const std::vector<InputEvent>& take_events();
+
+	bool empty() const;
+	void clear();
+
+private:
+	mutable std::mutex m_mutex;
+	std::vector<InputEvent> m_events;
+	std::vector<InputEvent> m_taken; // kept to reuse its storage
+};
@@ -0,0 +1,215 @@
+// Header
+#include "inputThread.hpp"
+#include "common.hpp"
+#include "profiler.hpp"
+
+#include <chrono>
+
+namespace
+{
+	// Keys each player's pad stands in for, the same the keyboard controls use
+	const int PAD_KEYS[InputThread::MAX_PADS][InputThread::CONTROL_COUNT] = {
+		{ GLFW_KEY_D, GLFW_KEY_A, GLFW_KEY_W, GLFW_KEY_S, GLFW_KEY_C, GLFW_KEY_V, GLFW_KEY_B, GLFW_KEY_LEFT_SHIFT, GLFW_KEY_ENTER },
+		{ GLFW_KEY_RIGHT, GLFW_KEY_LEFT, GLFW_KEY_UP, GLFW_KEY_DOWN, GLFW_KEY_SLASH, GLFW_KEY_PERIOD, GLFW_KEY_COMMA, GLFW_KEY_RIGHT_SHIFT, GLFW_KEY_ENTER },
+	};
+
+	// Held controls repeat like keys at common OS settings, charged attacks wait for repeats
+	const uint64_t REPEAT_DELAY_NS = 500000000;
+	const uint64_t REPEAT_INTERVAL_NS = 33000000;
+
+	// The stick presses past the first and lets go under the second, so it does not
+	// chatter around a single threshold
+	const int STICK_PRESS = 16000;
+	const int STICK_RELEASE = 12000;
+
+	// How often pads plugged in later are looked for
+	const uint64_t RESCAN_NS = 500000000;
+
+	bool stick_down(int value, bool was_down)
+	{
+		return value > (was_down ? STICK_RELEASE : STICK_PRESS);
+	}
+}
+
+bool InputThread::start(int poll_hz)
+{
+	if (is_running() || poll_hz <= 0)
+		return false;
+
+	// Pads keep working while the window is unfocused, the main thread pumps no SDL
+	// events so they are read by polling alone
+	SDL_SetHint(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS, "1");
+	if (SDL_InitSubSystem(SDL_INIT_GAMECONTROLLER) < 0)
+	{
+		fprintf(stderr, "Failed to initialize SDL game controllers: %s\n", SDL_GetError());
+		return false;
+	}
+	SDL_GameControllerEventState(SDL_IGNORE);
+	SDL_JoystickEventState(SDL_IGNORE);
+
+	m_period_ns = 1000000000ull / poll_hz;
+	m_quit = false;
+	m_polls = 0;
+	m_sent = 0;
+	m_dropped = 0;
+	m_start_ns = profiler_now_ns();
+	m_stop_ns = 0;
+	m_thread = std::thread(&InputThread::run, this);
+	return true;
+}
+
+void InputThread::stop()
+{
+	if (!is_running())
+		return;
+	m_quit = true;
+	m_thread.join();
+	SDL_QuitSubSystem(SDL_INIT_GAMECONTROLLER);
+}
+
+void InputThread::report(FILE* file) const
+{
+	uint64_t stop_ns = m_stop_ns != 0 ? m_stop_ns.load() : profiler_now_ns();
+	double seconds = (stop_ns - m_start_ns) / 1e9;
+	fprintf(file, "Input thread: %llu polls at %.0f Hz, %llu pad events, %llu dropped\n",
+		(unsigned long long)m_polls, seconds > 0.0 ? m_polls / seconds : 0.0,
+		(unsigned long long)m_sent, (unsigned long long)m_dropped);
+}
+
+void InputThread::run()
+{
+	profiler_set_thread_name("input");
+
+	uint64_t next_poll_ns = profiler_now_ns();
+	uint64_t next_rescan_ns = 0;
+	while (!m_quit)
+	{
+		uint64_t now = profiler_now_ns();
+		{
+			PROFILE_ZONE("InputThread::poll");
+
+			SDL_GameControllerUpdate();
+			if (now >= next_rescan_ns)
+			{
+				open_new_pads();
+				next_rescan_ns = now + RESCAN_NS;
+			}
+			for (int player = 0; player < MAX_PADS; player++)
+			{
+				if (m_pads[player].controller != nullptr)
+					poll_pad(m_pads[player], player, now);
+			}
+		}
+		m_polls++;
+
+		// Fixed cadence, a late poll does not make the next ones come early
+		next_poll_ns += m_period_ns;
+		now = profiler_now_ns();
+		if (next_poll_ns <= now)
+			next_poll_ns = now + m_period_ns;
+		std::this_thread::sleep_for(std::chrono::nanoseconds(next_poll_ns - now));
+	}
+
+	// Whatever is still held lets go, nothing stays stuck once the pads are gone
+	uint64_t now = profiler_now_ns();
+	for (int player = 0; player < MAX_PADS; player++)
+	{
+		if (m_pads[player].controller != nullptr)
+			close_pad(m_pads[player], player, now);
+	}
+	m_stop_ns = now;
+}
+
+void InputThread::open_new_pads()
+{
+	for (int i = 0; i < SDL_NumJoysticks(); i++)
+	{
+		if (!SDL_IsGameController(i))
+			continue;
+
+		SDL_JoystickID id = SDL_JoystickGetDeviceInstanceID(i);
+		int free_slot = -1;
+		bool open = false;
+		for (int player = MAX_PADS - 1; player >= 0; player--)
+		{
+			if (m_pads[player].controller == nullptr)
+				free_slot = player;
+			else if (m_pads[player].id == id)
+				open = true;
+		}
+		if (open || free_slot < 0)
+			continue;
+
+		SDL_GameController* controller = SDL_GameControllerOpen(i);
+		if (controller == nullptr)
+		{
+			fprintf(stderr, "Failed to open game controller %d: %s\n", i, SDL_GetError());
+			continue;
+		}
+		Pad& pad = m_pads[free_slot];
+		pad = Pad();
+		pad.controller = controller;
+		pad.id = SDL_JoystickInstanceID(SDL_GameControllerGetJoystick(controller));
+		fprintf(stderr, "%s plays as player %d\n", SDL_GameControllerName(controller), free_slot + 1);
+	}
+}
+
+void InputThread::close_pad(Pad& pad, int player, uint64_t now)
+{
+	for (int control = 0; control < CONTROL_COUNT; control++)
+	{
+		if (pad.down[control])
+			send(player, (Control)control, GLFW_RELEASE, now);
+	}
+	SDL_GameControllerClose(pad.controller);
+	pad = Pad();
+}
+
+void InputThread::poll_pad(Pad& pad, int player, uint64_t now)
+{
+	SDL_GameController* controller = pad.controller;
+	if (!SDL_GameControllerGetAttached(controller))
+	{
+		fprintf(stderr, "Game controller of player %d disconnected\n", player + 1);
+		close_pad(pad, player, now);
+		return;
+	}
+
+	int x = SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_LEFTX);
+	int y = SDL_GameControllerGetAxis(controller, SDL_CONTROLLER_AXIS_LEFTY);
+	bool down[CONTROL_COUNT];
+	down[CONTROL_RIGHT] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_RIGHT) || stick_down(x, pad.down[CONTROL_RIGHT]);
+	down[CONTROL_LEFT] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_LEFT) || stick_down(-x, pad.down[CONTROL_LEFT]);
+	down[CONTROL_UP] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_UP) || stick_down(-y, pad.down[CONTROL_UP]);
+	down[CONTROL_DOWN] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_DPAD_DOWN) || stick_down(y, pad.down[CONTROL_DOWN]);
+	down[CONTROL_PUNCH] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_A) != 0;
+	down[CONTROL_ABILITY_1] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_X) != 0;
+	down[CONTROL_ABILITY_2] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_Y) != 0;
+	down[CONTROL_BLOCK] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_LEFTSHOULDER) ||
+		SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_RIGHTSHOULDER);
+	down[CONTROL_START] = SDL_GameControllerGetButton(controller, SDL_CONTROLLER_BUTTON_START) != 0;
+
+	for (int control = 0; control < CONTROL_COUNT; control++)
+	{
+		if (down[control] != pad.down[control])
+		{
+			pad.down[control] = down[control];
+			pad.next_repeat_ns[control] = now + REPEAT_DELAY_NS;
+			send(player, (Control)control, down[control] ? GLFW_PRESS : GLFW_RELEASE, now);
+		}
+		else if (down[control] && now >= pad.next_repeat_ns[control])
+		{
+			pad.next_repeat_ns[control] += REPEAT_INTERVAL_NS;
+			send(player, (Control)control, GLFW_REPEAT, now);
+		}
+	}
+}
+
+void InputThread::send(int player, Control control, int action, uint64_t now)
+{
+	// A full queue means the tick has stalled, dropping beats blocking the poll
+	if (m_events.push({ PAD_KEYS[player][control], 0, action, 0, now }))
+		m_sent++;
+	else
+		m_dropped++;
+}
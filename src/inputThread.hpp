@@ -0,0 +1,86 @@
+#pragma once
+
+#include "inputQueue.hpp"
+#include "spscQueue.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+#define SDL_MAIN_HANDLED
+#include <SDL.h>
+
+// Polls the gamepads on a thread of its own at a fixed rate, independent of the frame
+// rate, and hands their changes to the simulation tick as timestamped key events.
+//
+// The keyboard is not polled here: GLFW only allows event processing and glfwGetKey()
+// on the main thread, so keys keep arriving through the window callback. Pads are
+// read through SDL's game controller API, which works from any thread.
+//
+// Pad 1 plays with the keys of player 1 and pad 2 with those of player 2, so the game
+// sees presses, releases and repeats exactly as if they came from the keyboard.
+class InputThread
+{
+public:
+	static const int DEFAULT_POLL_HZ = 1000;
+	static const int MAX_PADS = 2;
+
+	// Starts polling, call from the main thread. False when there is no gamepad support
+	bool start(int poll_hz);
+	// Joins the thread and releases the pads
+	void stop();
+	bool is_running() const { return m_thread.joinable(); }
+
+	// Consumer side, for the simulation tick only. False once no event is waiting
+	bool pop(InputEvent& event) { return m_events.pop(event); }
+
+	// One line with the poll rate reached and the events sent
+	void report(FILE* file) const;
+
+	// Pad controls, in the order of the key tables
+	enum Control
+	{
+		CONTROL_RIGHT,
+		CONTROL_LEFT,
+		CONTROL_UP,
+		CONTROL_DOWN,
+		CONTROL_PUNCH,
+		CONTROL_ABILITY_1,
+		CONTROL_ABILITY_2,
+		CONTROL_BLOCK,
+		CONTROL_START,
+		CONTROL_COUNT
+	};
+
+private:
+	struct Pad
+	{
+		SDL_GameController* controller = nullptr;
+		SDL_JoystickID id = -1;
+		bool down[CONTROL_COUNT] = {};
+		uint64_t next_repeat_ns[CONTROL_COUNT] = {};
+	};
+
+	void run();
+	void open_new_pads();
+	void close_pad(Pad& pad, int player, uint64_t now);
+	void poll_pad(Pad& pad, int player, uint64_t now);
+	void send(int player, Control control, int action, uint64_t now);
+
+	// A second of events at 1000 Hz would already be a stalled tick
+	SpscQueue<InputEvent, 1024> m_events;
+	std::thread m_thread;
+	std::atomic<bool> m_quit{ false };
+	uint64_t m_period_ns = 0;
+
+	// Only touched by the input thread while it runs
+	Pad m_pads[MAX_PADS];
+
+	// Written by the input thread, read by report()
+	std::atomic<uint64_t> m_polls{ 0 };
+	std::atomic<uint64_t> m_sent{ 0 };
+	std::atomic<uint64_t> m_dropped{ 0 };
+	uint64_t m_start_ns = 0;
+	std::atomic<uint64_t> m_stop_ns{ 0 };
+};
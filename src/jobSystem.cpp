@@ -0,0 +1,154 @@
+// Header
+#include "jobSystem.hpp"
+#include "profiler.hpp"
+
+#include <algorithm>
+
+namespace
+{
+	// Worker of the current thread, threads the pool did not start count as worker 0
+	thread_local int t_worker_index = 0;
+}
+
+bool JobSystem::init(int workers)
+{
+	if (workers <= 0)
+		workers = std::max(1, (int)std::thread::hardware_concurrency());
+
+	m_worker_count = workers;
+	m_quit = false;
+	m_queued = 0;
+	for (int i = 0; i < workers; i++)
+		m_workers.push_back(new Worker());
+	for (int i = 1; i < workers; i++)
+		m_threads.emplace_back(&JobSystem::run_worker, this, i);
+	return true;
+}
+
+void JobSystem::destroy()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+	for (std::thread& thread : m_threads)
+		thread.join();
+	m_threads.clear();
+
+	for (Worker* worker : m_workers)
+		delete worker;
+	m_workers.clear();
+	m_worker_count = 1;
+}
+
+void JobSystem::add(JobGroup& group, const JobFunction& job, int count, int grain)
+{
+	grain = std::max(grain, 1);
+	if (m_worker_count <= 1)
+	{
+		for (int begin = 0; begin < count; begin += grain)
+			job(begin, std::min(begin + grain, count));
+		return;
+	}
+
+	int chunks = (count + grain - 1) / grain;
+	if (chunks <= 0)
+		return;
+	group.pending.fetch_add(chunks, std::memory_order_relaxed);
+
+	Worker& worker = *m_workers[t_worker_index];
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		for (int begin = 0; begin < count; begin += grain)
+			worker.jobs.push_back({ &job, begin, std::min(begin + grain, count), &group });
+	}
+	m_queued.fetch_add(chunks);
+
+	// Taking the lock orders the wake up after a worker that is about to sleep checked m_queued
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+	}
+	m_wake.notify_all();
+}
+
+void JobSystem::wait(JobGroup& group)
+{
+	PROFILE_ZONE("JobSystem::wait");
+	Job job;
+	while (group.pending.load(std::memory_order_acquire) > 0)
+	{
+		if (take_job(t_worker_index, job))
+			execute(job);
+		else
+			std::this_thread::yield(); // the last jobs are running on other workers
+	}
+}
+
+void JobSystem::parallel_for(int count, int grain, const JobFunction& job)
+{
+	JobGroup group;
+	add(group, job, count, grain);
+	wait(group);
+}
+
+void JobSystem::run_worker(int index)
+{
+	t_worker_index = index;
+	profiler_set_thread_name("job worker");
+
+	Job job;
+	while (true)
+	{
+		if (take_job(index, job))
+		{
+			execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_wake.wait(lock, [this] { return m_quit || m_queued > 0; });
+		if (m_quit)
+			return;
+	}
+}
+
+bool JobSystem::take_job(int index, Job& job)
+{
+	if (m_queued.load() == 0)
+		return false;
+
+	// Own jobs newest first, they are the most likely to still be in cache
+	{
+		Worker& own = *m_workers[index];
+		std::lock_guard<std::mutex> lock(own.mutex);
+		if (!own.jobs.empty())
+		{
+			job = own.jobs.back();
+			own.jobs.pop_back();
+			m_queued--;
+			return true;
+		}
+	}
+
+	// Others' oldest first, they tend to be the largest
+	for (int i = 1; i < m_worker_count; i++)
+	{
+		Worker& victim = *m_workers[(index + i) % m_worker_count];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+		if (!victim.jobs.empty())
+		{
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+			m_queued--;
+			return true;
+		}
+	}
+	return false;
+}
+
+void JobSystem::execute(const Job& job)
+{
+	(*job.function)(job.begin, job.end);
+	job.group->pending.fetch_sub(1, std::memory_order_release);
+}
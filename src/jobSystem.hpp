@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Called with a chunk [begin, end) of the items of a job
+typedef std::function<void(int begin, int end)> JobFunction;
+
+// Jobs that are waited for together. Lives on the stack of whoever adds and waits
+struct JobGroup
+{
+	std::atomic<int> pending{ 0 };
+};
+
+// Small work-stealing scheduler for the per-entity work of a tick. Every worker owns a
+// deque: it adds and takes its own jobs at the back, idle workers steal from the front
+// of the others'. The thread that waits for a group works on it too, it is worker 0.
+//
+//   JobGroup group;
+//   jobs.add(group, update_fighters, fighter_count, 4);
+//   jobs.add(group, update_particles);
+//   jobs.wait(group);
+//
+// With a single worker no thread is started and every job runs on the spot, in the
+// order it was added, so a tick runs exactly the same every time.
+class JobSystem
+{
+public:
+	// 0 workers starts one per core
+	bool init(int workers);
+	void destroy();
+
+	int get_worker_count() const { return m_worker_count; }
+
+	// Splits [0, count) into chunks of grain items, job must stay alive until wait()
+	void add(JobGroup& group, const JobFunction& job, int count = 1, int grain = 1);
+	// Runs jobs until every job of the group is done
+	void wait(JobGroup& group);
+
+	// add() and wait() in one
+	void parallel_for(int count, int grain, const JobFunction& job);
+
+private:
+	struct Job
+	{
+		const JobFunction* function;
+		int begin;
+		int end;
+		JobGroup* group;
+	};
+
+	struct Worker
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	void run_worker(int index);
+	bool take_job(int index, Job& job);
+	void execute(const Job& job);
+
+	int m_worker_count = 1;
+	std::vector<Worker*> m_workers;
+	std::vector<std::thread> m_threads;
+
+	// Idle workers sleep until jobs are added
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_wake;
+	std::atomic<int> m_queued{ 0 };
+	std::atomic<bool> m_quit{ false };
+};
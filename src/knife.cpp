@@ -1,5 +1,6 @@
 // Header
 #include "knife.hpp"
+#include "renderQueue.hpp"
 
 // internal
 
@@ -10,7 +11,7 @@
 #include <algorithm>
 
 float knifeOffset = 75.f;
-float dropSpeed = 5.f;
+float dropSpeed = 10.f; // per update
 void Knife::spawn_knife(unsigned int damage, vec2 pos) {
 	//pre-determined bullet attributes
 	this->m_scale = vec2({ 0.5f, 0.5f });
@@ -82,6 +83,7 @@ bool Knife::init()
 	glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
 
 	// Index Buffer creation
+	gl_bind_vertex_array(0);
 	glGenBuffers(1, &mesh.ibo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * indices.size(), indices.data(), GL_STATIC_DRAW);
@@ -109,7 +111,6 @@ void Knife::destroy()
 {
 	glDeleteBuffers(1, &mesh.vbo);
 	glDeleteBuffers(1, &mesh.ibo);
-	glDeleteBuffers(1, &mesh.vao);
 
 	glDeleteShader(effect.vertex);
 	glDeleteShader(effect.fragment);
@@ -132,6 +133,13 @@ void Knife::update(float ms)
 }
 
 void Knife::draw(const mat3& projection)
+{
+	KnifeFrame frame;
+	capture(frame);
+	frame.draw(projection);
+}
+
+void Knife::capture(KnifeFrame& frame)
 {
 	transform_begin();
 	transform_translate(m_position);
@@ -140,12 +148,20 @@ void Knife::draw(const mat3& projection)
 
 	transform_end();
 
+	frame.mesh = mesh;
+	frame.effect = effect;
+	frame.transform = transform;
+	frame.num_indices = m_num_indices;
+}
+
+void KnifeFrame::draw(const mat3& projection)
+{
 	// Setting shaders
-	glUseProgram(effect.program);
+	gl_use_program(effect.program);
 
 	// Enabling alpha channel for textures
-	glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_DEPTH_TEST);
+	gl_enable(GL_BLEND); gl_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	gl_enable(GL_DEPTH_TEST);
 
 	// Getting uniform locations
 	GLint transform_uloc = glGetUniformLocation(effect.program, "transform");
@@ -153,9 +169,9 @@ void Knife::draw(const mat3& projection)
 	GLint projection_uloc = glGetUniformLocation(effect.program, "projection");
 
 	// Setting vertices and indices
-	glBindVertexArray(mesh.vao);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+	gl_bind_vertex_array(mesh.vao);
+	gl_bind_buffer(GL_ARRAY_BUFFER, mesh.vbo);
+	gl_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
 
 	// Input data location as in the vertex buffer
 	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
@@ -175,7 +191,7 @@ void Knife::draw(const mat3& projection)
 	glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
 
 	// Drawing!
-	glDrawElements(GL_TRIANGLES, (GLsizei)m_num_indices, GL_UNSIGNED_SHORT, nullptr);
+	gl_draw_elements(GL_TRIANGLES, (GLsizei)num_indices, GL_UNSIGNED_SHORT, nullptr);
 }
 
 
@@ -202,4 +218,9 @@ bool Knife::collides_with(const Fighter& f)
 	if (d_sq < r * r)
 		return true;
 	return false;
-}
\ No newline at end of file
+}
+
+void KnifeFrame::submit(RenderQueue& queue)
+{
+	queue.submit_custom(LAYER_STAGE_FX, this);
+}
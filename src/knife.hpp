@@ -6,6 +6,15 @@
 #include "fighter.hpp"
 #include "boundingBox.hpp"
 
+// A falling knife as drawn, see FighterFrame
+struct KnifeFrame : public Renderable
+{
+	size_t num_indices;
+
+	void draw(const mat3& projection)override;
+	void submit(RenderQueue& queue)override;
+};
+
 //class Knife : public Renderable
 class Knife : public Attack
 {
@@ -23,6 +32,7 @@ public:
 	void update(float ms);
 
 	void draw(const mat3& projection)override;
+	void capture(KnifeFrame& frame);
 
 	vec2 get_position()const;
 
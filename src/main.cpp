@@ -1,13 +1,21 @@
 // internal
 #include "common.hpp"
 #include "world.hpp"
+#include "profiler.hpp"
+#include "allocTracker.hpp"
+#include "perfReplay.hpp"
+#include "goldenFrames.hpp"
 
 #define GL3W_IMPLEMENTATION
 #include <gl3w.h>
 
 // stlib
+#include <algorithm>
 #include <chrono>
+#include <thread>
 #include <iostream>
+#include <string.h>
+#include <stdlib.h>
 #include <SDL.h>
 
 using Clock = std::chrono::high_resolution_clock;
@@ -17,38 +25,243 @@ World world;
 const int width = 1200;
 const int height = 800;
 const char* title = "VEGGIE VENGEANCE";
+// Tick of --fixed-step, and the most ticks a frame catches up on
+const float FIXED_STEP_MS = 1000.f / 60.f;
+const int MAX_STEPS_PER_FRAME = 5;
 
 // Entry point
 int main(int argc, char* argv[])
 {
+	bool print_gl_stats = false;
+	const char* profile_path = nullptr;
+	bool print_alloc_report = false;
+	long long alloc_budget = -1;
+	const char* record_path = nullptr;
+	bool perf_replay = false;
+	PerfReplayOptions perf_options;
+	bool golden = false;
+	GoldenOptions golden_options;
+	PresentMode present_mode = PRESENT_VSYNC;
+	float fps_cap = 0.f;
+	bool fixed_step = false;
+	bool input_latency = false;
+	bool sim_thread = false;
+	int job_workers = 0;
+	for (int i = 1; i < argc; i++)
+	{
+		// Simulate particles on the GPU with transform feedback
+		if (strcmp(argv[i], "--gpu-particles") == 0)
+			world.set_gpu_particles(true);
+		// Glow around bright parts of the screen
+		else if (strcmp(argv[i], "--bloom") == 0)
+			world.set_bloom(true);
+		// Always draw at full resolution, even when that drops below 60 fps
+		else if (strcmp(argv[i], "--fixed-resolution") == 0)
+			world.set_dynamic_resolution(false);
+		// Periodically report how many GL state changes the state cache elided
+		else if (strcmp(argv[i], "--gl-stats") == 0)
+			print_gl_stats = true;
+		// Record profiler zones and write them as a Chrome trace on exit
+		else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc)
+			profile_path = argv[++i];
+		// Count heap allocations per call site and list the worst offenders on exit
+		else if (strcmp(argv[i], "--alloc-report") == 0)
+			print_alloc_report = true;
+		// Exit with a failure when a frame allocates more than this many times
+		else if (strcmp(argv[i], "--alloc-budget") == 0 && i + 1 < argc)
+			alloc_budget = atoll(argv[++i]);
+		// Save the key input of this session as a replay on exit
+		else if (strcmp(argv[i], "--record-replay") == 0 && i + 1 < argc)
+			record_path = argv[++i];
+		// Play the recorded matches headless and fail on a slowdown against the baseline
+		else if (strcmp(argv[i], "--perf-replay") == 0)
+			perf_replay = true;
+		// Same, but record the timings as the new baseline
+		else if (strcmp(argv[i], "--perf-update-baseline") == 0)
+			perf_replay = perf_options.update_baseline = true;
+		else if (strcmp(argv[i], "--perf-tolerance") == 0 && i + 1 < argc)
+			perf_options.tolerance = (float)atof(argv[++i]);
+		// Render the golden frame replays offscreen and fail when a frame looks different
+		else if (strcmp(argv[i], "--golden") == 0)
+			golden = true;
+		// Same, but record the frames as the new references
+		else if (strcmp(argv[i], "--golden-update") == 0)
+			golden = golden_options.update = true;
+		// vsync (default), adaptive, uncapped or capped
+		else if (strcmp(argv[i], "--present") == 0 && i + 1 < argc)
+		{
+			if (!FramePacer::parse_mode(argv[++i], present_mode))
+				fprintf(stderr, "Unknown present mode %s, using vsync\n", argv[i]);
+		}
+		// Capped present mode at this many frames per second
+		else if (strcmp(argv[i], "--fps-cap") == 0 && i + 1 < argc)
+		{
+			present_mode = PRESENT_CAPPED;
+			fps_cap = (float)atof(argv[++i]);
+		}
+		// Step the game in fixed 60 Hz ticks, however often frames are presented
+		else if (strcmp(argv[i], "--fixed-step") == 0)
+			fixed_step = true;
+		// Time key presses until their frame is on screen, the histogram is printed on exit
+		else if (strcmp(argv[i], "--input-latency") == 0)
+			input_latency = true;
+		// Gamepad poll rate of the input thread, 0 turns gamepads off
+		else if (strcmp(argv[i], "--input-hz") == 0 && i + 1 < argc)
+			world.set_input_poll_hz(atoi(argv[++i]));
+		// Ticks at the fixed step on a thread of its own, this one only draws
+		else if (strcmp(argv[i], "--sim-thread") == 0)
+			sim_thread = true;
+		// Threads sharing the fighter and attack updates of a tick, 1 runs them all on the updating thread
+		else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc)
+			job_workers = atoi(argv[++i]);
+		// AIs in the party mode's free-for-all
+		else if (strcmp(argv[i], "--party") == 0 && i + 1 < argc)
+			world.set_party_size(atoi(argv[++i]));
+		// Reload shaders, textures and data/fighters/fighters.txt when they are saved
+		else if (strcmp(argv[i], "--hot-reload") == 0)
+			world.set_hot_reload(true);
+	}
+	world.set_present_mode(present_mode, fps_cap);
+	world.set_measure_input_latency(input_latency);
+
+	// Replays run without a visible window, at a fixed resolution and on one thread, so timings compare between runs
+	if (perf_replay)
+	{
+		world.set_headless(true);
+		world.set_dynamic_resolution(false);
+		job_workers = 1;
+	}
+	// Software rendered without a window, works on machines with neither display nor GPU
+	if (golden)
+	{
+		world.set_offscreen(true);
+		world.set_dynamic_resolution(false);
+		job_workers = 1;
+	}
+	world.set_job_workers(job_workers);
+
+	// Replays and golden frames step the world themselves
+	world.set_sim_thread(sim_thread && !perf_replay && !golden);
+
+	profiler_set_thread_name("main");
+	profiler_set_enabled(profile_path != nullptr);
+	if (print_alloc_report || alloc_budget >= 0)
+		alloc_tracker_enable();
 
 	// Initializing world (after renderer.init().. sorry)
 	if (!world.init({ (float)width, (float)height }, MENU))
 	{
-		// Time to read the error message
-		std::cout << "Press any key to exit" << std::endl;
-		std::cin.get();
+		// Time to read the error message, unless nobody is watching
+		if (!perf_replay && !golden)
+		{
+			std::cout << "Press any key to exit" << std::endl;
+			std::cin.get();
+		}
+		return EXIT_FAILURE;
+	}
+
+	if (perf_replay)
+	{
+		int result = run_perf_replays(world, perf_options);
+		world.destroy();
+		return result;
+	}
+
+	if (golden)
+	{
+		int result = run_golden_frames(world, golden_options);
+		world.destroy();
+		return result;
+	}
+
+	ReplayRecorder recorder;
+	if (record_path != nullptr)
+		world.set_replay_recorder(&recorder);
+
+	if (sim_thread && !world.start_sim_thread(FIXED_STEP_MS))
+	{
+		fprintf(stderr, "Failed to start the simulation thread\n");
+		world.destroy();
 		return EXIT_FAILURE;
 	}
 
 	auto t = Clock::now();
+	int frame_count = 0;
+	float step_backlog_ms = 0.f;
 
 	// variable timestep loop.. can be improved (:
 	while (!world.is_over())
 	{
+		PROFILE_ZONE("frame");
+
+		// Frame cap, before polling so that waiting does not delay the input
+		world.wait_for_next_frame();
+
 		// Processes system messages, if this wasn't present the window would become unresponsive
 		glfwPollEvents();
 
-		// Calculating elapsed times in milliseconds from the previous iteration
-		auto now = Clock::now();
-		float elapsed_sec = (float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
-		t = now;
+		if (sim_thread)
+		{
+			// Ticks run on the simulation thread, the next one may not have finished yet
+			if (!world.draw_latest_frame())
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				continue;
+			}
+		}
+		else
+		{
+			// Calculating elapsed times in milliseconds from the previous iteration
+			auto now = Clock::now();
+			float elapsed_sec = (float)(std::chrono::duration_cast<std::chrono::microseconds>(now - t)).count() / 1000;
+			t = now;
+
+			if (fixed_step)
+			{
+				// The remainder carries over to the next frame. After a stall the backlog is
+				// dropped rather than caught up with a burst of steps
+				step_backlog_ms = std::min(step_backlog_ms + elapsed_sec, FIXED_STEP_MS * MAX_STEPS_PER_FRAME);
+				while (step_backlog_ms >= FIXED_STEP_MS)
+				{
+					world.update(FIXED_STEP_MS);
+					step_backlog_ms -= FIXED_STEP_MS;
+				}
+			}
+			else
+			{
+				world.update(elapsed_sec);
+			}
+			world.draw();
+		}
 
-		world.update(elapsed_sec);
-		world.draw();
+		if (alloc_tracker_is_enabled())
+			alloc_tracker_end_frame();
+
+		if (print_gl_stats && ++frame_count % 60 == 0)
+		{
+			GLStateStats stats = gl_state_frame_stats();
+			fprintf(stderr, "GL state calls per frame: %d issued, %d elided, %d draw calls\n", stats.issued, stats.elided, stats.draw_calls);
+		}
 	}
 
 	world.destroy();
+	world.get_frame_pacer().report(stderr);
+	if (input_latency)
+	{
+		world.get_input_latency().report(stderr);
+		world.get_input_thread().report(stderr);
+	}
+
+	if (record_path != nullptr && recorder.get_replay().save_to_file(record_path))
+		fprintf(stderr, "Wrote replay to %s\n", record_path);
+
+	if (profile_path != nullptr && profiler_write_chrome_trace(profile_path))
+		fprintf(stderr, "Wrote profile to %s\n", profile_path);
+
+	if (print_alloc_report)
+		alloc_tracker_report(stderr, 10);
+	if (alloc_budget >= 0 && !alloc_tracker_check_budget((uint64_t)alloc_budget))
+		return EXIT_FAILURE;
 
 	return EXIT_SUCCESS;
 }
\ No newline at end of file
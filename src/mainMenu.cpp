@@ -36,6 +36,7 @@ bool MainMenu::init(vec2 screen)
 	glBufferData(GL_ARRAY_BUFFER, sizeof(TexturedVertex) * 4, vertices, GL_STATIC_DRAW);
 
 	// Index Buffer creation
+	gl_bind_vertex_array(0);
 	glGenBuffers(1, &mesh.ibo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * 6, indices, GL_STATIC_DRAW);
@@ -93,6 +94,13 @@ void MainMenu::destroy()
 }
 
 void MainMenu::draw(const mat3& projection)
+{
+	ScreenFrame frame;
+	capture(frame);
+	frame.draw(projection);
+}
+
+void MainMenu::capture(ScreenFrame& frame)
 {
 	// Transformation code, see Rendering and Transformation in the template specification for more info
 	// Incrementally updates transformation matrix, thus ORDER IS IMPORTANT
@@ -102,86 +110,48 @@ void MainMenu::draw(const mat3& projection)
 	transform_scale(m_scale);
 	transform_end();
 
-	// Setting shaders
-	glUseProgram(effect.program);
-
-	// Enabling alpha channel for textures
-	glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDisable(GL_DEPTH_TEST);
-
-	// Getting uniform locations for glUniform* calls
-	GLint transform_uloc = glGetUniformLocation(effect.program, "transform");
-	GLint color_uloc = glGetUniformLocation(effect.program, "fcolor");
-	GLint projection_uloc = glGetUniformLocation(effect.program, "projection");
-	GLuint time_uloc = glGetUniformLocation(effect.program, "time");
-
-	// Setting vertices and indices
-	glBindVertexArray(mesh.vao);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
-
-	// Input data location as in the vertex buffer
-	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
-	GLint in_texcoord_loc = glGetAttribLocation(effect.program, "in_texcoord");
-	glEnableVertexAttribArray(in_position_loc);
-	glEnableVertexAttribArray(in_texcoord_loc);
-	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
-	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
-
-	// Enabling and binding texture to slot 0
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_texture.id);
-
-	// Setting uniform values to the currently bound program
-	glUniformMatrix3fv(transform_uloc, 1, GL_FALSE, (float*)&transform);
-	float color[] = { 1.f, 1.f, 1.f };
-	glUniform3fv(color_uloc, 1, color);
-	glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
-	glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
-
-	/////////////////////////
-
-	// Drawing!
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+	frame.add_quad(mesh, effect.program, m_texture.id, transform);
+	color_buttons();
 	if (m_mode == MENU) {
-		title->renderString(projection, "VEGGIE VENGEANCE");
-		buttons[0]->renderString(projection, "ONE-PLAYER");
-		buttons[1]->renderString(projection, "TWO-PLAYER");
-		buttons[2]->renderString(projection, "TUTORIAL");
-		buttons[3]->renderString(projection, "QUIT");
+		frame.add_text(title, "VEGGIE VENGEANCE");
+		frame.add_text(buttons[0], "ONE-PLAYER");
+		frame.add_text(buttons[1], "TWO-PLAYER");
+		frame.add_text(buttons[2], "TUTORIAL");
+		frame.add_text(buttons[3], "PARTY");
+		frame.add_text(buttons[4], "QUIT");
 	} else if (m_mode == CHARSELECT) {
 		if (m_selected_mode == PVP) {
-			if (!is_player_1_chosen) { title->renderString(projection, "P1 CHARACTER SELECT"); }
-			else { title->renderString(projection, "P2 CHARACTER SELECT"); }
-		} else { title->renderString(projection, "CHARACTER SELECT"); }
-		buttons[0]->renderString(projection, "POTATO");
-		buttons[1]->renderString(projection, "BROCCOLI");
-		buttons[2]->renderString(projection, "EGGPLANT");
-		buttons[3]->renderString(projection, "YAM");
-		buttons[4]->renderString(projection, "return");
-		draw_char_info(projection);
+			if (!is_player_1_chosen) { frame.add_text(title, "P1 CHARACTER SELECT"); }
+			else { frame.add_text(title, "P2 CHARACTER SELECT"); }
+		} else { frame.add_text(title, "CHARACTER SELECT"); }
+		frame.add_text(buttons[0], "POTATO");
+		frame.add_text(buttons[1], "BROCCOLI");
+		frame.add_text(buttons[2], "EGGPLANT");
+		frame.add_text(buttons[3], "YAM");
+		frame.add_text(buttons[4], "return");
+		capture_char_info(frame);
 	} else if (m_mode == STAGESELECT) {
-		title->renderString(projection, "STAGE SELECT");
-		buttons[0]->renderString(projection, "KITCHEN");
-		buttons[1]->renderString(projection, "OVEN");
-		buttons[2]->renderString(projection, "return");
+		frame.add_text(title, "STAGE SELECT");
+		frame.add_text(buttons[0], "KITCHEN");
+		frame.add_text(buttons[1], "OVEN");
+		frame.add_text(buttons[2], "return");
 		
 		Stage s = get_selected_stage();
 		if (s != MENUBORDER) {
-			stage_textures[s].draw(projection);
-			if (s == KITCHEN) { text[0]->renderString(projection, "HAZARD: Falling knives"); }
-			else if (s == OVEN) { text[0]->renderString(projection, "HAZARD: Heat wave"); }
+			stage_textures[s].capture(frame);
+			if (s == KITCHEN) { frame.add_text(text[0], "HAZARD: Falling knives"); }
+			else if (s == OVEN) { frame.add_text(text[0], "HAZARD: Heat wave"); }
 		}
 	}
 	else if (m_mode == FIGHTINTRO) {
 		for (int i = 0; i < fi_textures.size(); i++) {
-			fi_textures[i].draw(projection);
+			fi_textures[i].capture(frame);
 		}
-		text[0]->renderString(projection, p1name);
-		text[1]->renderString(projection, p2name);
-		text[2]->renderString(projection, "VS.");
-		text[3]->renderString(projection, "PRESS ENTER TO START");
-		text[4]->renderString(projection, "press H in-game for help");
+		frame.add_text(text[0], p1name);
+		frame.add_text(text[1], p2name);
+		frame.add_text(text[2], "VS.");
+		frame.add_text(text[3], "PRESS ENTER TO START");
+		frame.add_text(text[4], "press H in-game for help");
 	}
 }
 
@@ -201,21 +171,25 @@ void MainMenu::init_menu_buttons()
 	TextRenderer* b2 = new TextRenderer(mainFont, 50);
 	TextRenderer* b3 = new TextRenderer(mainFont, 50);
 	TextRenderer* b4 = new TextRenderer(mainFont, 50);
+	TextRenderer* b5 = new TextRenderer(mainFont, 50);
 
 	b1->setColor(selectedColor);
 	b2->setColor(defaultColor);
 	b3->setColor(defaultColor);
 	b4->setColor(defaultColor);
+	b5->setColor(defaultColor);
 
 	int width = b1->get_width_of_string("POTATO");
 	b1->setPosition({ width / 3.f, screen.y / 2.f-100.f });
 	b2->setPosition({ width / 3.f, (screen.y/2.f) -25.f});
 	b3->setPosition({ width / 3.f, (screen.y / 2.f) + 50.f });
 	b4->setPosition({ width / 3.f, (screen.y / 2.f) + 125.f });
+	b5->setPosition({ width / 3.f, (screen.y / 2.f) + 200.f });
 	buttons.emplace_back(b1);
 	buttons.emplace_back(b2);
 	buttons.emplace_back(b3);
 	buttons.emplace_back(b4);
+	buttons.emplace_back(b5);
 }
 
 void MainMenu::init_select_char_buttons() {
@@ -315,35 +289,8 @@ void MainMenu::init_fight_intro(std::string p1name, FighterCharacter p1fc, std::
 	TextureRenderer s1, s2;
 	vec2 p1posn = { screen.x * .15f, 200.f };
 	vec2 p2posn = { screen.x * .85f , screen.y -300.f };
-	switch (p1fc) {
-	case POTATO:
-		s1.init(screen, &POTATO_CHARGING_TEXTURE, { .4f, .4f }, p1posn);
-		break;
-	case BROCCOLI:
-		s1.init(screen, &BROCCOLI_CHARGING_TEXTURE, { .4f, .4f }, p1posn);
-		break;
-	case EGGPLANT:
-		s1.init(screen, &EGGPLANT_CHARGING_TEXTURE, { .4f, .4f }, p1posn);
-		break;
-	case YAM:
-		s1.init(screen, &YAM_CHARGING_TEXTURE, { 0.4f, 0.4f }, p1posn);
-		break;
-	}
-
-	switch (p2fc) {
-	case POTATO:
-		s2.init(screen, &POTATO_POWER_PUNCH_TEXTURE, { -0.4f, 0.4f }, p2posn);
-		break;
-	case BROCCOLI:
-		s2.init(screen, &BROCCOLI_POWER_PUNCH_TEXTURE, { -0.4f, 0.4f }, p2posn);
-		break;
-	case EGGPLANT:
-		s2.init(screen, &EGGPLANT_POWER_PUNCH_TEXTURE, { -0.4f, 0.4f }, p2posn);
-		break;
-	case YAM:
-		s2.init(screen, &YAM_POWER_PUNCH_TEXTURE, { -0.4f, 0.4f }, p2posn);
-		break;
-	}
+	s1.init(screen, get_fighter_definition(p1fc).sprites[CHARGING], { .4f, .4f }, p1posn);
+	s2.init(screen, get_fighter_definition(p2fc).sprites[POWER_PUNCH], { -0.4f, 0.4f }, p2posn);
 	fi_textures.emplace_back(s1);
 	fi_textures.emplace_back(s2);
 
@@ -392,6 +339,10 @@ GameMode MainMenu::set_selected_mode()
 		break; 
 		}
 	case 3: {
+		m_selected_mode = PARTY;
+		break;
+	}
+	case 4: {
 		m_selected_mode = MENU; // quit
 		break;
 	}
@@ -431,15 +382,15 @@ Stage MainMenu::get_selected_stage()
 	}
 }
 
-void MainMenu::draw_char_info(const mat3& projection)
+void MainMenu::capture_char_info(ScreenFrame& frame)
 {
 	if (get_selected_char() == BLANK) { return; }
-	text[0]->renderString(projection, fighterMap[get_selected_char()].sciName);
-	text[1]->renderString(projection, "STR: " + int_to_stat_string(fighterMap[get_selected_char()].strength));
-	text[2]->renderString(projection, "SPD: " + int_to_stat_string(fighterMap[get_selected_char()].speed));
-	text[3]->renderString(projection, std::to_string(fighterMap[get_selected_char()].health) + "HP");
-	text[4]->renderString(projection, "Abilities: ");
-	text[5]->renderString(projection, fighterMap[get_selected_char()].abilities);
+	frame.add_text(text[0], fighterMap[get_selected_char()].sciName);
+	frame.add_text(text[1], "STR: " + int_to_stat_string(fighterMap[get_selected_char()].strength));
+	frame.add_text(text[2], "SPD: " + int_to_stat_string(fighterMap[get_selected_char()].speed));
+	frame.add_text(text[3], std::to_string(fighterMap[get_selected_char()].health) + "HP");
+	frame.add_text(text[4], "Abilities: ");
+	frame.add_text(text[5], fighterMap[get_selected_char()].abilities);
 }
 
 std::string MainMenu::int_to_stat_string(int in) {
@@ -493,29 +444,28 @@ void MainMenu::reset() {
 void Screen::change_selection(bool goDown)
 {
 	//std::cout << "buttons size: " << buttons.size() << ", selectedButtonIndex: " << selectedButtonIndex << std::endl;
-	buttons[selectedButtonIndex]->setColor(defaultColor);
 	if (selectedButtonIndex == buttons.size() - 1 && goDown) {
-		buttons[0]->setColor(selectedColor);
 		selectedButtonIndex = 0;
 	}
 	else if (selectedButtonIndex == 0 && !goDown) {
-		buttons[buttons.size() - 1]->setColor(selectedColor);
 		selectedButtonIndex = buttons.size() - 1;
 	}
 	else if (goDown) {
 		selectedButtonIndex++;
-		buttons[selectedButtonIndex]->setColor(selectedColor);
 	}
 	else {
 		selectedButtonIndex--;
-		buttons[selectedButtonIndex]->setColor(selectedColor);
 	}
 }
 
 void Screen::reset_selection()
 {
-	buttons[selectedButtonIndex]->setColor(defaultColor);
-	buttons[0]->setColor(selectedColor);
-
 	selectedButtonIndex = 0;
 }
+
+void Screen::color_buttons()
+{
+	for (int i = 0; i < buttons.size(); i++) {
+		buttons[i]->setColor(i == selectedButtonIndex ? selectedColor : defaultColor);
+	}
+}
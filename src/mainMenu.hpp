@@ -4,6 +4,8 @@
 #include "textRenderer.hpp"
 #include "textureRenderer.hpp"
 #include "fighterInfo.hpp"
+#include "fighterDefinition.hpp"
+#include "screenFrame.hpp"
 
 class Screen
 {
@@ -17,6 +19,8 @@ public:
 	}
 	void change_selection(bool goDown); // goDown is true when down direction
 	void reset_selection();
+	// The selection only moves the index, the buttons take their colors when drawn
+	void color_buttons();
 protected:
 	const vec3 selectedColor = { 0.7f,0.2f,0.2f };
 	const vec3 defaultColor = { 0.4f,0.4f,0.4f };
@@ -46,6 +50,8 @@ public:
 
 	// projection is the 2D orthographic projection matrix
 	void draw(const mat3& projection)override;
+	// Records what draw() shows, buttons take their colors here
+	void capture(ScreenFrame& frame);
 
 	// Returns the current bubble position
 	vec2 get_position()const;
@@ -64,7 +70,7 @@ public:
 	//////// CHAR SELECT FUNCTIONS
 	FighterCharacter get_selected_char();
 	void init_select_char_buttons();
-	void draw_char_info(const mat3& projection);
+	void capture_char_info(ScreenFrame& frame);
 	std::string int_to_stat_string(int in);
 	//////// STAGE SELECT FUNCTIONS
 	void init_select_stage_buttons();
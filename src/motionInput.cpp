@@ -0,0 +1,110 @@
+// Header
+#include "motionInput.hpp"
+
+#include <queue>
+
+namespace
+{
+	// Special moves of each FighterCharacter, BLANK has none. A motion ending on a
+	// button replaces what the button would do, one ending on a direction adds to it
+	std::vector<SpecialMove> make_special_moves(FighterCharacter fc)
+	{
+		switch (fc)
+		{
+		case POTATO:
+			return { { "Tater Toss", { MOTION_DOWN, MOTION_FORWARD, MOTION_PUNCH }, ABILITY_1 } };
+		case BROCCOLI:
+			return { { "Rising Floret", { MOTION_DOWN, MOTION_FORWARD, MOTION_PUNCH }, ABILITY_1 } };
+		case EGGPLANT:
+			return { { "Emoji Flick", { MOTION_DOWN, MOTION_FORWARD, MOTION_PUNCH }, ABILITY_2 } };
+		case YAM:
+			return { { "Sweet Rush", { MOTION_FORWARD, MOTION_FORWARD }, ABILITY_1 } };
+		default:
+			return {};
+		}
+	}
+}
+
+void MotionRecognizer::compile(const std::vector<SpecialMove>& moves)
+{
+	// Trie of the motions, -1 where there is no child yet
+	m_next.assign(MOTION_INPUT_COUNT, -1);
+	m_match.assign(1, -1);
+	for (int i = 0; i < (int)moves.size(); i++)
+	{
+		int state = START;
+		for (MotionInput input : moves[i].motion)
+		{
+			int& next = m_next[state * MOTION_INPUT_COUNT + input];
+			if (next < 0)
+			{
+				next = (int)m_match.size();
+				m_match.push_back(-1);
+				m_next.resize(m_next.size() + MOTION_INPUT_COUNT, -1);
+			}
+			state = m_next[state * MOTION_INPUT_COUNT + input];
+		}
+		// The first of two identical motions wins
+		if (state != START && m_match[state] < 0)
+			m_match[state] = i;
+	}
+
+	// Breadth first, so the fallback of each state, the longest suffix of its inputs
+	// that is also a prefix of a motion, is complete before its children need it
+	std::vector<int> fallback(m_match.size(), (int)START);
+	std::queue<int> pending;
+	for (int input = 0; input < MOTION_INPUT_COUNT; input++)
+	{
+		int& next = m_next[START * MOTION_INPUT_COUNT + input];
+		if (next < 0)
+			next = START;
+		else
+			pending.push(next);
+	}
+	while (!pending.empty())
+	{
+		int state = pending.front();
+		pending.pop();
+		// A motion ending inside a longer one still completes there
+		if (m_match[state] < 0)
+			m_match[state] = m_match[fallback[state]];
+
+		for (int input = 0; input < MOTION_INPUT_COUNT; input++)
+		{
+			int& next = m_next[state * MOTION_INPUT_COUNT + input];
+			int fallback_next = m_next[fallback[state] * MOTION_INPUT_COUNT + input];
+			if (next < 0)
+			{
+				next = fallback_next;
+				continue;
+			}
+			fallback[next] = fallback_next;
+			pending.push(next);
+		}
+	}
+}
+
+const std::vector<SpecialMove>& get_special_moves(FighterCharacter fc)
+{
+	static const std::vector<SpecialMove> moves[] = {
+		make_special_moves(POTATO),
+		make_special_moves(BROCCOLI),
+		make_special_moves(EGGPLANT),
+		make_special_moves(YAM),
+		make_special_moves(BLANK),
+	};
+	return moves[fc];
+}
+
+const MotionRecognizer& get_motion_recognizer(FighterCharacter fc)
+{
+	static MotionRecognizer recognizers[BLANK + 1];
+	static bool compiled = false;
+	if (!compiled)
+	{
+		for (int i = 0; i <= BLANK; i++)
+			recognizers[i].compile(get_special_moves((FighterCharacter)i));
+		compiled = true;
+	}
+	return recognizers[fc];
+}
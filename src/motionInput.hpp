@@ -0,0 +1,55 @@
+#pragma once
+
+#include "fighterInfo.hpp"
+
+#include <vector>
+
+// Steps of a motion, directions relative to where the fighter faces
+enum MotionInput
+{
+	MOTION_UP = 0,
+	MOTION_DOWN,
+	MOTION_FORWARD,
+	MOTION_BACK,
+	MOTION_PUNCH,
+	MOTION_ABILITY_1,
+	MOTION_ABILITY_2,
+	MOTION_BLOCK,
+	MOTION_INPUT_COUNT
+};
+
+// Longest pause between two steps of a motion
+const float MOTION_STEP_MS = 250.f;
+
+// A motion, e.g. down, forward, punch, that taps movement when entered with no more
+// than MOTION_STEP_MS between two steps
+struct SpecialMove
+{
+	const char* name;
+	std::vector<MotionInput> motion;
+	int movement; // FighterMovementState the motion taps
+};
+
+// The special moves of all characters are matched by one automaton per character,
+// compiled from its motions like Aho-Corasick: every state has a transition for
+// every input, so each input costs one table lookup however many motions there are
+// and wherever in a motion the fighter is.
+class MotionRecognizer
+{
+public:
+	static const int START = 0;
+
+	void compile(const std::vector<SpecialMove>& moves);
+
+	int step(int state, MotionInput input) const { return m_next[state * MOTION_INPUT_COUNT + input]; }
+	// Index of the special move completed on reaching state, -1 if none
+	int get_match(int state) const { return m_match[state]; }
+
+private:
+	std::vector<int> m_next; // MOTION_INPUT_COUNT transitions per state
+	std::vector<int> m_match;
+};
+
+const std::vector<SpecialMove>& get_special_moves(FighterCharacter fc);
+// Compiled on first use
+const MotionRecognizer& get_motion_recognizer(FighterCharacter fc);
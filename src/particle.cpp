@@ -5,7 +5,8 @@ Particle::Particle() {
 	m_position = {0.0,0.0};
 	m_lifespan = 0;
 	m_velocity = { 0.0,0.0 };
-	m_is_alive = true;
+	m_scale = 0;
+	m_is_alive = false;
 	m_color = { 0.0,0.0,0.0 };
 }
 
@@ -17,6 +18,7 @@ void Particle::init(vec2 position, float lifespan, float angle, float speed, vec
 	m_velocity.y = -speed * sin(radians);
 	m_scale = scale; //5.F
 	m_color = color;
+	m_is_alive = true;
 }
 
 static const float p = 1.293f;
@@ -42,51 +44,9 @@ void Particle::update(float ms) {
 	m_position.y += m_velocity.y;
 }
 
-void Particle::copy_from(Particle& particle) {
-	m_position = particle.m_position;
-	m_velocity = particle.m_velocity;
-	m_is_alive = particle.m_is_alive;
-	m_lifespan = particle.m_lifespan;
-}
-
-vec2 Particle::get_position() {
+vec2 Particle::get_position() const {
 	return m_position;
 }
-bool Particle::get_is_alive() {
+bool Particle::get_is_alive() const {
 	return m_is_alive;
 }
-
-void Particle::draw(const mat3& projection) {
-	return; // TODO
-}
-
-void Particle::draw(const mat3 &projection, Effect& emitter_effect) {
-	transform_begin();
-	transform_translate(m_position);
-	transform_scale({ m_scale, m_scale });
-	transform_end();
-
-	// Input data location as in the vertex buffer
-	GLint in_position_loc = glGetAttribLocation(emitter_effect.program, "in_position");
-	GLint in_color_loc = glGetAttribLocation(emitter_effect.program, "in_color");
-	glEnableVertexAttribArray(in_position_loc);
-	glEnableVertexAttribArray(in_color_loc);
-	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-	glVertexAttribPointer(in_color_loc, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)sizeof(vec3));
-
-	// Getting uniform locations
-	GLint transform_uloc = glGetUniformLocation(emitter_effect.program, "transform");
-	GLint projection_uloc = glGetUniformLocation(emitter_effect.program, "projection");
-
-	// Setting uniform values to the currently bound program
-	glUniformMatrix3fv(transform_uloc, 1, GL_FALSE, (float*)&transform);
-	glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
-
-	/// TODO TRYING TO COLOR
-	GLint color_uloc = glGetUniformLocation(emitter_effect.program, "fcolor");
-	float color[] = { m_color.x, m_color.y, m_color.z };
-	glUniform3fv(color_uloc, 1, color);
-
-	// Drawing!
-	glDrawElements(GL_TRIANGLE_STRIP, 4, GL_UNSIGNED_SHORT, 0);
-}
\ No newline at end of file
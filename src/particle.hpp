@@ -1,24 +1,18 @@
 #pragma once
 #include "common.hpp"
 
-class Particle : public Renderable {
-	static Texture bomb_texture;
-public:
+// Plain particle state, owned and stored contiguously by the ParticleSystem pool
+struct Particle {
 	Particle();
 	void init(vec2 position, float lifespan, float angle, float speed, vec3 color, float scale);
 	void update(float ms);
-	vec2 get_position();
-	bool get_is_alive();
+	vec2 get_position() const;
+	bool get_is_alive() const;
 
-	void copy_from(Particle & particle);
-
-	void draw(const mat3 &projection);
-	void draw(const mat3 &projection, Effect& emitter_effect);
-private:
 	vec2 m_position;
-	bool m_is_alive;
 	vec2 m_velocity;
 	float m_lifespan;
 	float m_scale;
 	vec3 m_color;
-};
\ No newline at end of file
+	bool m_is_alive;
+};
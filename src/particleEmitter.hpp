@@ -2,23 +2,19 @@
 #include "common.hpp"
 #include "particle.hpp"
 
-class ParticleEmitter : public Renderable {
-public:
-	ParticleEmitter(vec2 position, int max_particles, vec3 m_color, bool random, float angle, float scale);
-	~ParticleEmitter();
+// Lightweight description of a single burst. Emitters own no particles or GL
+// objects, the ParticleSystem spawns their particles straight into its pool.
+struct ParticleEmitter {
+	ParticleEmitter(vec2 position, int max_particles, vec3 color, bool random, float angle, float scale);
 
-	bool init();
-	void update(float ms);
-	void draw(const mat3 &projection);
-	int get_alive_particles();
+	// Initializes one particle of this burst
+	void spawn(Particle& particle) const;
 
-private:
-	Particle * particle_pool;
 	vec2 m_position;
 	int m_max_particles;
-	int m_num_alive_particles;
+	float m_lifespan;
 	vec3 m_color;
 	bool m_is_random;
 	float m_set_angle;
 	float m_p_scale;
-};
\ No newline at end of file
+};
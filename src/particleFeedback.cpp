@@ -0,0 +1,213 @@
+#include "particleFeedback.hpp"
+
+#include <cstddef>
+#include <math.h>
+#include <vector>
+
+static const vec3 quad_vertex_buffer_data[] = {
+	{ -0.5f, -0.5f, -0.01f },
+	{ 0.5f, -0.5f, -0.01f },
+	{ -0.5f,  0.5f, -0.01f },
+	{ 0.5f,  0.5f, -0.01f },
+};
+
+static const char* const feedback_varyings[] = {
+	"out_position", "out_velocity", "out_life", "out_scale", "out_color"
+};
+
+namespace
+{
+	void set_attrib(GLuint program, const char* name, GLint size, size_t offset, GLuint divisor)
+	{
+		GLint loc = glGetAttribLocation(program, name);
+		if (loc < 0)
+			return;
+		glEnableVertexAttribArray(loc);
+		glVertexAttribPointer(loc, size, GL_FLOAT, GL_FALSE, sizeof(float) * 9, (void*)offset);
+		glVertexAttribDivisor(loc, divisor);
+	}
+}
+
+ParticleFeedback::ParticleFeedback() {
+	m_quad_vbo = 0;
+	m_state_vbos[0] = m_state_vbos[1] = 0;
+	m_sim_vaos[0] = m_sim_vaos[1] = 0;
+	m_draw_vaos[0] = m_draw_vaos[1] = 0;
+	m_initialized = false;
+	clear();
+}
+
+bool ParticleFeedback::init() {
+	// Clearing errors
+	gl_flush_errors();
+
+	if (!m_sim_effect.load_feedback_from_file(shader_path("particleSim.vs.glsl"), feedback_varyings, 5))
+		return false;
+	if (!m_draw_effect.load_from_file(shader_path("particleGpu.vs.glsl"), shader_path("particle.fs.glsl"))) {
+		m_sim_effect.release();
+		return false;
+	}
+	m_initialized = true;
+
+	glGenBuffers(1, &m_quad_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, m_quad_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertex_buffer_data), quad_vertex_buffer_data, GL_STATIC_DRAW);
+
+	// Dead particles have a negative life, so start every slot dead
+	GpuParticle dead = { { 0.f, 0.f }, { 0.f, 0.f }, -1.f, 0.f, { 0.f, 0.f, 0.f } };
+	std::vector<GpuParticle> initial(MAX_PARTICLES, dead);
+
+	glGenBuffers(2, m_state_vbos);
+	glGenVertexArrays(2, m_sim_vaos);
+	glGenVertexArrays(2, m_draw_vaos);
+	for (int i = 0; i < 2; i++) {
+		glBindBuffer(GL_ARRAY_BUFFER, m_state_vbos[i]);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(GpuParticle) * MAX_PARTICLES, initial.data(), GL_DYNAMIC_COPY);
+
+		// Simulation reads one particle per vertex
+		glBindVertexArray(m_sim_vaos[i]);
+		set_attrib(m_sim_effect.program, "in_position", 2, offsetof(GpuParticle, position), 0);
+		set_attrib(m_sim_effect.program, "in_velocity", 2, offsetof(GpuParticle, velocity), 0);
+		set_attrib(m_sim_effect.program, "in_life", 1, offsetof(GpuParticle, life), 0);
+		set_attrib(m_sim_effect.program, "in_scale", 1, offsetof(GpuParticle, scale), 0);
+		set_attrib(m_sim_effect.program, "in_color", 3, offsetof(GpuParticle, color), 0);
+
+		// Drawing reads one particle per quad instance
+		glBindVertexArray(m_draw_vaos[i]);
+		set_attrib(m_draw_effect.program, "in_offset", 2, offsetof(GpuParticle, position), 1);
+		set_attrib(m_draw_effect.program, "in_life", 1, offsetof(GpuParticle, life), 1);
+		set_attrib(m_draw_effect.program, "in_scale", 1, offsetof(GpuParticle, scale), 1);
+		set_attrib(m_draw_effect.program, "in_color", 3, offsetof(GpuParticle, color), 1);
+		glBindBuffer(GL_ARRAY_BUFFER, m_quad_vbo);
+		GLint in_position_loc = glGetAttribLocation(m_draw_effect.program, "in_position");
+		glEnableVertexAttribArray(in_position_loc);
+		glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void*)0);
+	}
+	glBindVertexArray(0);
+
+	if (gl_has_errors()) {
+		destroy();
+		return false;
+	}
+	return true;
+}
+
+void ParticleFeedback::destroy() {
+	if (!m_initialized)
+		return;
+	glDeleteVertexArrays(2, m_sim_vaos);
+	glDeleteVertexArrays(2, m_draw_vaos);
+	glDeleteBuffers(2, m_state_vbos);
+	glDeleteBuffers(1, &m_quad_vbo);
+	m_sim_effect.release();
+	m_draw_effect.release();
+	m_initialized = false;
+}
+
+void ParticleFeedback::emit(const ParticleEmitter& emitter) {
+	if (m_num_commands == MAX_EMIT_COMMANDS) {
+		// Out of uniform slots, spawn what is queued without stepping
+		simulate(0.f, false);
+	}
+
+	int count = emitter.m_max_particles < MAX_PARTICLES ? emitter.m_max_particles : MAX_PARTICLES;
+	EmitCommand& command = m_commands[m_num_commands++];
+	command.position = emitter.m_position;
+	command.scale = emitter.m_p_scale;
+	command.lifespan = emitter.m_lifespan;
+	command.color = emitter.m_color;
+	command.angle = emitter.m_is_random ? -1.f : fmodf(fmodf(emitter.m_set_angle, 360.f) + 360.f, 360.f);
+	command.start = m_next_slot;
+	command.count = count;
+
+	m_next_slot = (m_next_slot + count) % MAX_PARTICLES;
+	m_active_slots = (m_active_slots + count < MAX_PARTICLES) ? m_active_slots + count : MAX_PARTICLES;
+	if (emitter.m_lifespan > m_remaining_lifespan)
+		m_remaining_lifespan = emitter.m_lifespan;
+}
+
+void ParticleFeedback::update(float ms) {
+	// Nothing queued and everything emitted so far has expired
+	if (m_num_commands == 0 && m_remaining_lifespan < 0.f)
+		return;
+	simulate(ms, true);
+	m_remaining_lifespan -= ms;
+}
+
+void ParticleFeedback::simulate(float ms, bool step) {
+	GLint starts[MAX_EMIT_COMMANDS], counts[MAX_EMIT_COMMANDS];
+	vec3 colors[MAX_EMIT_COMMANDS];
+	float origins[MAX_EMIT_COMMANDS * 4], angles[MAX_EMIT_COMMANDS];
+	for (int i = 0; i < m_num_commands; i++) {
+		const EmitCommand& command = m_commands[i];
+		starts[i] = command.start;
+		counts[i] = command.count;
+		colors[i] = command.color;
+		origins[i * 4 + 0] = command.position.x;
+		origins[i * 4 + 1] = command.position.y;
+		origins[i * 4 + 2] = command.scale;
+		origins[i * 4 + 3] = command.lifespan;
+		angles[i] = command.angle;
+	}
+
+	GLuint program = m_sim_effect.program;
+	glUseProgram(program);
+	glUniform1i(glGetUniformLocation(program, "num_commands"), m_num_commands);
+	if (m_num_commands > 0) {
+		glUniform1iv(glGetUniformLocation(program, "emit_start"), m_num_commands, starts);
+		glUniform1iv(glGetUniformLocation(program, "emit_count"), m_num_commands, counts);
+		glUniform4fv(glGetUniformLocation(program, "emit_origin"), m_num_commands, origins);
+		glUniform3fv(glGetUniformLocation(program, "emit_color"), m_num_commands, (float*)colors);
+		glUniform1fv(glGetUniformLocation(program, "emit_angle"), m_num_commands, angles);
+	}
+	glUniform1i(glGetUniformLocation(program, "capacity"), MAX_PARTICLES);
+	glUniform1ui(glGetUniformLocation(program, "seed"), m_seed++ * 2654435761u);
+	glUniform1f(glGetUniformLocation(program, "elapsed_ms"), ms);
+	glUniform1i(glGetUniformLocation(program, "step"), step);
+
+	int next = 1 - m_current;
+	glEnable(GL_RASTERIZER_DISCARD);
+	glBindVertexArray(m_sim_vaos[m_current]);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_state_vbos[next]);
+	glBeginTransformFeedback(GL_POINTS);
+	glDrawArrays(GL_POINTS, 0, m_active_slots);
+	glEndTransformFeedback();
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+	glBindVertexArray(0);
+	glDisable(GL_RASTERIZER_DISCARD);
+
+	// Slots only join the active range through a spawn in the same pass, so every
+	// active slot of the new buffer has just been written
+	m_current = next;
+	m_simulated_slots = m_active_slots;
+	m_num_commands = 0;
+}
+
+void ParticleFeedback::draw(const mat3 &projection) {
+	if (m_remaining_lifespan < 0.f || m_simulated_slots == 0)
+		return;
+
+	gl_use_program(m_draw_effect.program);
+	GLint projection_uloc = glGetUniformLocation(m_draw_effect.program, "projection");
+	glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
+
+	gl_bind_vertex_array(m_draw_vaos[m_current]);
+	gl_draw_arrays_instanced(GL_TRIANGLE_STRIP, 0, 4, m_simulated_slots);
+	gl_bind_vertex_array(0);
+}
+
+void ParticleFeedback::clear() {
+	// Stale slots are never simulated or drawn until a new burst spawns into them
+	m_current = 0;
+	m_num_commands = 0;
+	m_next_slot = 0;
+	m_active_slots = 0;
+	m_simulated_slots = 0;
+	m_remaining_lifespan = -1.f;
+	m_seed = 1;
+}
+
+int ParticleFeedback::get_alive_particles() const {
+	// The exact count lives on the GPU, report the slots that may still be alive
+	return (m_remaining_lifespan < 0.f) ? 0 : m_active_slots;
+}
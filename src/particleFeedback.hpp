@@ -0,0 +1,63 @@
+#pragma once
+#include "common.hpp"
+#include "particleEmitter.hpp"
+
+// GPU particle backend. Particle state lives in two buffers that are ping-ponged
+// through a transform feedback pass every update; the CPU only queues emit
+// commands. Used by ParticleSystem when enabled and supported, otherwise the
+// CPU pool is used instead.
+class ParticleFeedback {
+public:
+	static const int MAX_PARTICLES = 65536;
+	static const int MAX_EMIT_COMMANDS = 16; // must match particleSim.vs.glsl
+
+	ParticleFeedback();
+
+	bool init();
+	void destroy();
+
+	void emit(const ParticleEmitter& emitter);
+	void update(float ms);
+	void draw(const mat3 &projection);
+	void clear();
+	int get_alive_particles() const;
+
+private:
+	// Matches the interleaved varyings of particleSim.vs.glsl
+	struct GpuParticle {
+		vec2 position;
+		vec2 velocity;
+		float life;
+		float scale;
+		vec3 color;
+	};
+
+	struct EmitCommand {
+		vec2 position;
+		float scale;
+		float lifespan;
+		vec3 color;
+		float angle; // negative for random
+		int start;
+		int count;
+	};
+
+	void simulate(float ms, bool step);
+
+	Effect m_sim_effect;
+	Effect m_draw_effect;
+	GLuint m_quad_vbo;
+	GLuint m_state_vbos[2];
+	GLuint m_sim_vaos[2];
+	GLuint m_draw_vaos[2];
+	int m_current; // buffer holding the latest state
+
+	EmitCommand m_commands[MAX_EMIT_COMMANDS];
+	int m_num_commands;
+	int m_next_slot;
+	int m_active_slots; // slots that have ever held a particle
+	int m_simulated_slots; // active slots as of the latest pass
+	float m_remaining_lifespan; // until the last emitted particle expires
+	unsigned int m_seed;
+	bool m_initialized;
+};
@@ -0,0 +1,203 @@
+#include "particleSystem.hpp"
+#include "renderQueue.hpp"
+#include "gpuProfiler.hpp"
+
+#include <cstddef>
+
+static const vec3 quad_vertex_buffer_data[] = {
+	{ -0.5f, -0.5f, -0.01f },
+	{ 0.5f, -0.5f, -0.01f },
+	{ -0.5f,  0.5f, -0.01f },
+	{ 0.5f,  0.5f, -0.01f },
+};
+
+bool ParticleSystem::init(bool use_gpu) {
+	m_use_feedback = use_gpu && m_feedback.init();
+	if (use_gpu && !m_use_feedback)
+		fprintf(stderr, "GPU particles unavailable, falling back to CPU particles\n");
+
+	m_pool.assign(MAX_PARTICLES, Particle());
+	m_instances.resize(MAX_PARTICLES);
+	m_tail = 0;
+	m_count = 0;
+	m_num_alive_particles = 0;
+
+	// Clearing errors
+	gl_flush_errors();
+
+	// Loading shaders
+	if (!effect.load_from_file(shader_path("particle.vs.glsl"), shader_path("particle.fs.glsl")))
+		return false;
+
+	glGenVertexArrays(1, &mesh.vao);
+	glBindVertexArray(mesh.vao);
+
+	// Shared unit quad
+	glGenBuffers(1, &mesh.vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertex_buffer_data), quad_vertex_buffer_data, GL_STATIC_DRAW);
+	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
+	glEnableVertexAttribArray(in_position_loc);
+	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(vec3), (void*)0);
+
+	// Per-particle attributes, refilled every frame
+	glGenBuffers(1, &m_instance_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, m_instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance) * MAX_PARTICLES, nullptr, GL_STREAM_DRAW);
+	GLint in_offset_loc = glGetAttribLocation(effect.program, "in_offset");
+	GLint in_scale_loc = glGetAttribLocation(effect.program, "in_scale");
+	GLint in_color_loc = glGetAttribLocation(effect.program, "in_color");
+	glEnableVertexAttribArray(in_offset_loc);
+	glEnableVertexAttribArray(in_scale_loc);
+	glEnableVertexAttribArray(in_color_loc);
+	glVertexAttribPointer(in_offset_loc, 2, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, position));
+	glVertexAttribPointer(in_scale_loc, 1, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, scale));
+	glVertexAttribPointer(in_color_loc, 3, GL_FLOAT, GL_FALSE, sizeof(ParticleInstance), (void*)offsetof(ParticleInstance, color));
+	glVertexAttribDivisor(in_offset_loc, 1);
+	glVertexAttribDivisor(in_scale_loc, 1);
+	glVertexAttribDivisor(in_color_loc, 1);
+
+	glBindVertexArray(0);
+
+	return !gl_has_errors();
+}
+
+void ParticleSystem::destroy() {
+	glDeleteBuffers(1, &mesh.vbo);
+	glDeleteBuffers(1, &m_instance_vbo);
+	glDeleteVertexArrays(1, &mesh.vao);
+	effect.release();
+	if (m_use_feedback)
+		m_feedback.destroy();
+	clear();
+}
+
+void ParticleSystem::emit(const ParticleEmitter& emitter) {
+	if (m_use_feedback) {
+		m_feedback.emit(emitter);
+		return;
+	}
+
+	for (int i = 0; i < emitter.m_max_particles; i++) {
+		if (m_count == MAX_PARTICLES) {
+			// full, recycle the oldest particle
+			if (m_pool[m_tail].get_is_alive())
+				m_num_alive_particles--;
+			m_tail = (m_tail + 1) % MAX_PARTICLES;
+			m_count--;
+		}
+		emitter.spawn(m_pool[(m_tail + m_count) % MAX_PARTICLES]);
+		m_count++;
+		m_num_alive_particles++;
+	}
+}
+
+void ParticleSystem::update(float ms) {
+	if (m_use_feedback) {
+		m_feedback.update(ms);
+		return;
+	}
+
+	for (int i = 0; i < m_count; i++) {
+		Particle& particle = m_pool[(m_tail + i) % MAX_PARTICLES];
+		if (!particle.get_is_alive())
+			continue;
+		particle.update(ms);
+		if (!particle.get_is_alive())
+			m_num_alive_particles--;
+	}
+
+	// Particles die roughly in the order they were emitted, so reclaim from the tail
+	while (m_count > 0 && !m_pool[m_tail].get_is_alive()) {
+		m_tail = (m_tail + 1) % MAX_PARTICLES;
+		m_count--;
+	}
+}
+
+void ParticleSystem::draw(const mat3 &projection) {
+	if (m_use_feedback) {
+		GPU_PROFILE_ZONE("particles");
+		m_feedback.draw(projection);
+		return;
+	}
+
+	ParticleFrame frame;
+	frame.instances.swap(m_instances);
+	capture(frame);
+	draw_instances(projection, frame.instances);
+	frame.instances.swap(m_instances);
+}
+
+void ParticleSystem::capture(ParticleFrame& frame) const {
+	frame.system = const_cast<ParticleSystem*>(this);
+	frame.gpu_simulated = m_use_feedback;
+	frame.instances.clear();
+	if (m_use_feedback)
+		return;
+
+	for (int i = 0; i < m_count; i++) {
+		const Particle& particle = m_pool[(m_tail + i) % MAX_PARTICLES];
+		if (!particle.get_is_alive())
+			continue;
+		ParticleInstance instance;
+		instance.position = particle.m_position;
+		instance.scale = particle.m_scale;
+		instance.color = particle.m_color;
+		frame.instances.push_back(instance);
+	}
+}
+
+void ParticleSystem::draw_instances(const mat3 &projection, const std::vector<ParticleInstance>& instances) {
+	GPU_PROFILE_ZONE("particles");
+
+	int num_instances = (int)instances.size();
+	if (num_instances == 0)
+		return;
+
+	gl_use_program(effect.program);
+	GLint projection_uloc = glGetUniformLocation(effect.program, "projection");
+	glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
+
+	// Orphan the previous frame's data before refilling
+	gl_bind_buffer(GL_ARRAY_BUFFER, m_instance_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(ParticleInstance) * MAX_PARTICLES, nullptr, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(ParticleInstance) * num_instances, instances.data());
+
+	gl_bind_vertex_array(mesh.vao);
+	gl_draw_arrays_instanced(GL_TRIANGLE_STRIP, 0, 4, num_instances);
+	gl_bind_vertex_array(0);
+}
+
+void ParticleSystem::clear() {
+	m_feedback.clear();
+	for (auto& particle : m_pool)
+		particle.m_is_alive = false;
+	m_tail = 0;
+	m_count = 0;
+	m_num_alive_particles = 0;
+}
+
+int ParticleSystem::get_alive_particles() const {
+	return m_use_feedback ? m_feedback.get_alive_particles() : m_num_alive_particles;
+}
+
+bool ParticleSystem::is_gpu_simulated() const {
+	return m_use_feedback;
+}
+
+void ParticleSystem::submit(RenderQueue &queue) {
+	if (get_alive_particles() > 0)
+		queue.submit_custom(LAYER_PARTICLES, this);
+}
+
+void ParticleFrame::draw(const mat3 &projection) {
+	if (gpu_simulated)
+		system->draw(projection);
+	else
+		system->draw_instances(projection, instances);
+}
+
+void ParticleFrame::submit(RenderQueue &queue) {
+	if (gpu_simulated ? system->get_alive_particles() > 0 : !instances.empty())
+		queue.submit_custom(LAYER_PARTICLES, this);
+}
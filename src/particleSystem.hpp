@@ -0,0 +1,62 @@
+#pragma once
+#include "common.hpp"
+#include "particle.hpp"
+#include "particleEmitter.hpp"
+#include "particleFeedback.hpp"
+
+#include <vector>
+
+class ParticleSystem;
+
+// Per-instance data uploaded to the GPU, matches particle.vs.glsl
+struct ParticleInstance {
+	vec2 position;
+	float scale;
+	vec3 color;
+};
+
+// The live particles of one frame, captured by the simulation and drawn later,
+// possibly on another thread, through the system that owns the GL objects
+struct ParticleFrame : public Renderable {
+	ParticleSystem* system = nullptr;
+	std::vector<ParticleInstance> instances;
+	bool gpu_simulated = false; // the particles never leave the GPU, drawn live
+
+	void draw(const mat3 &projection) override;
+	void submit(RenderQueue &queue) override;
+};
+
+// World-owned particle manager. All bursts share a fixed-capacity ring buffer of
+// particles and are drawn with a single instanced draw call, so emitting a burst
+// never allocates or creates GL objects. Optionally simulates on the GPU through
+// ParticleFeedback, falling back to the CPU pool when that is unavailable.
+class ParticleSystem : public Renderable {
+public:
+	static const int MAX_PARTICLES = 4096;
+
+	bool init(bool use_gpu = false);
+	void destroy();
+
+	// Spawns every particle of the burst; overwrites the oldest particles when full
+	void emit(const ParticleEmitter& emitter);
+	void update(float ms);
+	void draw(const mat3 &projection);
+	void submit(RenderQueue &queue);
+	// Copies the live particles into frame, no GL calls
+	void capture(ParticleFrame& frame) const;
+	void draw_instances(const mat3 &projection, const std::vector<ParticleInstance>& instances);
+	void clear();
+	int get_alive_particles() const;
+	bool is_gpu_simulated() const;
+
+private:
+	std::vector<Particle> m_pool;
+	std::vector<ParticleInstance> m_instances;
+	int m_tail; // oldest particle
+	int m_count;
+	int m_num_alive_particles;
+	GLuint m_instance_vbo;
+
+	ParticleFeedback m_feedback;
+	bool m_use_feedback;
+};
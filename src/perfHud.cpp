@@ -0,0 +1,243 @@
+// Header
+#include "perfHud.hpp"
+#include "allocTracker.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+
+namespace
+{
+	const float GRAPH_HEIGHT = 70.f;
+	const float GRAPH_PX_PER_MS = 2.f;
+	const float BAR_WIDTH = (float)PerfHud::WIDTH / PerfHud::GRAPH_FRAMES;
+	const int TEXT_LINES = 7;
+	const float LINE_HEIGHT = 18.f;
+	const int TEXT_HEIGHT = (int)(TEXT_LINES * LINE_HEIGHT) + 8;
+	const double TEXT_INTERVAL = 0.25; // seconds between two text refreshes
+	const float TARGET_FRAME_MS = 1000.f / 60.f;
+
+	const float PANEL_COLOR[4] = { 0.f, 0.f, 0.f, 0.6f };
+	const float TARGET_LINE_COLOR[4] = { 1.f, 1.f, 1.f, 0.5f };
+	const float FAST_COLOR[4] = { 0.2f, 0.9f, 0.2f, 1.f };
+	const float SLOW_COLOR[4] = { 1.f, 0.8f, 0.f, 1.f };
+	const float DROPPED_COLOR[4] = { 1.f, 0.2f, 0.2f, 1.f };
+	const float WHITE[4] = { 1.f, 1.f, 1.f, 1.f };
+
+	// 2D projection with y going down, as in World::draw
+	mat3 pixel_projection(float width, float height)
+	{
+		return { { 2.f / width, 0.f, 0.f }, { 0.f, -2.f / height, 0.f }, { -1.f, 1.f, 1.f } };
+	}
+}
+
+bool PerfHud::init()
+{
+	m_text.reset(new TextRenderer(mainFont, 16));
+	m_text->setColor({ 1.f, 1.f, 1.f });
+
+	gl_flush_errors();
+
+	// Text cache
+	glGenTextures(1, &m_text_texture);
+	glBindTexture(GL_TEXTURE_2D, m_text_texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, WIDTH, TEXT_HEIGHT, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+
+	glGenFramebuffers(1, &m_text_frame_buffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_text_frame_buffer);
+	glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, m_text_texture, 0);
+	bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, gl_screen_framebuffer());
+	if (!complete)
+	{
+		fprintf(stderr, "Failed to create the performance HUD text target\n");
+		return false;
+	}
+
+	if (!effect.load_from_file(shader_path("hud.vs.glsl"), shader_path("hud.fs.glsl")))
+		return false;
+
+	// Vertices are streamed every frame
+	glGenBuffers(1, &mesh.vbo);
+	glGenVertexArrays(1, &mesh.vao);
+	mesh.ibo = 0;
+	glBindVertexArray(mesh.vao);
+	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
+	GLint in_texcoord_loc = glGetAttribLocation(effect.program, "in_texcoord");
+	GLint in_color_loc = glGetAttribLocation(effect.program, "in_color");
+	glEnableVertexAttribArray(in_position_loc);
+	glEnableVertexAttribArray(in_texcoord_loc);
+	glEnableVertexAttribArray(in_color_loc);
+	glVertexAttribPointer(in_position_loc, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)offsetof(HudVertex, position));
+	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)offsetof(HudVertex, texcoord));
+	glVertexAttribPointer(in_color_loc, 4, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (void*)offsetof(HudVertex, color));
+	glBindVertexArray(0);
+
+	// Panel, target line, text and a bar per frame
+	m_vertices.reserve((GRAPH_FRAMES + 3) * 6);
+
+	// Raw binds above went around the state cache
+	gl_state_invalidate();
+	return !gl_has_errors();
+}
+
+void PerfHud::destroy()
+{
+	if (m_text == nullptr)
+		return;
+
+	set_visible(false);
+	m_text.reset();
+	glDeleteFramebuffers(1, &m_text_frame_buffer);
+	glDeleteTextures(1, &m_text_texture);
+	glDeleteBuffers(1, &mesh.vbo);
+	glDeleteVertexArrays(1, &mesh.vao);
+	effect.release();
+}
+
+void PerfHud::set_visible(bool visible)
+{
+	if (visible && !m_visible)
+	{
+		// Start a fresh graph, the frames from before were not recorded
+		m_frame_count = 0;
+		m_next_frame = 0;
+		m_text_time = 0.0;
+		alloc_tracker_enable();
+	}
+	else if (!visible && m_visible)
+		alloc_tracker_disable();
+	m_visible = visible;
+}
+
+void PerfHud::set_position(vec2 position)
+{
+	m_position = position;
+}
+
+void PerfHud::add_frame(const PerfFrameStats& stats)
+{
+	m_frames[m_next_frame] = stats;
+	m_next_frame = (m_next_frame + 1) % GRAPH_FRAMES;
+	m_frame_count = std::min(m_frame_count + 1, (int)GRAPH_FRAMES);
+}
+
+void PerfHud::render_text()
+{
+	if (m_frame_count == 0)
+		return;
+
+	const PerfFrameStats& last = m_frames[(m_next_frame + GRAPH_FRAMES - 1) % GRAPH_FRAMES];
+	float total_ms = 0.f;
+	float max_ms = 0.f;
+	for (int i = 0; i < m_frame_count; i++)
+	{
+		total_ms += m_frames[i].frame_ms;
+		max_ms = std::max(max_ms, m_frames[i].frame_ms);
+	}
+	float average_ms = total_ms / m_frame_count;
+
+	char lines[TEXT_LINES][96];
+	snprintf(lines[0], sizeof(lines[0]), "frame %.1f ms avg  %.1f max  %d fps", average_ms, max_ms, average_ms > 0.f ? (int)(1000.f / average_ms + 0.5f) : 0);
+	snprintf(lines[1], sizeof(lines[1]), "update %.2f ms  draw %.2f ms", last.update_ms, last.draw_ms);
+	snprintf(lines[2], sizeof(lines[2]), "draw calls %d  gl state %d  elided %d", last.draw_calls, last.state_changes, last.state_changes_elided);
+	snprintf(lines[3], sizeof(lines[3]), "attacks %d  particles %d", last.attacks, last.particles);
+	snprintf(lines[4], sizeof(lines[4]), "broadphase queries %d", last.broadphase_queries);
+	snprintf(lines[5], sizeof(lines[5]), "heap allocs %d  (%.1f KB)", last.allocations, last.allocated_bytes / 1024.f);
+	snprintf(lines[6], sizeof(lines[6]), "%s  jitter %.2f  p99 %.1f  missed %d", FramePacer::get_mode_name(last.present_mode),
+		last.pacing.jitter_ms, last.pacing.p99_ms, last.pacing.missed);
+
+	// Keep the screen viewport for the rest of the frame
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	GLint frame_buffer = 0;
+	glGetIntegerv(GL_FRAMEBUFFER_BINDING, &frame_buffer);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_text_frame_buffer);
+	glViewport(0, 0, WIDTH, TEXT_HEIGHT);
+	glClearColor(0.f, 0.f, 0.f, 0.f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	mat3 projection = pixel_projection((float)WIDTH, (float)TEXT_HEIGHT);
+	for (int i = 0; i < TEXT_LINES; i++)
+	{
+		// Positions are baselines
+		m_text->setPosition({ 6.f, LINE_HEIGHT * (i + 1) });
+		m_text->renderString(projection, lines[i]);
+	}
+
+	glBindFramebuffer(GL_FRAMEBUFFER, frame_buffer);
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+}
+
+void PerfHud::push_quad(float x0, float y0, float x1, float y1, vec2 uv0, vec2 uv1, const float color[4])
+{
+	HudVertex corners[4] = {
+		{ { x0, y0 }, { uv0.x, uv0.y }, { color[0], color[1], color[2], color[3] } },
+		{ { x1, y0 }, { uv1.x, uv0.y }, { color[0], color[1], color[2], color[3] } },
+		{ { x1, y1 }, { uv1.x, uv1.y }, { color[0], color[1], color[2], color[3] } },
+		{ { x0, y1 }, { uv0.x, uv1.y }, { color[0], color[1], color[2], color[3] } },
+	};
+	m_vertices.push_back(corners[0]);
+	m_vertices.push_back(corners[1]);
+	m_vertices.push_back(corners[2]);
+	m_vertices.push_back(corners[0]);
+	m_vertices.push_back(corners[2]);
+	m_vertices.push_back(corners[3]);
+}
+
+void PerfHud::draw(const mat3& projection)
+{
+	if (!m_visible)
+		return;
+
+	gl_disable(GL_DEPTH_TEST);
+	gl_enable(GL_BLEND);
+	gl_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	double now = glfwGetTime();
+	if (now - m_text_time >= TEXT_INTERVAL)
+	{
+		render_text();
+		m_text_time = now;
+	}
+
+	const vec2 untextured = { -1.f, -1.f };
+	float x = m_position.x;
+	float y = m_position.y;
+	float graph_bottom = y + GRAPH_HEIGHT;
+
+	m_vertices.clear();
+	push_quad(x, y, x + WIDTH, graph_bottom + TEXT_HEIGHT, untextured, untextured, PANEL_COLOR);
+
+	// Oldest frame on the left
+	for (int i = 0; i < m_frame_count; i++)
+	{
+		int frame = (m_next_frame - m_frame_count + i + GRAPH_FRAMES) % GRAPH_FRAMES;
+		float ms = m_frames[frame].frame_ms;
+		float height = std::min(ms * GRAPH_PX_PER_MS, GRAPH_HEIGHT);
+		const float* color = ms <= TARGET_FRAME_MS * 1.05f ? FAST_COLOR : (ms <= TARGET_FRAME_MS * 2.05f ? SLOW_COLOR : DROPPED_COLOR);
+		float bar_x = x + (GRAPH_FRAMES - m_frame_count + i) * BAR_WIDTH;
+		push_quad(bar_x, graph_bottom - height, bar_x + BAR_WIDTH, graph_bottom, untextured, untextured, color);
+	}
+
+	float target_y = graph_bottom - TARGET_FRAME_MS * GRAPH_PX_PER_MS;
+	push_quad(x, target_y, x + WIDTH, target_y + 1.f, untextured, untextured, TARGET_LINE_COLOR);
+
+	// The text texture was rendered with y going down, its first row is the bottom
+	push_quad(x, graph_bottom, x + WIDTH, graph_bottom + TEXT_HEIGHT, { 0.f, 1.f }, { 1.f, 0.f }, WHITE);
+
+	gl_use_program(effect.program);
+	glUniformMatrix3fv(glGetUniformLocation(effect.program, "projection"), 1, GL_FALSE, (float*)&projection);
+	glUniform1i(glGetUniformLocation(effect.program, "text_texture"), 0);
+	gl_active_texture(GL_TEXTURE0);
+	gl_bind_texture(GL_TEXTURE_2D, m_text_texture);
+
+	gl_bind_vertex_array(mesh.vao);
+	gl_bind_buffer(GL_ARRAY_BUFFER, mesh.vbo);
+	glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(HudVertex), m_vertices.data(), GL_STREAM_DRAW);
+	gl_draw_arrays(GL_TRIANGLES, 0, (GLsizei)m_vertices.size());
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "common.hpp"
+#include "textRenderer.hpp"
+#include "framePacer.hpp"
+
+#include <memory>
+#include <vector>
+
+// Counters of one frame, a frame being the time between two draws
+struct PerfFrameStats
+{
+	float frame_ms;
+	float update_ms;
+	float draw_ms; // CPU side, up to the buffer swap
+	int draw_calls;
+	int state_changes;
+	int state_changes_elided;
+	int attacks;
+	int particles;
+	int broadphase_queries;
+	int allocations;
+	int allocated_bytes;
+	PresentMode present_mode;
+	FramePacingStats pacing; // over the last few seconds
+};
+
+// Overlay for spotting performance regressions during play: a frame time graph over
+// the per-frame counters. The text only changes a few times a second and is rendered
+// into a texture then, every frame draws that texture, the panel and the graph in a
+// single call.
+class PerfHud : public Renderable
+{
+public:
+	static const int GRAPH_FRAMES = 120;
+	static const int WIDTH = 360;
+
+	bool init();
+	void destroy() override;
+
+	// Also turns allocation counting on and off
+	void set_visible(bool visible);
+	bool is_visible() const { return m_visible; }
+
+	// Top left corner in screen pixels
+	void set_position(vec2 position);
+
+	void add_frame(const PerfFrameStats& stats);
+	void draw(const mat3& projection) override;
+
+private:
+	// Matches the attributes of hud.vs.glsl
+	struct HudVertex
+	{
+		vec2 position;
+		vec2 texcoord;
+		float color[4];
+	};
+
+	void render_text();
+	void push_quad(float x0, float y0, float x1, float y1, vec2 uv0, vec2 uv1, const float color[4]);
+
+	bool m_visible = false;
+	vec2 m_position = { 10.f, 10.f };
+
+	PerfFrameStats m_frames[GRAPH_FRAMES];
+	int m_next_frame = 0;
+	int m_frame_count = 0;
+	double m_text_time = 0.0; // when the text texture was last rendered
+
+	std::unique_ptr<TextRenderer> m_text;
+	GLuint m_text_frame_buffer = 0;
+	GLuint m_text_texture = 0;
+	std::vector<HudVertex> m_vertices;
+};
@@ -0,0 +1,202 @@
+// Header
+#include "perfReplay.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// The fixed set of matches, data/replays/<name>.replay
+	const char* PERF_REPLAYS[] = { "pvc_kitchen", "pvp_oven" };
+
+	// Every replay starts from this seed, so each run does the same work, see set_random_seed()
+	const unsigned PERF_RANDOM_SEED = 1234;
+
+	// Timer noise, time differences below this are never regressions
+	const double MIN_REGRESSION_MS = 0.05;
+
+	struct PerfResult
+	{
+		double ticks_per_second; // world updates per second of update time
+		double update_p50_ms;
+		double update_p99_ms;
+		double draw_p50_ms;
+		double draw_p99_ms;
+	};
+
+	double percentile(std::vector<double>& samples, double fraction)
+	{
+		if (samples.empty())
+			return 0.0;
+		std::sort(samples.begin(), samples.end());
+		size_t index = std::min(samples.size() - 1, (size_t)(fraction * (samples.size() - 1) + 0.5));
+		return samples[index];
+	}
+
+	bool play(World& world, const std::string& name, PerfResult& result)
+	{
+		Replay replay;
+		if (!replay.load_from_file((replays_path("") + name + ".replay").c_str()))
+			return false;
+
+		// Every replay starts from the main menu
+		set_random_seed(PERF_RANDOM_SEED);
+		world.set_paused(false);
+		world.set_mode(MENU);
+
+		std::vector<double> update_ms;
+		std::vector<double> draw_ms;
+		update_ms.reserve(replay.frame_count);
+		draw_ms.reserve(replay.frame_count);
+		double total_update_ms = 0.0;
+
+		size_t next_event = 0;
+		for (int frame = 0; frame < replay.frame_count && !world.is_over(); frame++)
+		{
+			// AI timing and stage effects read the GLFW clock, it follows the replay instead of real time
+			glfwSetTime(frame * replay.frame_ms / 1000.0);
+
+			for (; next_event < replay.events.size() && replay.events[next_event].frame == frame; next_event++)
+			{
+				const ReplayEvent& event = replay.events[next_event];
+				world.inject_key(event.key, event.action, event.mods);
+			}
+
+			uint64_t start_ns = profiler_now_ns();
+			world.update(replay.frame_ms);
+			uint64_t update_end_ns = profiler_now_ns();
+			world.draw();
+			uint64_t draw_end_ns = profiler_now_ns();
+
+			update_ms.push_back((update_end_ns - start_ns) / 1e6);
+			draw_ms.push_back((draw_end_ns - update_end_ns) / 1e6);
+			total_update_ms += update_ms.back();
+		}
+
+		result.ticks_per_second = total_update_ms > 0.0 ? update_ms.size() * 1000.0 / total_update_ms : 0.0;
+		result.update_p50_ms = percentile(update_ms, 0.5);
+		result.update_p99_ms = percentile(update_ms, 0.99);
+		result.draw_p50_ms = percentile(draw_ms, 0.5);
+		result.draw_p99_ms = percentile(draw_ms, 0.99);
+		return true;
+	}
+
+	// One line per replay: name ticks_per_second update_p50 update_p99 draw_p50 draw_p99,
+	// lines starting with # are comments
+	std::map<std::string, PerfResult> load_baseline(const char* path)
+	{
+		std::map<std::string, PerfResult> baseline;
+		std::ifstream file(path);
+		std::string line;
+		while (std::getline(file, line))
+		{
+			if (line.empty() || line[0] == '#')
+				continue;
+			std::istringstream fields(line);
+			std::string name;
+			PerfResult result;
+			if (fields >> name >> result.ticks_per_second >> result.update_p50_ms >> result.update_p99_ms >> result.draw_p50_ms >> result.draw_p99_ms)
+				baseline[name] = result;
+			else
+				fprintf(stderr, "Skipping malformed baseline line: %s\n", line.c_str());
+		}
+		return baseline;
+	}
+
+	bool save_baseline(const char* path, const std::map<std::string, PerfResult>& results)
+	{
+		FILE* file = fopen(path, "w");
+		if (file == nullptr)
+		{
+			fprintf(stderr, "Failed to open %s for writing\n", path);
+			return false;
+		}
+
+		fprintf(file, "# Written by --perf-update-baseline, times in ms\n");
+		fprintf(file, "# Timings are per machine: record this file on the machine running --perf-replay,\n");
+		fprintf(file, "# replays missing here are only reported\n");
+		fprintf(file, "# replay ticks_per_second update_p50 update_p99 draw_p50 draw_p99\n");
+		for (const auto& entry : results)
+		{
+			const PerfResult& r = entry.second;
+			fprintf(file, "%s %.1f %.4f %.4f %.4f %.4f\n", entry.first.c_str(),
+				r.ticks_per_second, r.update_p50_ms, r.update_p99_ms, r.draw_p50_ms, r.draw_p99_ms);
+		}
+
+		bool ok = ferror(file) == 0;
+		fclose(file);
+		return ok;
+	}
+
+	bool check_time(const std::string& name, const char* metric, double value, double baseline, float tolerance)
+	{
+		if (value <= baseline * (1.0 + tolerance) + MIN_REGRESSION_MS)
+			return true;
+		fprintf(stderr, "REGRESSION %s: %s %.3f ms, baseline %.3f ms\n", name.c_str(), metric, value, baseline);
+		return false;
+	}
+
+	bool check(const std::string& name, const PerfResult& result, const PerfResult& baseline, float tolerance)
+	{
+		bool ok = true;
+		if (result.ticks_per_second < baseline.ticks_per_second * (1.0 - tolerance))
+		{
+			fprintf(stderr, "REGRESSION %s: %.0f ticks/s, baseline %.0f ticks/s\n", name.c_str(), result.ticks_per_second, baseline.ticks_per_second);
+			ok = false;
+		}
+		ok = check_time(name, "update p50", result.update_p50_ms, baseline.update_p50_ms, tolerance) && ok;
+		ok = check_time(name, "update p99", result.update_p99_ms, baseline.update_p99_ms, tolerance) && ok;
+		ok = check_time(name, "draw p50", result.draw_p50_ms, baseline.draw_p50_ms, tolerance) && ok;
+		ok = check_time(name, "draw p99", result.draw_p99_ms, baseline.draw_p99_ms, tolerance) && ok;
+		return ok;
+	}
+}
+
+int run_perf_replays(World& world, const PerfReplayOptions& options)
+{
+	const char* baseline_path = replays_path("baseline.txt");
+	std::map<std::string, PerfResult> baseline = load_baseline(baseline_path);
+
+	bool ok = true;
+	int unchecked = 0;
+	std::map<std::string, PerfResult> results;
+	for (const char* name : PERF_REPLAYS)
+	{
+		PerfResult result;
+		if (!play(world, name, result))
+		{
+			ok = false;
+			continue;
+		}
+		results[name] = result;
+		fprintf(stderr, "%-14s %10.0f ticks/s  update p50 %.3f p99 %.3f ms  draw p50 %.3f p99 %.3f ms\n", name,
+			result.ticks_per_second, result.update_p50_ms, result.update_p99_ms, result.draw_p50_ms, result.draw_p99_ms);
+
+		if (options.update_baseline)
+			continue;
+		auto it = baseline.find(name);
+		if (it == baseline.end())
+			unchecked++;
+		else
+			ok = check(name, result, it->second, options.tolerance) && ok;
+	}
+
+	// Back to random seeds for whatever runs next
+	set_random_seed(0);
+
+	// Timings from another machine mean nothing here, so no baseline only reports
+	if (unchecked > 0)
+		fprintf(stderr, "No baseline for %d replays, only reported. Record one on this machine with --perf-update-baseline\n", unchecked);
+
+	if (options.update_baseline)
+	{
+		if (!ok || !save_baseline(baseline_path, results))
+			return EXIT_FAILURE;
+		fprintf(stderr, "Wrote %s\n", baseline_path);
+	}
+
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "world.hpp"
+
+// Performance regression gate: plays the recorded matches in data/replays through a
+// headless world as fast as it goes, then compares update throughput and the p50 / p99
+// update and draw times against data/replays/baseline.txt.
+//
+// Timings only compare on the machine that recorded them, so the baseline is recorded
+// locally with --perf-update-baseline and none is checked in. A replay without a baseline
+// is only reported. Replays run with one job worker, a fixed random seed and a clock that
+// follows the replay, so every run does the same work.
+
+struct PerfReplayOptions
+{
+	// Allowed slowdown before a metric counts as a regression, 0.25 is 25%
+	float tolerance = 0.25f;
+	// Writes the measured timings as the new baseline instead of comparing
+	bool update_baseline = false;
+};
+
+// Expects a world initialized with set_headless(true), returns the process exit code
+int run_perf_replays(World& world, const PerfReplayOptions& options);
@@ -1,5 +1,6 @@
 
 #include "platform.hpp"
+#include "renderQueue.hpp"
 
 Texture Platform::platform_texture;
 
@@ -147,6 +148,7 @@ bool Platform::init() {
 	glBufferData(GL_ARRAY_BUFFER, sizeof(TexturedVertex) * 4, vertices, GL_STATIC_DRAW);
 
 	// Index Buffer creation
+	gl_bind_vertex_array(0);
 	glGenBuffers(1, &mesh.ibo);
 	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
 	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * 6, indices, GL_STATIC_DRAW);
@@ -168,9 +170,7 @@ bool Platform::init() {
 void Platform::destroy() {
 	glDeleteBuffers(1, &mesh.vbo);
 	glDeleteBuffers(1, &mesh.ibo);
-	glDeleteBuffers(1, &mesh.vao);
 	glDeleteVertexArrays(1, &mesh.vao);
-	glDisableVertexAttribArray(0);
 
 	glDeleteShader(effect.vertex);
 	glDeleteShader(effect.fragment);
@@ -190,12 +190,12 @@ void Platform::draw(const mat3 &projection) {
 	transform_end();
 
 	// Setting shaders
-	glUseProgram(effect.program);
+	gl_use_program(effect.program);
 
 	// Enabling alpha channel for textures
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glDisable(GL_DEPTH_TEST);
+	gl_enable(GL_BLEND);
+	gl_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	gl_disable(GL_DEPTH_TEST);
 
 	// Getting uniform locations for glUniform* calls
 	GLint transform_uloc = glGetUniformLocation(effect.program, "transform");
@@ -205,9 +205,9 @@ void Platform::draw(const mat3 &projection) {
 	GLuint time_uloc = glGetUniformLocation(effect.program, "time");
 
 	// Setting vertices and indices
-	glBindVertexArray(mesh.vao);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+	gl_bind_vertex_array(mesh.vao);
+	gl_bind_buffer(GL_ARRAY_BUFFER, mesh.vbo);
+	gl_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
 
 	// Input data location as in the vertex buffer
 	GLint in_position_loc = glGetAttribLocation(effect.program, "in_position");
@@ -218,8 +218,8 @@ void Platform::draw(const mat3 &projection) {
 	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void *)sizeof(vec3));
 
 	// Enabling and binding texture to slot 0
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, platform_texture.id);
+	gl_active_texture(GL_TEXTURE0);
+	gl_bind_texture(GL_TEXTURE_2D, platform_texture.id);
 
 	// Setting uniform values to the currently bound program
 	glUniformMatrix3fv(transform_uloc, 1, GL_FALSE, (float *)&transform);
@@ -229,5 +229,13 @@ void Platform::draw(const mat3 &projection) {
 	glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
 
 	// Drawing!
-	glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
-}
\ No newline at end of file
+	gl_draw_elements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+}
+
+void Platform::submit(RenderQueue &queue) {
+	transform_begin();
+	transform_translate(m_position);
+	transform_end();
+
+	queue.submit_sprite(LAYER_PLATFORMS, platform_texture, transform, { 0.f, 0.f }, m_size);
+}
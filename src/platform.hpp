@@ -17,6 +17,7 @@ public:
 	bool init();
 	void destroy();
 	void draw(const mat3 &projection);
+	void submit(RenderQueue &queue);
 private:
 	BoundingBox m_bounding_box;
 	
@@ -0,0 +1,449 @@
+// Header
+#include "postProcess.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+void RenderTargetPool::destroy()
+{
+	for (RenderTarget* target : m_targets)
+	{
+		glDeleteFramebuffers(1, &target->frame_buffer);
+		glDeleteTextures(1, &target->texture);
+		if (target->depth_render_buffer != 0)
+			glDeleteRenderbuffers(1, &target->depth_render_buffer);
+		delete target;
+	}
+	m_targets.clear();
+}
+
+RenderTarget* RenderTargetPool::acquire(int width, int height, bool with_depth)
+{
+	for (RenderTarget* target : m_targets)
+	{
+		if (!target->in_use && target->width == width && target->height == height && (target->depth_render_buffer != 0) == with_depth)
+		{
+			target->in_use = true;
+			target->last_used_frame = m_frame;
+			return target;
+		}
+	}
+
+	RenderTarget* target = new RenderTarget();
+	if (!create(*target, width, height, with_depth))
+	{
+		fprintf(stderr, "Failed to create %dx%d render target\n", width, height);
+		delete target;
+		return nullptr;
+	}
+	target->in_use = true;
+	target->last_used_frame = m_frame;
+	m_targets.push_back(target);
+	return target;
+}
+
+void RenderTargetPool::release(RenderTarget* target)
+{
+	if (target != nullptr)
+		target->in_use = false;
+}
+
+void RenderTargetPool::begin_frame()
+{
+	m_frame++;
+}
+
+void RenderTargetPool::trim(int max_idle_frames)
+{
+	for (int i = 0; i < (int)m_targets.size(); i++)
+	{
+		RenderTarget* target = m_targets[i];
+		if (target->in_use || m_frame - target->last_used_frame <= max_idle_frames)
+			continue;
+
+		glDeleteFramebuffers(1, &target->frame_buffer);
+		glDeleteTextures(1, &target->texture);
+		if (target->depth_render_buffer != 0)
+			glDeleteRenderbuffers(1, &target->depth_render_buffer);
+		delete target;
+		m_targets.erase(m_targets.begin() + i);
+		i--;
+	}
+}
+
+bool RenderTargetPool::create(RenderTarget& target, int width, int height, bool with_depth)
+{
+	gl_flush_errors();
+	target.width = width;
+	target.height = height;
+	target.depth_render_buffer = 0;
+
+	glGenFramebuffers(1, &target.frame_buffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, target.frame_buffer);
+
+	// Clamped so distortions near the border do not wrap around
+	glGenTextures(1, &target.texture);
+	glBindTexture(GL_TEXTURE_2D, target.texture);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+	glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, target.texture, 0);
+
+	if (with_depth)
+	{
+		glGenRenderbuffers(1, &target.depth_render_buffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, target.depth_render_buffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.depth_render_buffer);
+	}
+
+	GLenum draw_buffers[1] = {GL_COLOR_ATTACHMENT0};
+	glDrawBuffers(1, draw_buffers);
+
+	bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+	glBindFramebuffer(GL_FRAMEBUFFER, gl_screen_framebuffer());
+
+	// The raw binds above went around the state cache
+	gl_state_invalidate();
+
+	return complete && !gl_has_errors();
+}
+
+bool PostProcessChain::init()
+{
+	// Full screen quad, post.vs.glsl derives the uv from the position
+	static const GLfloat screen_vertex_buffer_data[] = {
+		-1.f, -1.f, 0.f,
+		1.f, -1.f, 0.f,
+		-1.f, 1.f, 0.f,
+		-1.f, 1.f, 0.f,
+		1.f, -1.f, 0.f,
+		1.f, 1.f, 0.f,
+	};
+
+	gl_flush_errors();
+
+	glGenBuffers(1, &m_quad.vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, m_quad.vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(screen_vertex_buffer_data), screen_vertex_buffer_data, GL_STATIC_DRAW);
+
+	glGenVertexArrays(1, &m_quad.vao);
+	glBindVertexArray(m_quad.vao);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
+	glBindVertexArray(0);
+	m_quad.ibo = 0;
+
+	if (gl_has_errors())
+		return false;
+
+	// Fused passes are generated at runtime, keep the shared vertex shader around
+	std::ifstream vs_is(shader_path("post.vs.glsl"));
+	if (!vs_is.good())
+	{
+		fprintf(stderr, "Failed to load shader file %s", shader_path("post.vs.glsl"));
+		return false;
+	}
+	std::stringstream vs_ss;
+	vs_ss << vs_is.rdbuf();
+	m_vertex_source = vs_ss.str();
+
+	return true;
+}
+
+void PostProcessChain::destroy()
+{
+	glDeleteBuffers(1, &m_quad.vbo);
+	glDeleteVertexArrays(1, &m_quad.vao);
+
+	for (Effect& program : m_filter_programs)
+	{
+		if (program.program != 0)
+			program.release();
+	}
+	for (auto& fused : m_fused_programs)
+	{
+		if (fused.second.program != 0)
+			fused.second.release();
+	}
+
+	m_effects.clear();
+	m_snippets.clear();
+	m_filter_programs.clear();
+	m_fused_programs.clear();
+	m_passes.clear();
+	m_passes_dirty = true;
+	m_pool.destroy();
+	m_scene = nullptr;
+}
+
+bool PostProcessChain::add(const PostEffect& effect)
+{
+	if (find(effect.name) >= 0)
+	{
+		fprintf(stderr, "Post effect %s added twice\n", effect.name.c_str());
+		return false;
+	}
+
+	std::ifstream is(effect.shader_path);
+	if (!is.good())
+	{
+		fprintf(stderr, "Failed to load shader file %s", effect.shader_path.c_str());
+		return false;
+	}
+	std::stringstream ss;
+	ss << is.rdbuf();
+
+	Effect program = {0, 0, 0};
+	std::string snippet;
+	if (effect.kind == POST_FILTER)
+	{
+		if (!effect.input.empty() && find(effect.input) < 0)
+		{
+			fprintf(stderr, "Post effect %s reads %s before it is added\n", effect.name.c_str(), effect.input.c_str());
+			return false;
+		}
+		if (!program.load_from_source(m_vertex_source, ss.str()))
+			return false;
+	}
+	else
+	{
+		snippet = ss.str();
+	}
+
+	m_effects.push_back(effect);
+	m_snippets.push_back(snippet);
+	m_filter_programs.push_back(program);
+	m_passes_dirty = true;
+	return true;
+}
+
+void PostProcessChain::set_enabled(const std::string& name, bool enabled)
+{
+	int i = find(name);
+	if (i >= 0 && m_effects[i].enabled != enabled)
+	{
+		m_effects[i].enabled = enabled;
+		m_passes_dirty = true;
+	}
+}
+
+bool PostProcessChain::is_enabled(const std::string& name) const
+{
+	int i = find(name);
+	return i >= 0 && m_effects[i].enabled;
+}
+
+bool PostProcessChain::is_active() const
+{
+	for (const PostEffect& effect : m_effects)
+	{
+		if (effect.enabled)
+			return true;
+	}
+	return false;
+}
+
+void PostProcessChain::begin(int width, int height, float render_scale)
+{
+	m_width = width;
+	m_height = height;
+	m_scene_width = std::max(1, (int)std::round(width * render_scale));
+	m_scene_height = std::max(1, (int)std::round(height * render_scale));
+	m_pool.begin_frame();
+
+	m_scene = m_pool.acquire(m_scene_width, m_scene_height, true);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_scene != nullptr ? m_scene->frame_buffer : gl_screen_framebuffer());
+}
+
+void PostProcessChain::end()
+{
+	if (m_passes_dirty)
+	{
+		build_passes();
+		m_passes_dirty = false;
+	}
+
+	gl_disable(GL_DEPTH_TEST);
+	gl_disable(GL_BLEND);
+
+	RenderTarget* image = m_scene;
+	std::vector<Output>& outputs = m_outputs;
+	outputs.clear();
+	for (int p = 0; p < (int)m_passes.size(); p++)
+	{
+		const Pass& pass = m_passes[p];
+		if (pass.is_filter)
+		{
+			int i = pass.effects[0];
+			const PostEffect& effect = m_effects[i];
+			RenderTarget* input = effect.input.empty() ? image : find_output(outputs, effect.input);
+			int width = std::max(1, (int)std::round(m_scene_width * effect.resolution_scale));
+			int height = std::max(1, (int)std::round(m_scene_height * effect.resolution_scale));
+
+			RenderTarget* target = m_pool.acquire(width, height, false);
+			draw_pass(m_filter_programs[i].program, pass.effects, input, outputs, target);
+			outputs.push_back({ i, target });
+		}
+		else
+		{
+			// build_passes() always ends on a fused pass, that one goes to the screen and
+			// upscales when the scene was drawn smaller
+			bool is_last = p == (int)m_passes.size() - 1;
+			RenderTarget* target = is_last ? nullptr : m_pool.acquire(m_scene_width, m_scene_height, false);
+			draw_pass(pass.fused != nullptr ? pass.fused->program : 0, pass.effects, image, outputs, target);
+
+			m_pool.release(image);
+			image = target;
+		}
+	}
+	m_pass_count = (int)m_passes.size();
+
+	for (Output& output : outputs)
+		m_pool.release(output.target);
+	m_pool.release(image);
+	m_scene = nullptr;
+
+	// Targets left over from a different window size or render scale
+	m_pool.trim(60);
+
+	gl_active_texture(GL_TEXTURE0);
+}
+
+void PostProcessChain::build_passes()
+{
+	std::vector<Pass>& passes = m_passes;
+	passes.clear();
+	Pass fused = { false, {}, nullptr };
+	for (int i = 0; i < (int)m_effects.size(); i++)
+	{
+		const PostEffect& effect = m_effects[i];
+		if (!effect.enabled)
+			continue;
+
+		// A filter on the chain image needs the pending per-pixel effects applied first,
+		// a resample has to read the image as it is at its point in the chain
+		bool flush = (effect.kind == POST_FILTER && effect.input.empty()) || effect.kind == POST_RESAMPLE;
+		if (flush && !fused.effects.empty())
+		{
+			fused.fused = get_fused_program(fused.effects);
+			passes.push_back(fused);
+			fused.effects.clear();
+		}
+
+		if (effect.kind == POST_FILTER)
+			passes.push_back({ true, { i }, nullptr });
+		else
+			fused.effects.push_back(i);
+	}
+
+	// An empty fused pass is a plain copy to the screen
+	fused.fused = get_fused_program(fused.effects);
+	passes.push_back(fused);
+}
+
+Effect* PostProcessChain::get_fused_program(const std::vector<int>& effects)
+{
+	std::string key;
+	for (int i : effects)
+		key += m_effects[i].name + ";";
+
+	auto it = m_fused_programs.find(key);
+	if (it != m_fused_programs.end())
+		return it->second.program != 0 ? &it->second : nullptr;
+
+	std::stringstream fs;
+	fs << "#version 330\n"
+		<< "uniform sampler2D source;\n"
+		<< "uniform vec2 texel_size;\n"
+		<< "uniform float time;\n";
+	// Outputs of the filters before this pass
+	int last = effects.empty() ? 0 : effects.back();
+	for (int i = 0; i < last; i++)
+	{
+		if (m_effects[i].kind == POST_FILTER)
+			fs << "uniform sampler2D " << m_effects[i].name << ";\n";
+	}
+	fs << "in vec2 uv;\n"
+		<< "layout(location = 0) out vec4 color;\n";
+	for (int i : effects)
+		fs << "#line 1 " << i + 1 << "\n" << m_snippets[i] << "\n";
+	fs << "void main()\n{\n"
+		<< "\tcolor = texture(source, uv);\n";
+	for (int i : effects)
+		fs << "\tcolor = " << m_effects[i].name << "(color, uv);\n";
+	fs << "}\n";
+
+	Effect program = {0, 0, 0};
+	if (!program.load_from_source(m_vertex_source, fs.str()))
+	{
+		fprintf(stderr, "Failed to generate post pass %s\n", key.c_str());
+		program = {0, 0, 0};
+	}
+	m_fused_programs[key] = program;
+	return program.program != 0 ? &m_fused_programs[key] : nullptr;
+}
+
+void PostProcessChain::draw_pass(GLuint program, const std::vector<int>& effects, RenderTarget* input, const std::vector<Output>& outputs, RenderTarget* target)
+{
+	if (program == 0 || input == nullptr)
+		return;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, target != nullptr ? target->frame_buffer : gl_screen_framebuffer());
+	if (target != nullptr)
+		glViewport(0, 0, target->width, target->height);
+	else
+		glViewport(0, 0, m_width, m_height);
+
+	gl_use_program(program);
+
+	gl_active_texture(GL_TEXTURE0);
+	gl_bind_texture(GL_TEXTURE_2D, input->texture);
+	glUniform1i(glGetUniformLocation(program, "source"), 0);
+	glUniform2f(glGetUniformLocation(program, "texel_size"), 1.f / input->width, 1.f / input->height);
+	glUniform1f(glGetUniformLocation(program, "time"), (float)glfwGetTime());
+
+	// Earlier filter outputs go on the following units, by name
+	int unit = 1;
+	for (const Output& output : outputs)
+	{
+		GLint uloc = glGetUniformLocation(program, m_effects[output.effect].name.c_str());
+		if (uloc < 0 || output.target == nullptr)
+			continue;
+		gl_active_texture(GL_TEXTURE0 + unit);
+		gl_bind_texture(GL_TEXTURE_2D, output.target->texture);
+		glUniform1i(uloc, unit);
+		unit++;
+	}
+
+	for (int i : effects)
+	{
+		if (m_effects[i].set_uniforms)
+			m_effects[i].set_uniforms(program);
+	}
+
+	gl_bind_vertex_array(m_quad.vao);
+	gl_draw_arrays(GL_TRIANGLES, 0, 6);
+}
+
+RenderTarget* PostProcessChain::find_output(const std::vector<Output>& outputs, const std::string& name) const
+{
+	for (const Output& output : outputs)
+	{
+		if (m_effects[output.effect].name == name)
+			return output.target;
+	}
+	return nullptr;
+}
+
+int PostProcessChain::find(const std::string& name) const
+{
+	for (int i = 0; i < (int)m_effects.size(); i++)
+	{
+		if (m_effects[i].name == name)
+			return i;
+	}
+	return -1;
+}
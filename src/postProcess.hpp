@@ -0,0 +1,143 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// Offscreen color target, optionally with a depth buffer
+struct RenderTarget
+{
+	GLuint frame_buffer;
+	GLuint texture;
+	GLuint depth_render_buffer; // 0 without depth
+	int width;
+	int height;
+	bool in_use;
+	int last_used_frame;
+};
+
+// Keeps offscreen targets alive across frames and hands them out by size, so the
+// passes of a frame share a handful of textures instead of owning one each
+class RenderTargetPool
+{
+public:
+	void destroy();
+
+	// Free target of exactly this size, created when there is none
+	RenderTarget* acquire(int width, int height, bool with_depth);
+	void release(RenderTarget* target);
+
+	// Deletes targets that have not been acquired for a while, e.g. after a resize
+	void begin_frame();
+	void trim(int max_idle_frames);
+
+	int size() const { return (int)m_targets.size(); }
+
+private:
+	bool create(RenderTarget& target, int width, int height, bool with_depth);
+
+	std::vector<RenderTarget*> m_targets;
+	int m_frame = 0;
+};
+
+enum PostEffectKind
+{
+	// Only looks at its own pixel, fused with its neighbours into a single pass
+	POST_PIXEL,
+	// Per-pixel, but reads the pass input at a moved coordinate (distortion), so it
+	// can only be fused when it comes first in the pass
+	POST_RESAMPLE,
+	// Samples a neighbourhood (downsample, blur) into its own target
+	POST_FILTER
+};
+
+// One stage of the post-processing chain.
+// POST_PIXEL / POST_RESAMPLE shaders are snippets defining `vec4 <name>(vec4 color, vec2 uv)`,
+// they can use the `source`, `texel_size` and `time` uniforms of the pass.
+// POST_FILTER shaders are full fragment shaders paired with post.vs.glsl. A filter does not
+// replace the chain image, its output is visible to later stages as `uniform sampler2D <name>`
+struct PostEffect
+{
+	std::string name;
+	PostEffectKind kind;
+	std::string shader_path;
+	// Filters only: fraction of the screen size to render at, e.g. 0.5 for half resolution
+	float resolution_scale;
+	// Filters only: name of an earlier filter to read, empty for the chain image
+	std::string input;
+	bool enabled;
+	// Sets the effect's own uniforms on the bound program, may be empty
+	std::function<void(GLuint program)> set_uniforms;
+};
+
+// Runs the scene through the enabled effects, in the order they were added, on its way
+// to the screen. Consecutive per-pixel effects are generated into one fragment shader
+// (compiled on first use and cached) so each of them does not cost a full-screen pass
+class PostProcessChain
+{
+public:
+	bool init();
+	void destroy();
+
+	bool add(const PostEffect& effect);
+	void set_enabled(const std::string& name, bool enabled);
+	bool is_enabled(const std::string& name) const;
+
+	// Whether any effect is on, otherwise the scene can go straight to the screen
+	bool is_active() const;
+
+	// Binds a target with depth for the scene to render into, render_scale shrinks it
+	// below the screen size and the last pass scales it back up
+	void begin(int width, int height, float render_scale = 1.f);
+	// Applies the effects, the last pass writes to the default framebuffer
+	void end();
+
+	// Size of the target bound by begin(), the scene viewport
+	int get_scene_width() const { return m_scene_width; }
+	int get_scene_height() const { return m_scene_height; }
+
+	// Passes run by the last end()
+	int get_pass_count() const { return m_pass_count; }
+
+private:
+	struct Pass
+	{
+		bool is_filter;
+		std::vector<int> effects;
+		Effect* fused; // generated program of a fused pass, nullptr if it failed to build
+	};
+
+	struct Output
+	{
+		int effect;
+		RenderTarget* target;
+	};
+
+	// Only when the enabled effects change, end() reuses the passes of the last build
+	void build_passes();
+	Effect* get_fused_program(const std::vector<int>& effects);
+	void draw_pass(GLuint program, const std::vector<int>& effects, RenderTarget* input, const std::vector<Output>& outputs, RenderTarget* target);
+	RenderTarget* find_output(const std::vector<Output>& outputs, const std::string& name) const;
+	int find(const std::string& name) const;
+
+	std::vector<PostEffect> m_effects;
+	std::vector<std::string> m_snippets;  // POST_PIXEL / POST_RESAMPLE sources
+	std::vector<Effect> m_filter_programs; // per effect, only valid for filters
+	std::map<std::string, Effect> m_fused_programs;
+	std::string m_vertex_source;
+	std::vector<Pass> m_passes;
+	bool m_passes_dirty = true;
+	std::vector<Output> m_outputs; // of the filters run so far by end()
+
+	RenderTargetPool m_pool;
+	RenderTarget* m_scene = nullptr;
+	Mesh m_quad;
+	int m_width = 0;
+	int m_height = 0;
+	int m_scene_width = 0;
+	int m_scene_height = 0;
+	int m_pass_count = 0;
+};
@@ -0,0 +1,195 @@
+// Header
+#include "profiler.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	struct ZoneEvent
+	{
+		const char* name;
+		uint64_t start_ns;
+		uint64_t duration_ns;
+	};
+
+	// Written only by its own thread, the count is published after each event
+	struct ThreadBuffer
+	{
+		int thread_index;
+		const char* name;
+		std::vector<ZoneEvent> events;
+		std::atomic<uint64_t> count;
+	};
+
+	std::atomic<bool> g_enabled(false);
+	const std::chrono::steady_clock::time_point g_start = std::chrono::steady_clock::now();
+
+	// Buffers outlive their threads so zones of finished threads still get exported
+	std::mutex g_buffers_mutex;
+	std::vector<ThreadBuffer*> g_buffers;
+
+	thread_local ThreadBuffer* t_buffer = nullptr;
+
+	// Expects g_buffers_mutex to be held
+	ThreadBuffer* create_buffer(const char* name)
+	{
+		ThreadBuffer* buffer = new ThreadBuffer();
+		buffer->name = name;
+		buffer->events.resize(PROFILER_EVENTS_PER_THREAD);
+		buffer->count = 0;
+		buffer->thread_index = (int)g_buffers.size();
+		g_buffers.push_back(buffer);
+		return buffer;
+	}
+
+	ThreadBuffer* get_thread_buffer()
+	{
+		if (t_buffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(g_buffers_mutex);
+			t_buffer = create_buffer(nullptr);
+		}
+		return t_buffer;
+	}
+
+	// Tracks are not tied to a thread, found by name
+	std::vector<ThreadBuffer*> g_tracks;
+
+	ThreadBuffer* get_track_buffer(const char* track)
+	{
+		std::lock_guard<std::mutex> lock(g_buffers_mutex);
+		for (ThreadBuffer* buffer : g_tracks)
+		{
+			if (strcmp(buffer->name, track) == 0)
+				return buffer;
+		}
+		ThreadBuffer* buffer = create_buffer(track);
+		g_tracks.push_back(buffer);
+		return buffer;
+	}
+
+	void push_event(ThreadBuffer* buffer, const char* name, uint64_t start_ns, uint64_t duration_ns)
+	{
+		uint64_t count = buffer->count.load(std::memory_order_relaxed);
+		buffer->events[count % PROFILER_EVENTS_PER_THREAD] = { name, start_ns, duration_ns };
+		buffer->count.store(count + 1, std::memory_order_release);
+	}
+
+	// Zone names are code literals, only quotes and backslashes need escaping
+	void write_json_string(FILE* file, const char* str)
+	{
+		fputc('"', file);
+		for (const char* c = str; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\')
+				fputc('\\', file);
+			fputc(*c, file);
+		}
+		fputc('"', file);
+	}
+}
+
+void profiler_set_enabled(bool enabled)
+{
+	g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool profiler_is_enabled()
+{
+	return g_enabled.load(std::memory_order_relaxed);
+}
+
+void profiler_set_thread_name(const char* name)
+{
+	get_thread_buffer()->name = name;
+}
+
+void profiler_clear()
+{
+	std::lock_guard<std::mutex> lock(g_buffers_mutex);
+	for (ThreadBuffer* buffer : g_buffers)
+		buffer->count.store(0, std::memory_order_release);
+}
+
+uint64_t profiler_now_ns()
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - g_start).count();
+}
+
+bool profiler_write_chrome_trace(const char* path)
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "Failed to open %s for writing\n", path);
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(g_buffers_mutex);
+
+	fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+	bool first = true;
+	for (ThreadBuffer* buffer : g_buffers)
+	{
+		int tid = buffer->thread_index + 1;
+		if (buffer->name != nullptr)
+		{
+			fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", first ? "" : ",\n", tid);
+			write_json_string(file, buffer->name);
+			fprintf(file, "}}");
+			first = false;
+		}
+
+		// Only the last PROFILER_EVENTS_PER_THREAD zones are still around
+		uint64_t count = buffer->count.load(std::memory_order_acquire);
+		uint64_t begin = count > PROFILER_EVENTS_PER_THREAD ? count - PROFILER_EVENTS_PER_THREAD : 0;
+		for (uint64_t i = begin; i < count; i++)
+		{
+			const ZoneEvent& event = buffer->events[i % PROFILER_EVENTS_PER_THREAD];
+			fprintf(file, "%s{\"name\":", first ? "" : ",\n");
+			write_json_string(file, event.name);
+			// Trace timestamps are in microseconds
+			fprintf(file, ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+				tid, event.start_ns / 1000.0, event.duration_ns / 1000.0);
+			first = false;
+		}
+	}
+	fprintf(file, "\n]}\n");
+
+	bool ok = ferror(file) == 0;
+	fclose(file);
+	return ok;
+}
+
+ProfileZone::ProfileZone(const char* name)
+{
+	if (!g_enabled.load(std::memory_order_relaxed))
+	{
+		m_name = nullptr;
+		return;
+	}
+	m_name = name;
+	m_start_ns = profiler_now_ns();
+}
+
+ProfileZone::~ProfileZone()
+{
+	if (m_name == nullptr)
+		return;
+
+	uint64_t end_ns = profiler_now_ns();
+	push_event(get_thread_buffer(), m_name, m_start_ns, end_ns - m_start_ns);
+}
+
+void profiler_record_zone(const char* track, const char* name, uint64_t start_ns, uint64_t duration_ns)
+{
+	if (!g_enabled.load(std::memory_order_relaxed))
+		return;
+
+	push_event(get_track_buffer(track), name, start_ns, duration_ns);
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+
+// Scoped CPU zones, recorded per thread into ring buffers and exported in the Chrome
+// trace_event format (open in chrome://tracing or ui.perfetto.dev).
+//
+//   void World::update(float ms) {
+//       PROFILE_ZONE("World::update");
+//       ...
+//   }
+//
+// Zone names must be string literals, or otherwise outlive the capture. While the
+// profiler is disabled a zone costs one flag check. Build with VEGGIE_NO_PROFILER to
+// compile the zones out entirely.
+
+// Zones kept per thread, the oldest are overwritten when a thread records more
+const int PROFILER_EVENTS_PER_THREAD = 1 << 16;
+
+void profiler_set_enabled(bool enabled);
+bool profiler_is_enabled();
+// Shown instead of the thread id in the trace, name must outlive the capture
+void profiler_set_thread_name(const char* name);
+// Drops everything recorded so far
+void profiler_clear();
+// Writes the recorded zones of every thread, threads should not be recording meanwhile
+bool profiler_write_chrome_trace(const char* path);
+// Nanoseconds since the profiler started, the trace timebase
+uint64_t profiler_now_ns();
+// Records a zone measured elsewhere (e.g. on the GPU) on a named track of its own,
+// track and name must outlive the capture. Tracks are written by one thread at a time
+void profiler_record_zone(const char* track, const char* name, uint64_t start_ns, uint64_t duration_ns);
+
+// Records the surrounding scope as a zone
+class ProfileZone
+{
+public:
+	explicit ProfileZone(const char* name);
+	~ProfileZone();
+
+private:
+	const char* m_name; // null when the profiler was off at construction
+	uint64_t m_start_ns;
+};
+
+#ifdef VEGGIE_NO_PROFILER
+#define PROFILE_ZONE(name)
+#else
+#define PROFILE_ZONE_CONCAT_(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CONCAT(profile_zone_, __LINE__)(name)
+#endif
@@ -2,4 +2,4 @@
 
 // Please don't change the content of this header
 
-#define PROJECT_SOURCE_DIR "C:/Users/grafm/Desktop/school stuff/436D/Project/team09game/"
+#define PROJECT_SOURCE_DIR "/root/repo/"
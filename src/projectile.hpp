@@ -10,8 +10,12 @@ public:
 	Projectile(int id, vec2 pos, float velo, unsigned int damage, bool direction);
 	~Projectile();
 	bool init();
+	// Loaded with the other sprites before the first tick, attacks are created mid-tick
+	// where no GL calls are made
+	static bool load_texture();
 	void update(float ms);
 	void draw(const mat3 &projection) override;
+	void submit(RenderQueue &queue) override;
 private:
 	float m_acceleration;
 	float m_bounce_loss;
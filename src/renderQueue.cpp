@@ -0,0 +1,213 @@
+#include "renderQueue.hpp"
+#include "shaderCache.hpp"
+
+#include <string.h>
+
+namespace
+{
+	// Layers where sprites overlap each other keep their submission order
+	const bool LAYER_ORDERED[LAYER_COUNT] = {
+		true,  // LAYER_BACKGROUND
+		false, // LAYER_STAGE_FX
+		true,  // LAYER_FIGHTERS
+		false, // LAYER_ATTACKS
+		false, // LAYER_PLATFORMS
+		true,  // LAYER_PARTICLES
+	};
+
+	const uint64_t SEQUENCE_MASK = 0xFFFFFF;
+	const uint64_t STATE_MASK = 0xFFFF;
+
+	// All sprites share one program, custom commands sort as program 0 before them.
+	// Not the GL name, so a queue can record without ever being initialized
+	const GLuint SPRITE_PROGRAM_KEY = 1;
+}
+
+bool RenderQueue::init()
+{
+	m_commands.reserve(256);
+	m_entries.reserve(256);
+	m_scratch.reserve(256);
+	m_sequence = 0;
+
+	// Unit quad, texcoords double as the position inside the sprite rect
+	static const GLfloat quad_vertex_buffer_data[] = {
+		0.f, 1.f,
+		1.f, 1.f,
+		1.f, 0.f,
+		0.f, 0.f,
+	};
+	static const uint16_t quad_indices[] = { 0, 3, 1, 1, 3, 2 };
+
+	// Clearing errors
+	gl_flush_errors();
+
+	if (!m_sprite_effect.load_from_file(shader_path("sprite.vs.glsl"), shader_path("textured.fs.glsl")))
+		return false;
+
+	glGenVertexArrays(1, &m_quad_vao);
+	glBindVertexArray(m_quad_vao);
+	glGenBuffers(1, &m_quad_vbo);
+	glBindBuffer(GL_ARRAY_BUFFER, m_quad_vbo);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(quad_vertex_buffer_data), quad_vertex_buffer_data, GL_STATIC_DRAW);
+	glGenBuffers(1, &m_quad_ibo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_quad_ibo);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(quad_indices), quad_indices, GL_STATIC_DRAW);
+
+	GLint in_texcoord_loc = glGetAttribLocation(m_sprite_effect.program, "in_texcoord");
+	glEnableVertexAttribArray(in_texcoord_loc);
+	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(GLfloat) * 2, (void*)0);
+	glBindVertexArray(0);
+
+	look_up_uniforms();
+
+	return !gl_has_errors();
+}
+
+// Uniform locations only change when a shader reload relinks the program
+void RenderQueue::look_up_uniforms()
+{
+	m_transform_uloc = glGetUniformLocation(m_sprite_effect.program, "transform");
+	m_projection_uloc = glGetUniformLocation(m_sprite_effect.program, "projection");
+	m_rect_uloc = glGetUniformLocation(m_sprite_effect.program, "rect");
+	m_color_uloc = glGetUniformLocation(m_sprite_effect.program, "fcolor");
+	m_uniform_generation = shader_cache_generation();
+}
+
+void RenderQueue::destroy()
+{
+	glDeleteVertexArrays(1, &m_quad_vao);
+	glDeleteBuffers(1, &m_quad_vbo);
+	glDeleteBuffers(1, &m_quad_ibo);
+	m_sprite_effect.release();
+	clear();
+}
+
+void RenderQueue::clear()
+{
+	// Keeps capacity, so steady-state frames do not allocate
+	m_commands.clear();
+	m_entries.clear();
+	m_sequence = 0;
+}
+
+uint64_t RenderQueue::make_key(RenderLayer layer, GLuint program, GLuint texture)
+{
+	uint64_t sequence = m_sequence++ & SEQUENCE_MASK;
+	uint64_t state = ((program & STATE_MASK) << 16) | (texture & STATE_MASK);
+	if (LAYER_ORDERED[layer])
+		return ((uint64_t)layer << 56) | (sequence << 32) | state;
+	return ((uint64_t)layer << 56) | (state << 24) | sequence;
+}
+
+void RenderQueue::submit_sprite(RenderLayer layer, const Texture &texture, const mat3 &transform, vec2 origin, vec2 size, vec3 color)
+{
+	RenderCommand command;
+	command.renderable = nullptr;
+	command.texture = texture.id;
+	command.transform = transform;
+	command.origin = origin;
+	command.size = size;
+	command.color = color;
+
+	SortEntry entry = { make_key(layer, SPRITE_PROGRAM_KEY, texture.id), (uint32_t)m_commands.size() };
+	m_commands.push_back(command);
+	m_entries.push_back(entry);
+}
+
+void RenderQueue::submit_custom(RenderLayer layer, Renderable *renderable)
+{
+	RenderCommand command;
+	command.renderable = renderable;
+	command.texture = 0;
+
+	SortEntry entry = { make_key(layer, 0, 0), (uint32_t)m_commands.size() };
+	m_commands.push_back(command);
+	m_entries.push_back(entry);
+}
+
+// LSD radix sort on the key bytes, skipping bytes that are the same for every entry
+void RenderQueue::sort()
+{
+	size_t count = m_entries.size();
+	if (count < 2)
+		return;
+	m_scratch.resize(count);
+
+	SortEntry *src = m_entries.data();
+	SortEntry *dst = m_scratch.data();
+	for (int shift = 0; shift < 64; shift += 8)
+	{
+		size_t histogram[256];
+		memset(histogram, 0, sizeof(histogram));
+		for (size_t i = 0; i < count; i++)
+			histogram[(src[i].key >> shift) & 0xFF]++;
+
+		if (histogram[(src[0].key >> shift) & 0xFF] == count)
+			continue;
+
+		size_t offset = 0;
+		for (int b = 0; b < 256; b++)
+		{
+			size_t bucket = histogram[b];
+			histogram[b] = offset;
+			offset += bucket;
+		}
+		for (size_t i = 0; i < count; i++)
+			dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+
+		SortEntry *tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != m_entries.data())
+		m_entries.swap(m_scratch);
+}
+
+void RenderQueue::execute(const mat3 &projection)
+{
+	execute(projection, *this);
+}
+
+void RenderQueue::execute(const mat3 &projection, const RenderQueue &recorded)
+{
+	if (m_uniform_generation != shader_cache_generation())
+		look_up_uniforms();
+
+	bool projection_set = false;
+	for (const SortEntry &entry : recorded.m_entries)
+	{
+		const RenderCommand &command = recorded.m_commands[entry.index];
+		if (command.renderable != nullptr)
+		{
+			command.renderable->draw(projection);
+			continue;
+		}
+
+		gl_use_program(m_sprite_effect.program);
+		gl_enable(GL_BLEND);
+		gl_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		gl_disable(GL_DEPTH_TEST);
+		gl_bind_vertex_array(m_quad_vao);
+		gl_active_texture(GL_TEXTURE0);
+		gl_bind_texture(GL_TEXTURE_2D, command.texture);
+
+		// Uniforms belong to the program, so custom draws in between do not clobber them
+		if (!projection_set)
+		{
+			glUniformMatrix3fv(m_projection_uloc, 1, GL_FALSE, (float *)&projection);
+			projection_set = true;
+		}
+		glUniformMatrix3fv(m_transform_uloc, 1, GL_FALSE, (float *)&command.transform);
+		glUniform4f(m_rect_uloc, command.origin.x, command.origin.y, command.size.x, command.size.y);
+		glUniform3fv(m_color_uloc, 1, (float *)&command.color);
+
+		gl_draw_elements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+	}
+}
+
+int RenderQueue::size() const
+{
+	return (int)m_commands.size();
+}
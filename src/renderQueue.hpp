@@ -0,0 +1,78 @@
+#pragma once
+#include "common.hpp"
+
+#include <vector>
+#include <stdint.h>
+
+// Draw order, lower layers are drawn first
+enum RenderLayer
+{
+	LAYER_BACKGROUND = 0,
+	LAYER_STAGE_FX,
+	LAYER_FIGHTERS,
+	LAYER_ATTACKS,
+	LAYER_PLATFORMS,
+	LAYER_PARTICLES,
+	LAYER_COUNT
+};
+
+// Compact description of a single draw. Sprite commands are drawn by the queue
+// itself with a shared program and unit quad; custom commands call back into
+// the Renderable's own draw() for anything that needs its own shader.
+struct RenderCommand
+{
+	Renderable *renderable; // nullptr for sprites
+	GLuint texture;
+	mat3 transform;
+	vec2 origin; // local quad corner and size, before transform
+	vec2 size;
+	vec3 color;
+};
+
+// Entities submit commands every frame, the queue then sorts them by a 64-bit
+// key (layer | program | texture | submission order) and executes them in one go.
+// Layers where overlap matters keep submission order instead of grouping by state.
+// Recording and sorting make no GL calls, only a queue that was init() executes, so
+// a frame can be recorded on the simulation thread and executed on the render thread.
+class RenderQueue
+{
+public:
+	bool init();
+	void destroy();
+
+	void clear();
+	void submit_sprite(RenderLayer layer, const Texture &texture, const mat3 &transform, vec2 origin, vec2 size, vec3 color = { 1.f, 1.f, 1.f });
+	void submit_custom(RenderLayer layer, Renderable *renderable);
+
+	void sort();
+	void execute(const mat3 &projection);
+	// Draws the sorted commands of another queue with this queue's GL objects
+	void execute(const mat3 &projection, const RenderQueue &recorded);
+
+	int size() const;
+
+private:
+	struct SortEntry
+	{
+		uint64_t key;
+		uint32_t index;
+	};
+
+	uint64_t make_key(RenderLayer layer, GLuint program, GLuint texture);
+	void look_up_uniforms();
+
+	std::vector<RenderCommand> m_commands;
+	std::vector<SortEntry> m_entries;
+	std::vector<SortEntry> m_scratch;
+	uint32_t m_sequence = 0;
+
+	Effect m_sprite_effect;
+	GLuint m_quad_vao;
+	GLuint m_quad_vbo;
+	GLuint m_quad_ibo;
+	GLint m_transform_uloc;
+	GLint m_projection_uloc;
+	GLint m_rect_uloc;
+	GLint m_color_uloc;
+	unsigned m_uniform_generation = 0; // shader_cache_generation() the locations are from
+};
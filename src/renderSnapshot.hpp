@@ -0,0 +1,48 @@
+#pragma once
+
+#include "common.hpp"
+#include "renderQueue.hpp"
+#include "screenFrame.hpp"
+#include "fighter.hpp"
+#include "knife.hpp"
+#include "particleSystem.hpp"
+
+#include <cstdint>
+#include <vector>
+
+// Everything one frame draws, captured by the simulation at the end of a tick. The
+// render thread only reads it, so it draws while the simulation runs the next tick.
+//
+// Entities that draw themselves are recorded as frames, plain data with the transform,
+// sprite and shader state the entity had, sprites go into the queue. Frames share GL
+// objects and text renderers with the live entities but never change them, those are
+// only created and released on the render thread, between frames. The vectors are
+// reused from capture to capture, so recording a frame does not allocate once warm.
+struct RenderSnapshot
+{
+	// Sorted draw commands, custom ones point into the frames below
+	RenderQueue queue;
+
+	ScreenFrame screen; // the menu, or the fight background and its HUD
+	std::vector<FighterFrame> fighters; // players then AIs, or the AI shown on the menu
+	std::vector<KnifeFrame> knives;
+	ParticleFrame particles;
+
+	// Screen effects and overlays
+	bool hit_flash_on = false;
+	float hit_flash_ms = 0.f;
+	bool heat_wave = false;
+	bool show_perf_hud = false;
+	bool show_gpu_timings = false;
+
+	// Counters of the tick, for the performance HUD
+	int attacks = 0;
+	int particle_count = 0;
+	int broadphase_queries = 0;
+	float update_ms = 0.f;
+
+	// Tick the snapshot was captured after
+	uint64_t tick = 0;
+	// Entities replaced since the capture make the snapshot unsafe to draw
+	unsigned generation = 0;
+};
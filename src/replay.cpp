@@ -0,0 +1,67 @@
+// Header
+#include "replay.hpp"
+
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+	const int REPLAY_VERSION = 1;
+}
+
+bool Replay::load_from_file(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "Failed to open replay %s\n", path);
+		return false;
+	}
+
+	events.clear();
+	int version = 0;
+	bool ok = fscanf(file, " veggie-replay %d frame_ms %f frames %d", &version, &frame_ms, &frame_count) == 3 &&
+		version == REPLAY_VERSION && frame_ms > 0.f;
+
+	ReplayEvent event;
+	while (ok && fscanf(file, "%d %d %d %d", &event.frame, &event.key, &event.action, &event.mods) == 4)
+	{
+		if (!events.empty() && event.frame < events.back().frame)
+			ok = false;
+		events.push_back(event);
+	}
+	ok = ok && feof(file);
+	fclose(file);
+
+	if (!ok)
+		fprintf(stderr, "Replay %s is not a version %d replay\n", path, REPLAY_VERSION);
+	return ok;
+}
+
+bool Replay::save_to_file(const char* path) const
+{
+	FILE* file = fopen(path, "w");
+	if (file == nullptr)
+	{
+		fprintf(stderr, "Failed to open %s for writing\n", path);
+		return false;
+	}
+
+	fprintf(file, "veggie-replay %d\nframe_ms %.3f\nframes %d\n", REPLAY_VERSION, frame_ms, frame_count);
+	for (const ReplayEvent& event : events)
+		fprintf(file, "%d %d %d %d\n", event.frame, event.key, event.action, event.mods);
+
+	bool ok = ferror(file) == 0;
+	fclose(file);
+	return ok;
+}
+
+void ReplayRecorder::record_key(int key, int action, int mods)
+{
+	m_replay.events.push_back({ m_replay.frame_count, key, action, mods });
+}
+
+void ReplayRecorder::end_frame()
+{
+	m_replay.frame_count++;
+}
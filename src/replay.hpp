@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Key input of a session, enough to play it back through World::on_key from the
+// main menu onwards. Stored as text:
+//
+//   veggie-replay 1
+//   frame_ms 16.667
+//   frames 3600
+//   <frame> <key> <action> <mods>
+//   ...
+//
+// Keys, actions and mods are GLFW values. Playback steps the world at a fixed
+// frame_ms, events are delivered before the update of their frame.
+
+struct ReplayEvent
+{
+	int frame;
+	int key;
+	int action;
+	int mods;
+};
+
+struct Replay
+{
+	float frame_ms = 1000.f / 60.f;
+	int frame_count = 0;
+	std::vector<ReplayEvent> events; // ordered by frame
+
+	bool load_from_file(const char* path);
+	bool save_to_file(const char* path) const;
+};
+
+// Collects the key events of a live session into a Replay
+class ReplayRecorder
+{
+public:
+	void record_key(int key, int action, int mods);
+	// Call once per World::update()
+	void end_frame();
+
+	const Replay& get_replay() const { return m_replay; }
+
+private:
+	Replay m_replay;
+};
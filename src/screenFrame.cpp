@@ -0,0 +1,86 @@
+// Header
+#include "screenFrame.hpp"
+#include "gpuProfiler.hpp"
+
+namespace
+{
+	void draw_quad(const mat3 &projection, const TexturedQuad &quad)
+	{
+		// Setting shaders
+		gl_use_program(quad.program);
+
+		// Enabling alpha channel for textures
+		gl_enable(GL_BLEND); gl_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		gl_disable(GL_DEPTH_TEST);
+
+		// Getting uniform locations for glUniform* calls
+		GLint transform_uloc = glGetUniformLocation(quad.program, "transform");
+		GLint color_uloc = glGetUniformLocation(quad.program, "fcolor");
+		GLint projection_uloc = glGetUniformLocation(quad.program, "projection");
+		GLuint time_uloc = glGetUniformLocation(quad.program, "time");
+
+		// Setting vertices and indices
+		gl_bind_vertex_array(quad.mesh.vao);
+		gl_bind_buffer(GL_ARRAY_BUFFER, quad.mesh.vbo);
+		gl_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, quad.mesh.ibo);
+
+		// Input data location as in the vertex buffer
+		GLint in_position_loc = glGetAttribLocation(quad.program, "in_position");
+		GLint in_texcoord_loc = glGetAttribLocation(quad.program, "in_texcoord");
+		glEnableVertexAttribArray(in_position_loc);
+		glEnableVertexAttribArray(in_texcoord_loc);
+		glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)0);
+		glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), (void*)sizeof(vec3));
+
+		// Enabling and binding texture to slot 0
+		gl_active_texture(GL_TEXTURE0);
+		gl_bind_texture(GL_TEXTURE_2D, quad.texture);
+
+		// Setting uniform values to the currently bound program
+		glUniformMatrix3fv(transform_uloc, 1, GL_FALSE, (float*)&quad.transform);
+		float color[] = { 1.f, 1.f, 1.f };
+		glUniform3fv(color_uloc, 1, color);
+		glUniformMatrix3fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
+		glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
+
+		// Drawing!
+		gl_draw_elements(GL_TRIANGLES, 6, GL_UNSIGNED_SHORT, nullptr);
+	}
+}
+
+void ScreenFrame::clear()
+{
+	quads.clear();
+	text_count = 0;
+}
+
+void ScreenFrame::add_quad(const Mesh &mesh, GLuint program, GLuint texture, const mat3 &transform)
+{
+	TexturedQuad quad = { mesh, program, texture, transform, text_count };
+	quads.push_back(quad);
+}
+
+void ScreenFrame::add_text(const TextRenderer *font, const std::string &text)
+{
+	if (text_count == (int)texts.size())
+		texts.emplace_back();
+	font->capture(text, texts[text_count++]);
+}
+
+void ScreenFrame::draw(const mat3 &projection)
+{
+	// The first quad is the screen itself, drawn under everything
+	size_t quad = 0;
+	for (; quad < quads.size() && quads[quad].text_index == 0; quad++)
+		draw_quad(projection, quads[quad]);
+
+	GPU_PROFILE_ZONE("text and hud");
+	for (int i = 0; i < text_count; i++)
+	{
+		for (; quad < quads.size() && quads[quad].text_index == i; quad++)
+			draw_quad(projection, quads[quad]);
+		texts[i].font->renderString(projection, texts[i]);
+	}
+	for (; quad < quads.size(); quad++)
+		draw_quad(projection, quads[quad]);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "common.hpp"
+#include "textRenderer.hpp"
+
+#include <string>
+#include <vector>
+
+// A quad drawn with the textured shader: the menu and fight backgrounds, and the
+// pictures of the menus
+struct TexturedQuad
+{
+	Mesh mesh;
+	GLuint program;
+	GLuint texture;
+	mat3 transform;
+	int text_index; // drawn before this string of the frame
+};
+
+// Everything a menu or the fight background draws in a frame, in order. Captured by
+// the simulation, so the render thread draws it without reading the screen or moving
+// its text renderers. Strings are reused between frames to keep their storage
+struct ScreenFrame : public Renderable
+{
+	void clear();
+	void add_quad(const Mesh &mesh, GLuint program, GLuint texture, const mat3 &transform);
+	// The string as font would draw it right now
+	void add_text(const TextRenderer *font, const std::string &text);
+
+	void draw(const mat3 &projection) override;
+
+	std::vector<TexturedQuad> quads;
+	std::vector<TextDraw> texts; // only the first text_count are drawn
+	int text_count = 0;
+};
@@ -0,0 +1,152 @@
+// Header
+#include "shaderCache.hpp"
+
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+	struct CachedProgram
+	{
+		std::string vs_path;
+		std::string fs_path;
+		GLuint program;
+		int users;
+	};
+
+	// A few dozen at most, the paths are only compared on loads and reloads
+	std::vector<CachedProgram> g_programs;
+	unsigned g_generation = 0;
+
+	bool read_file(const std::string& path, std::string& text)
+	{
+		std::ifstream is(path);
+		if (!is.good())
+			return false;
+		std::stringstream ss;
+		ss << is.rdbuf();
+		text = ss.str();
+		return true;
+	}
+
+	// Links program again with the shaders of compiled, a program that linked already,
+	// keeping its attributes at the locations the VAOs were set up with
+	bool relink(GLuint program, const Effect& compiled)
+	{
+		GLint attribute_count = 0;
+		glGetProgramiv(program, GL_ACTIVE_ATTRIBUTES, &attribute_count);
+		for (GLint i = 0; i < attribute_count; i++)
+		{
+			char name[64];
+			GLint size;
+			GLenum type;
+			glGetActiveAttrib(program, i, sizeof(name), nullptr, &size, &type, name);
+			GLint location = glGetAttribLocation(program, name);
+			if (location >= 0)
+				glBindAttribLocation(program, location, name);
+		}
+
+		glAttachShader(program, compiled.vertex);
+		glAttachShader(program, compiled.fragment);
+		glLinkProgram(program);
+		glDetachShader(program, compiled.vertex);
+		glDetachShader(program, compiled.fragment);
+
+		GLint is_linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+		return is_linked == GL_TRUE;
+	}
+}
+
+bool shader_cache_load(const char* vs_path, const char* fs_path, Effect& effect)
+{
+	for (CachedProgram& cached : g_programs)
+	{
+		if (cached.vs_path == vs_path && cached.fs_path == fs_path)
+		{
+			cached.users++;
+			effect.vertex = 0;
+			effect.fragment = 0;
+			effect.program = cached.program;
+			return true;
+		}
+	}
+
+	gl_flush_errors();
+	std::string vs_src, fs_src;
+	if (!read_file(vs_path, vs_src) || !read_file(fs_path, fs_src))
+	{
+		fprintf(stderr, "Failed to load shader files %s, %s", vs_path, fs_path);
+		return false;
+	}
+
+	Effect compiled;
+	if (!compiled.load_from_source(vs_src, fs_src))
+		return false;
+
+	// A linked program keeps its code without its shaders
+	glDetachShader(compiled.program, compiled.vertex);
+	glDetachShader(compiled.program, compiled.fragment);
+	glDeleteShader(compiled.vertex);
+	glDeleteShader(compiled.fragment);
+
+	g_programs.push_back({ vs_path, fs_path, compiled.program, 1 });
+	effect.vertex = 0;
+	effect.fragment = 0;
+	effect.program = compiled.program;
+	return !gl_has_errors();
+}
+
+bool shader_cache_release(GLuint program)
+{
+	for (size_t i = 0; i < g_programs.size(); i++)
+	{
+		if (g_programs[i].program != program)
+			continue;
+		if (--g_programs[i].users == 0)
+		{
+			glDeleteProgram(program);
+			g_programs.erase(g_programs.begin() + i);
+		}
+		return true;
+	}
+	return false;
+}
+
+int shader_cache_reload(const std::string& path)
+{
+	int reloaded = 0;
+	for (CachedProgram& cached : g_programs)
+	{
+		if (cached.vs_path != path && cached.fs_path != path)
+			continue;
+
+		std::string vs_src, fs_src;
+		if (!read_file(cached.vs_path, vs_src) || !read_file(cached.fs_path, fs_src))
+			continue;
+
+		// Built into a program of its own first, a failed link would leave the cached one unusable
+		Effect compiled;
+		if (compiled.load_from_source(vs_src, fs_src))
+		{
+			if (relink(cached.program, compiled))
+				reloaded++;
+			compiled.release();
+		}
+		else
+		{
+			fprintf(stderr, "Kept the old %s + %s program\n", cached.vs_path.c_str(), cached.fs_path.c_str());
+		}
+	}
+	gl_flush_errors();
+	gl_state_invalidate();
+	if (reloaded > 0)
+		g_generation++;
+	return reloaded;
+}
+
+unsigned shader_cache_generation()
+{
+	return g_generation;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <string>
+
+// Programs built from shader files, shared by every Effect loaded from the same two
+// files: a fighter spawned mid-fight no longer compiles its own copy. The program's
+// shaders are deleted once linked, so cached Effects have vertex and fragment set to 0.
+//
+// A reload compiles the files again and relinks the same program object, attributes
+// keeping their locations. The Effects, and the render snapshots holding copies of
+// them, go on using the same program name. Uniforms are reset by the link, which is
+// fine as every draw sets the ones it uses, but they may also move: owners that keep
+// uniform locations look them up again when shader_cache_generation() changes.
+
+// Effect::load_from_file() goes through here
+bool shader_cache_load(const char* vs_path, const char* fs_path, Effect& effect);
+// False if the program is not from the cache. The cache deletes it with its last user
+bool shader_cache_release(GLuint program);
+// Relinks the programs using the shader file at path, returns how many. A program
+// whose new sources do not compile or link is left as it was
+int shader_cache_reload(const std::string& path);
+// Counts the reloads that relinked a program, starts at 0
+unsigned shader_cache_generation();
@@ -0,0 +1,96 @@
+// Header
+#include "simThread.hpp"
+#include "world.hpp"
+#include "profiler.hpp"
+
+#include <chrono>
+
+bool SimThread::start(World* world, float step_ms)
+{
+	if (is_running() || step_ms <= 0.f)
+		return false;
+
+	m_world = world;
+	m_step_ms = step_ms;
+	m_quit = false;
+	m_finished = false;
+	m_thread = std::thread(&SimThread::run, this);
+	return true;
+}
+
+void SimThread::stop()
+{
+	if (!is_running())
+		return;
+
+	// The last tick may still be waiting on a call
+	m_quit = true;
+	while (!m_finished)
+	{
+		run_pending_call();
+		std::this_thread::yield();
+	}
+	m_thread.join();
+}
+
+void SimThread::run_on_render_thread(const std::function<void()>& call)
+{
+	if (!is_running() || std::this_thread::get_id() != m_thread.get_id())
+	{
+		call();
+		m_generation++;
+		return;
+	}
+
+	std::unique_lock<std::mutex> lock(m_call_mutex);
+	m_call = &call;
+	m_call_done.wait(lock, [this] { return m_call == nullptr; });
+}
+
+void SimThread::run_pending_call()
+{
+	std::unique_lock<std::mutex> lock(m_call_mutex);
+	if (m_call == nullptr)
+		return;
+
+	PROFILE_ZONE("SimThread::run_pending_call");
+	(*m_call)();
+	m_generation++;
+	m_call = nullptr;
+	lock.unlock();
+	m_call_done.notify_one();
+}
+
+RenderSnapshot* SimThread::acquire_snapshot()
+{
+	if (!m_snapshots.acquire())
+		return nullptr;
+
+	RenderSnapshot& snapshot = m_snapshots.read_buffer();
+	return snapshot.generation == m_generation ? &snapshot : nullptr;
+}
+
+void SimThread::run()
+{
+	profiler_set_thread_name("sim");
+
+	uint64_t period_ns = (uint64_t)(m_step_ms * 1e6f);
+	uint64_t next_tick_ns = profiler_now_ns();
+	while (!m_quit)
+	{
+		{
+			PROFILE_ZONE("SimThread::tick");
+			m_world->update(m_step_ms);
+			m_world->capture_frame(m_snapshots.write_buffer());
+		}
+		m_snapshots.publish();
+
+		// Fixed cadence, a late tick does not make the next ones come early
+		next_tick_ns += period_ns;
+		uint64_t now = profiler_now_ns();
+		if (next_tick_ns <= now)
+			next_tick_ns = now + period_ns;
+		std::this_thread::sleep_for(std::chrono::nanoseconds(next_tick_ns - now));
+	}
+	m_finished = true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "renderSnapshot.hpp"
+#include "tripleBuffer.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class World;
+
+// Runs the simulation on its own thread at a fixed step. Each tick ends by capturing a
+// RenderSnapshot into a triple buffer, the render thread draws the latest one, so
+// neither waits on the other and a slow frame never holds back the game.
+//
+// GL calls stay on the render thread. Simulation code that creates or releases GL
+// objects, e.g. a mode change loading its level, goes through run_on_render_thread(),
+// which waits for the render thread to run it between two frames. Snapshots captured
+// before such a call may point at released objects and are dropped.
+class SimThread
+{
+public:
+	bool start(World* world, float step_ms);
+	// Keeps serving calls until the simulation has stopped, call from the render thread
+	void stop();
+	bool is_running() const { return m_thread.joinable(); }
+
+	// Runs call on the render thread and returns once it is done. Runs it right away
+	// when called from the render thread or while no simulation thread is running
+	void run_on_render_thread(const std::function<void()>& call);
+	// Render thread, runs the call the simulation is waiting for, if any
+	void run_pending_call();
+
+	// Render thread, a snapshot newer than the last one or nullptr if there is none
+	RenderSnapshot* acquire_snapshot();
+
+	unsigned get_generation() const { return m_generation; }
+
+private:
+	void run();
+
+	World* m_world = nullptr;
+	float m_step_ms = 0.f;
+	std::thread m_thread;
+	std::atomic<bool> m_quit{ false };
+	std::atomic<bool> m_finished{ false };
+
+	TripleBuffer<RenderSnapshot> m_snapshots;
+	// Bumped by every call run on the render thread
+	std::atomic<unsigned> m_generation{ 0 };
+
+	std::mutex m_call_mutex;
+	std::condition_variable m_call_done;
+	const std::function<void()>* m_call = nullptr;
+};
@@ -0,0 +1,87 @@
+// Header
+#include "spriteAnimation.hpp"
+#include "fighterDefinition.hpp"
+
+namespace
+{
+	// Standing still, breathing in and out
+	const AnimationFrame IDLE_FRAMES[] = { { IDLE, 400.f }, { ORIGINAL, 400.f } };
+	// Players slumping after holding a charge for too long
+	const AnimationFrame TIRED_FRAMES[] = { { TIRED_1, 250.f }, { TIRED_2, 1000.f } };
+	// The attack ends with the animation
+	const AnimationFrame UPPERCUT_FRAMES[] = { { UPPERCUT, 500.f } };
+	const AnimationFrame POWER_PUNCH_FRAMES[] = { { POWER_PUNCH, 350.f } };
+
+	// Held for as long as the pose lasts
+	const AnimationFrame ORIGINAL_FRAMES[] = { { ORIGINAL, 0.f } };
+	const AnimationFrame PUNCH_FRAMES[] = { { PUNCH, 0.f } };
+	const AnimationFrame CROUCH_PUNCH_FRAMES[] = { { CROUCH_PUNCH, 0.f } };
+	const AnimationFrame CROUCH_FRAMES[] = { { CROUCH, 0.f } };
+	const AnimationFrame CHARGING_FRAMES[] = { { CHARGING, 0.f } };
+	const AnimationFrame DEATH_FRAMES[] = { { DEATH, 0.f } };
+	const AnimationFrame TIRED_2_FRAMES[] = { { TIRED_2, 0.f } };
+
+	#define ANIMATION(frames, loops) { frames, sizeof(frames) / sizeof(frames[0]), loops }
+
+	// By SpriteType
+	const SpriteAnimation ANIMATIONS[SPRITE_TYPE_COUNT] = {
+		ANIMATION(ORIGINAL_FRAMES, true),
+		ANIMATION(IDLE_FRAMES, true),
+		ANIMATION(PUNCH_FRAMES, true),
+		ANIMATION(POWER_PUNCH_FRAMES, false),
+		ANIMATION(CROUCH_PUNCH_FRAMES, true),
+		ANIMATION(CROUCH_FRAMES, true),
+		ANIMATION(CHARGING_FRAMES, true),
+		ANIMATION(DEATH_FRAMES, true),
+		ANIMATION(TIRED_FRAMES, true),
+		ANIMATION(TIRED_2_FRAMES, true),
+		ANIMATION(UPPERCUT_FRAMES, false),
+	};
+
+	#undef ANIMATION
+}
+
+const SpriteAnimation& get_sprite_animation(SpriteType first)
+{
+	return ANIMATIONS[first];
+}
+
+void SpriteAnimator::play(SpriteType first)
+{
+	// A one-shot animation asked for again once finished is a new attack
+	if (first == m_animation && !m_finished)
+		return;
+	m_animation = first;
+	m_frame = 0;
+	m_frame_ms = 0.f;
+	m_finished = false;
+}
+
+void SpriteAnimator::advance(float ms)
+{
+	const SpriteAnimation& animation = ANIMATIONS[m_animation];
+	m_frame_ms += ms;
+	// A frame without a time is held until another animation plays
+	while (!m_finished && animation.frames[m_frame].ms > 0.f && m_frame_ms >= animation.frames[m_frame].ms)
+	{
+		if (m_frame + 1 < animation.frame_count)
+		{
+			m_frame_ms -= animation.frames[m_frame].ms;
+			m_frame++;
+		}
+		else if (animation.loops)
+		{
+			m_frame_ms -= animation.frames[m_frame].ms;
+			m_frame = 0;
+		}
+		else
+		{
+			m_finished = true;
+		}
+	}
+}
+
+SpriteType SpriteAnimator::get_sprite() const
+{
+	return ANIMATIONS[m_animation].frames[m_frame].sprite;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "fighterInfo.hpp"
+
+// How long a sprite is shown before the next one of its animation, in ms
+struct AnimationFrame
+{
+	SpriteType sprite;
+	float ms;
+};
+
+// The frames a fighter goes through once it takes a pose. Every SpriteType starts one,
+// most are a single frame held for as long as the pose lasts
+struct SpriteAnimation
+{
+	const AnimationFrame* frames;
+	int frame_count;
+	bool loops; // otherwise the last frame is held once its time is up
+};
+
+const SpriteAnimation& get_sprite_animation(SpriteType first);
+
+// Steps an animation by elapsed time, called from the simulation tick so animations
+// play at the same speed whatever the tick or frame rate
+class SpriteAnimator
+{
+public:
+	// Restarts from the first frame unless the animation of first is already playing and
+	// not finished
+	void play(SpriteType first);
+	void advance(float ms);
+
+	SpriteType get_sprite() const;
+	// Only for animations that do not loop, the last frame has been shown its full time
+	bool is_finished() const { return m_finished; }
+
+private:
+	SpriteType m_animation = IDLE;
+	int m_frame = 0;
+	float m_frame_ms = 0.f; // spent in m_frame
+	bool m_finished = false;
+};
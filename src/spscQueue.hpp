@@ -0,0 +1,50 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// Fixed size ring buffer between exactly one producer thread and one consumer thread,
+// without locks. Each index is written by one side only, the acquire/release pairs
+// make the slot contents visible before the index that publishes them.
+// Capacity must be a power of two, one slot is kept free to tell full from empty.
+template <typename T, size_t Capacity>
+class SpscQueue
+{
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	// Producer side, false when the queue is full
+	bool push(const T& item)
+	{
+		size_t tail = m_tail.load(std::memory_order_relaxed);
+		size_t next = (tail + 1) & (Capacity - 1);
+		if (next == m_head.load(std::memory_order_acquire))
+			return false;
+		m_items[tail] = item;
+		m_tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side, false when the queue is empty
+	bool pop(T& item)
+	{
+		size_t head = m_head.load(std::memory_order_relaxed);
+		if (head == m_tail.load(std::memory_order_acquire))
+			return false;
+		item = m_items[head];
+		m_head.store((head + 1) & (Capacity - 1), std::memory_order_release);
+		return true;
+	}
+
+	// Only exact from the consumer side
+	bool empty() const
+	{
+		return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire);
+	}
+
+private:
+	T m_items[Capacity];
+	// On their own cache lines, so the two threads do not keep stealing one line from each other
+	alignas(64) std::atomic<size_t> m_head{ 0 };
+	alignas(64) std::atomic<size_t> m_tail{ 0 };
+};
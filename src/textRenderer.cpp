@@ -84,7 +84,6 @@ TextRenderer::~TextRenderer() {
 	glDeleteVertexArrays(1, &mesh.vao);
 	glDeleteBuffers(1, &VBO);
 	glDeleteVertexArrays(1, &VAO);
-	glDisableVertexAttribArray(0);
 
 	glDeleteShader(effect.vertex);
 	glDeleteShader(effect.fragment);
@@ -102,16 +101,30 @@ void TextRenderer::setScale(vec2 scale) {
 	m_scale = scale;
 }
 void TextRenderer::renderString(const mat3& projection, std::string text) {
-	transform_begin();
-	transform_translate(m_position);
-	transform_scale(m_scale);
-	transform_end();
+	TextDraw draw;
+	capture(text, draw);
+	renderString(projection, draw);
+}
+
+void TextRenderer::capture(const std::string& text, TextDraw& draw) const {
+	draw.font = this;
+	draw.position = m_position;
+	draw.scale = m_scale;
+	draw.color = m_color;
+	draw.text = text;
+}
+
+// Only reads the glyphs and GL objects, so recorded strings of a renderer can be drawn
+// on the render thread while the simulation moves it
+void TextRenderer::renderString(const mat3& projection, const TextDraw& text) const {
+	// Same as transform_translate then transform_scale, without writing the transform
+	mat3 transform = { { text.scale.x, 0.f, 0.f }, { 0.f, text.scale.y, 0.f }, { text.position.x, text.position.y, 1.f } };
 
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	gl_enable(GL_BLEND);
+	gl_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 	// Setting shaders
-	glUseProgram(effect.program);
+	gl_use_program(effect.program);
 
 	GLint projection_uloc = glGetUniformLocation(effect.program, "projection");
 	GLint transform_uloc = glGetUniformLocation(effect.program, "transform");
@@ -120,18 +133,21 @@ void TextRenderer::renderString(const mat3& projection, std::string text) {
 
 
 	// Activate corresponding render state	
-	glUniform3f(glGetUniformLocation(effect.program, "textColor"), m_color.x, m_color.y, m_color.z);
-	glActiveTexture(GL_TEXTURE0);
-	glBindVertexArray(VAO);
+	glUniform3f(glGetUniformLocation(effect.program, "textColor"), text.color.x, text.color.y, text.color.z);
+	gl_active_texture(GL_TEXTURE0);
+	gl_bind_vertex_array(VAO);
 
 	float x = 0;
 	float y = 0;
 
 	// Iterate through all characters
 	std::string::const_iterator c;
-	for (c = text.begin(); c != text.end(); c++)
+	for (c = text.text.begin(); c != text.text.end(); c++)
 	{
-		Character ch = *characters[*c];
+		std::map<GLchar, Character*>::const_iterator glyph = characters.find(*c);
+		if (glyph == characters.end())
+			continue;
+		const Character& ch = *glyph->second;
 
 		GLfloat xpos = x + ch.bearing.x;
 		GLfloat ypos = y - (ch.size.y - ch.bearing.y);
@@ -149,30 +165,30 @@ void TextRenderer::renderString(const mat3& projection, std::string text) {
 		{ xpos + w, ypos + h,   1.0, 0.0 }
 		};
 		// Render glyph texture over quad
-		glBindTexture(GL_TEXTURE_2D, ch.textureId);
+		gl_bind_texture(GL_TEXTURE_2D, ch.textureId);
 		// Update content of VBO memory
-		glBindBuffer(GL_ARRAY_BUFFER, VBO);
+		gl_bind_buffer(GL_ARRAY_BUFFER, VBO);
 		glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices);
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		// Render quad
-		glDrawArrays(GL_TRIANGLES, 0, 6);
+		gl_draw_arrays(GL_TRIANGLES, 0, 6);
 		// Now advance cursors for next glyph (note that advance is number of 1/64 pixels)
 		x += (ch.advance >> 6); // Bitshift by 6 to get value in pixels (2^6 = 64)
 	}
-	glBindVertexArray(0);
-	glBindTexture(GL_TEXTURE_2D, 0);
 }
 void TextRenderer::draw(const mat3& projection) {
 	// TODO
 	return;
 }
 
-float TextRenderer::get_width_of_string(std::string text) {
+float TextRenderer::get_width_of_string(std::string text) const {
 	std::string::const_iterator c;
 	float return_value = 0.f;
-	Character ch;
+	Character ch = {};
 	for (c = text.begin(); c != text.end(); c++) {
-		ch = *characters[*c]; return_value += (ch.advance >> 6);
+		std::map<GLchar, Character*>::const_iterator glyph = characters.find(*c);
+		if (glyph == characters.end())
+			continue;
+		ch = *glyph->second; return_value += (ch.advance >> 6);
 	}
 	return return_value + ch.size.x;
 }
@@ -19,6 +19,18 @@ struct Character {
 	GLuint advance;
 };
 
+class TextRenderer;
+
+// A string with the position, scale and color its renderer had when it was recorded,
+// drawn later without reading or changing the renderer's own settings
+struct TextDraw {
+	const TextRenderer* font;
+	vec2 position;
+	vec2 scale;
+	vec3 color;
+	std::string text;
+};
+
 class TextRenderer : public Renderable {
 public:
 	TextRenderer(std::string font_name, int size);
@@ -27,8 +39,11 @@ public:
 	void setPosition(vec2 position);
 	void setScale(vec2 scale);
 	void renderString(const mat3& projection, std::string text);
+	void renderString(const mat3& projection, const TextDraw& text) const;
+	// Records renderString(text) with the current settings, reusing draw's string
+	void capture(const std::string& text, TextDraw& draw) const;
 	void draw(const mat3& projection);
-	float get_width_of_string(std::string text);
+	float get_width_of_string(std::string text) const;
 
 
 private:
@@ -2,6 +2,7 @@
 
 #include "common.hpp"
 #include "fighterInfo.hpp"
+#include "screenFrame.hpp"
 #include <string.h>
 
 class TextureRenderer : public Renderable
@@ -15,6 +16,8 @@ public:
 
 	// projection is the 2D orthographic projection matrix
 	void draw(const mat3& projection)override;
+	// Adds the picture to a menu's frame
+	void capture(ScreenFrame& frame);
 
 	// Returns the current bubble position
 	vec2 get_position()const;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+
+// Hands the latest value from exactly one producer thread to exactly one consumer
+// thread without either waiting on the other. The producer fills its own slot and
+// swaps it with the ready slot, the consumer swaps the ready slot with its own when a
+// newer one was published. Each side owns one slot at any time, so neither ever sees
+// a half written value, and values the consumer was too slow for are skipped.
+template <typename T>
+class TripleBuffer
+{
+public:
+	// Producer side, the slot to fill. Holds whatever it held three publishes ago
+	T& write_buffer() { return m_slots[m_write]; }
+
+	// Producer side, makes the filled slot the ready one
+	void publish()
+	{
+		int previous = m_ready.exchange(m_write | DIRTY, std::memory_order_acq_rel);
+		m_write = previous & INDEX_MASK;
+	}
+
+	// Consumer side, true when a newer slot was published since the last acquire,
+	// read_buffer() then holds it
+	bool acquire()
+	{
+		if ((m_ready.load(std::memory_order_relaxed) & DIRTY) == 0)
+			return false;
+		int previous = m_ready.exchange(m_read, std::memory_order_acq_rel);
+		m_read = previous & INDEX_MASK;
+		return true;
+	}
+
+	// Consumer side, the last acquired slot
+	T& read_buffer() { return m_slots[m_read]; }
+
+private:
+	static const int DIRTY = 4;
+	static const int INDEX_MASK = 3;
+
+	T m_slots[3];
+	int m_write = 0;
+	int m_read = 1;
+	std::atomic<int> m_ready{ 2 };
+};
@@ -2,94 +2,36 @@
 
 #include <iostream>
 
-bool Water::init() {
+bool Water::init(PostProcessChain* chain) {
 	//m_dead_time = -1;
+	m_chain = chain;
 	m_is_wavy = false;
 
-	// Since we are not going to apply transformation to this screen geometry
-	// The coordinates are set to fill the standard openGL window [-1, -1 .. 1, 1]
-	// Make the size slightly larger then the screen to crop the boundary
-	static const GLfloat screen_vertex_buffer_data[] = {
-		-1.05f, -1.05f, 0.0f,
-		1.05f, -1.05f, 0.0f,
-		-1.05f,  1.05f, 0.0f,
-		-1.05f,  1.05f, 0.0f,
-		1.05f, -1.05f, 0.0f,
-		1.05f,  1.05f, 0.0f,
-	};
-
-	// Clearing errors
-	gl_flush_errors();
-
-	// Vertex Buffer creation
-	glGenBuffers(1, &mesh.vbo);
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-	glBufferData(GL_ARRAY_BUFFER, sizeof(screen_vertex_buffer_data), screen_vertex_buffer_data, GL_STATIC_DRAW);
-
-	if (gl_has_errors())
-		return false;
-
-	// Loading shaders
-	if (!effect.load_from_file(shader_path("water.vs.glsl"), shader_path("water.fs.glsl")))
-		return false;
+	PostEffect wave = { "wave", POST_RESAMPLE, shader_path("postWave.glsl"), 1.f, "", false, nullptr };
 
-	return true;
-}
-
-void Water::destroy() {
-	glDeleteBuffers(1, &mesh.vbo);
+	PostEffect fade = { "game_over_fade", POST_PIXEL, shader_path("postFade.glsl"), 1.f, "", false, nullptr };
+	fade.set_uniforms = [this](GLuint program) {
+		GLint game_over_timer_uloc = glGetUniformLocation(program, "game_over_timer");
+		glUniform1f(game_over_timer_uloc, (m_game_over_time > 0) ? (float)((glfwGetTime() - m_game_over_time) * 10.0f) : -1);
+	};
 
-	glDeleteShader(effect.vertex);
-	glDeleteShader(effect.fragment);
-	glDeleteShader(effect.program);
-	effect.release();
+	return m_chain->add(wave) && m_chain->add(fade);
 }
 
 void Water::set_is_wavy(bool is_wavy) {
 	m_is_wavy = is_wavy;
-}
-
-void Water::draw(const mat3& projection) {
-	// Enabling alpha channel for textures
-	glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glEnable(GL_DEPTH_TEST);
-
-	// Setting shaders
-	glUseProgram(effect.program);
-
-	// Set screen_texture sampling to texture unit 0
-	// Set clock
-	GLuint screen_text_uloc = glGetUniformLocation(effect.program, "screen_texture");
-	GLuint time_uloc = glGetUniformLocation(effect.program, "time");
-	GLuint dead_timer_uloc = glGetUniformLocation(effect.program, "dead_timer");
-	GLuint is_wavy_uloc = glGetUniformLocation(effect.program, "is_wavy");
-
-	glUniform1i(screen_text_uloc, 0);
-	glUniform1f(time_uloc, (float)(glfwGetTime() * 10.0f));
-	glUniform1f(dead_timer_uloc, (m_game_over_time > 0) ? (float)((glfwGetTime() - m_game_over_time) * 10.0f) : -1);
-	glUniform1i(is_wavy_uloc, m_is_wavy);
-
-
-	// Draw the screen texture on the quad geometry
-	// Setting vertices
-	glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
-
-	// Bind to attribute 0 (in_position) as in the vertex shader
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, (void*)0);
-
-	// Draw
-	glDrawArrays(GL_TRIANGLES, 0, 6); // 2*3 indices starting at 0 -> 2 triangles
-	glDisableVertexAttribArray(0);
+	m_chain->set_enabled("wave", is_wavy);
 }
 
 // TODO NOT USED
 void Water::set_game_over(std::string winnerName) {
 	//m_game_over_time = glfwGetTime();
+	//m_chain->set_enabled("game_over_fade", true);
 	m_winner_name = winnerName;
 }
 
 void Water::reset_game_over() {
 	m_game_over_time = -1;
 	m_is_game_over = false;
+	m_chain->set_enabled("game_over_fade", false);
 }
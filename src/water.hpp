@@ -1,27 +1,25 @@
 #pragma once
 
 #include "common.hpp"
+#include "postProcess.hpp"
 #include "textRenderer.hpp"
 
-class Water : public Renderable
+// Stage screen effects, the heat wave distortion and the game over fade, applied
+// by the post-processing chain
+class Water
 {
 	TextRenderer* title;
 
   public:
-	// Creates all the associated render resources and default transform
-	bool init();
-
-	// Releases all associated resources
-	void destroy();
-
-	// Renders the water
-	void draw(const mat3 &projection) override;
+	// Adds the effects to the chain, all disabled
+	bool init(PostProcessChain* chain);
 
 	void set_is_wavy(bool is_wavy);
 	void set_game_over(std::string winnerName);
 	void reset_game_over();
 
   private:
+	PostProcessChain* m_chain;
 	bool m_is_wavy;
 	bool m_is_game_over = false;
 	float m_game_over_time = -1;
@@ -3,8 +3,10 @@
 #include "world.hpp"
 
 // stlib
+#include <algorithm>
 #include <string.h>
 #include <cassert>
+#include <limits>
 #include <sstream>
 
 #define HEAT_WAVE_RATE 75
@@ -18,11 +20,12 @@
 // Same as static in c, local to compilation unit
 namespace
 {
-const size_t MAX_FIGHTERS = 4;
-//NOTE: Since we do not currently have a menu, these constants determine the amount of
-//fighters that will be spawned in at the beginning of a game
 const int MAX_PLAYERS = 2;
-const int MAX_AI = 2;
+const float HIT_FLASH_MS = 100.f;
+// Frames after a mode change left out of the allocation totals, the new level is still being set up
+const int ALLOC_WARMUP_FRAMES = 60;
+// How early the players may press before their fighter can act, six ticks at 60 fps
+const float INPUT_BUFFER_MS = 100.f;
 
 namespace
 {
@@ -39,6 +42,10 @@ World::World() : m_player1(1), m_player2(2)
 {
 	// Seeding rng with random device
 	m_rng = std::default_random_engine(std::random_device()());
+
+	// The AI acts on the spot, only the players' presses are buffered
+	m_player1.set_input_buffer_ms(INPUT_BUFFER_MS);
+	m_player2.set_input_buffer_ms(INPUT_BUFFER_MS);
 }
 
 World::~World()
@@ -52,6 +59,26 @@ bool World::init(vec2 screen, GameMode mode)
 	// GLFW / OGL Initialization
 	// Core Opengl 3.
 	glfwSetErrorCallback(glfw_err_cb);
+
+	// Headless runs use Mesa's software rasterizer where there is one, so their draw
+	// times compare across machines, and play audio into the void
+	if (m_headless)
+	{
+		SDL_setenv("LIBGL_ALWAYS_SOFTWARE", "1", 0);
+		SDL_setenv("SDL_AUDIODRIVER", "dummy", 1);
+	}
+
+	// Offscreen runs need no display server, GLFW's null platform only creates contexts
+	if (m_offscreen)
+	{
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+		glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+#else
+		fprintf(stderr, "Offscreen rendering needs GLFW 3.4 or newer\n");
+		return false;
+#endif
+	}
+
 	if (!glfwInit())
 	{
 		fprintf(stderr, "Failed to initialize GLFW");
@@ -66,14 +93,29 @@ bool World::init(vec2 screen, GameMode mode)
 	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
 	glfwWindowHint(GLFW_RESIZABLE, 0);
+	glfwWindowHint(GLFW_VISIBLE, m_headless ? 0 : 1);
 	is_fullscreen = false;
 	m_monitor = glfwGetPrimaryMonitor();
 	m_vidmode = glfwGetVideoMode(m_monitor);
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+	if (m_offscreen)
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
 	m_window = glfwCreateWindow((int)screen.x, (int)screen.y, "VEGGIE VENGEANCE", nullptr, nullptr);
+#if GLFW_VERSION_MAJOR > 3 || (GLFW_VERSION_MAJOR == 3 && GLFW_VERSION_MINOR >= 4)
+	// Mesa 25.1 dropped OSMesa, newer installs only have surfaceless EGL
+	if (m_window == nullptr && m_offscreen)
+	{
+		glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+		m_window = glfwCreateWindow((int)screen.x, (int)screen.y, "VEGGIE VENGEANCE", nullptr, nullptr);
+	}
+#endif
 	if (m_window == nullptr) return false;
 
 	glfwMakeContextCurrent(m_window);
-	glfwSwapInterval(1); // vsync
+	// Headless runs go as fast as they can, whatever was asked for
+	int refresh_rate = m_vidmode != nullptr ? m_vidmode->refreshRate : 0;
+	m_frame_pacer.init(m_headless ? PRESENT_UNCAPPED : m_present_mode, m_frame_cap_fps, refresh_rate);
 
 	// Load OpenGL function pointers
 	gl3w_init();
@@ -82,18 +124,40 @@ bool World::init(vec2 screen, GameMode mode)
 	// Input is handled using GLFW, for more info see
 	// http://www.glfw.org/docs/latest/input_guide.html
 	glfwSetWindowUserPointer(m_window, this);
-	auto key_redirect = [](GLFWwindow *wnd, int _0, int _1, int _2, int _3) { ((World *)glfwGetWindowUserPointer(wnd))->on_key(wnd, _0, _1, _2, _3); };
+	auto key_redirect = [](GLFWwindow *wnd, int _0, int _1, int _2, int _3) { ((World *)glfwGetWindowUserPointer(wnd))->queue_key(_0, _1, _2, _3); };
 	auto cursor_pos_redirect = [](GLFWwindow *wnd, double _0, double _1) { ((World *)glfwGetWindowUserPointer(wnd))->on_mouse_move(wnd, _0, _1); };
 	glfwSetKeyCallback(m_window, key_redirect);
 	glfwSetCursorPosCallback(m_window, cursor_pos_redirect);
 
-	// Create a frame buffer
-	m_frame_buffer = 0;
-	glGenFramebuffers(1, &m_frame_buffer);
-	glBindFramebuffer(GL_FRAMEBUFFER, m_frame_buffer);
+	int fb_w, fb_h;
+	glfwGetFramebufferSize(m_window, &fb_w, &fb_h);
+	m_framebuffer_size = { (float)fb_w, (float)fb_h };
+
+	// Without a window the frame ends up in a texture, which read_frame() reads back
+	if (m_offscreen)
+	{
+		int w, h;
+		glfwGetFramebufferSize(m_window, &w, &h);
+		m_screen_target = m_screen_targets.acquire(w, h, true);
+		if (m_screen_target == nullptr)
+			return false;
+		gl_set_screen_framebuffer(m_screen_target->frame_buffer);
+	}
+
+	// Screen effects render through their own targets
+	if (!m_post_process.init())
+		return false;
+
+	// Holds 60 fps by drawing the scene at down to half resolution
+	if (m_dynamic_resolution_on)
+		m_dynamic_resolution.init(0.5f, 1.f, 1000.f / 60.f);
+
+	// Pass timings for the trace, otherwise started with the overlay
+	if (profiler_is_enabled())
+		gpu_profiler_init();
 
-	// Initialize the screen texture
-	m_screen_tex.create_from_screen(m_window);
+	if (!m_perf_hud.init())
+		return false;
 
 	//-------------------------------------------------------------------------
 	// Loading music and sounds
@@ -109,6 +173,17 @@ bool World::init(vec2 screen, GameMode mode)
 		return false;
 	}
 
+	// Replays drive headless runs, there is no one holding a pad
+	if (!m_headless && m_input_poll_hz > 0 && !m_input_thread.start(m_input_poll_hz))
+		fprintf(stderr, "Playing without gamepads\n");
+
+	if (m_hot_reload_on && !m_hot_reload.init())
+	{
+		fprintf(stderr, "Playing without hot reload\n");
+		m_hot_reload.destroy();
+		m_hot_reload_on = false;
+	}
+
 	m_bgms.emplace_back(Mix_LoadMUS(audio_path("/bgm/Abandoned Hopes.wav")));
 	m_bgms.emplace_back(Mix_LoadMUS(audio_path("/bgm/Crimson Drive.wav")));
 	m_bgms.emplace_back(Mix_LoadMUS(audio_path("/bgm/Fields of Ice.wav")));
@@ -148,23 +223,64 @@ bool World::init(vec2 screen, GameMode mode)
 	Mix_PlayMusic(m_bgms[m_background_track], -1);
 	fprintf(stderr, "Loaded music\n");
 	
-	load_fighter_templates();
-
 	m_screen = screen; // to pass on screen size to renderables
 
 	m_screenBoundingBox = BoundingBox(0.f, 0.f, 1200.f, 800.f);
 	m_platforms_tree = new QuadTree(m_screenBoundingBox);
-	m_attacks_tree = new QuadTree(m_screenBoundingBox);
 
-	bool initSuccess = load_all_sprites_from_file() && set_mode(mode);
+	// GPU particles are emitted with GL calls, which the simulation thread cannot make
+	if (m_use_sim_thread && m_gpu_particles)
+		fprintf(stderr, "GPU particles are not simulated on the simulation thread, using CPU particles\n");
+	bool gpu_particles = m_gpu_particles && !m_use_sim_thread;
 
-	return m_water.init() && initSuccess;
+	bool initSuccess = m_jobs.init(m_job_workers) && m_particles.init(gpu_particles) && m_render_queue.init() && load_all_sprites_from_file() && load_fighter_definitions() &&
+		Bomb::load_texture() && Projectile::load_texture() && set_mode(mode);
+
+	return init_post_effects() && initSuccess;
+}
+
+// Screen effects in the order they are applied, the chain fuses the per-pixel ones
+bool World::init_post_effects()
+{
+	// Bloom: bright parts extracted at half resolution, blurred at quarter resolution
+	// and added back in the fused pass
+	PostEffect bloom_extract = { "bloom_extract", POST_FILTER, shader_path("bloomExtract.fs.glsl"), 0.5f, "", m_bloom, nullptr };
+	bloom_extract.set_uniforms = [](GLuint program) {
+		glUniform1f(glGetUniformLocation(program, "bloom_threshold"), 0.8f);
+	};
+	PostEffect bloom_blur = { "bloom_blur", POST_FILTER, shader_path("blur.fs.glsl"), 0.25f, "bloom_extract", m_bloom, nullptr };
+	PostEffect bloom = { "bloom", POST_PIXEL, shader_path("postBloom.glsl"), 1.f, "", m_bloom, nullptr };
+	bloom.set_uniforms = [](GLuint program) {
+		glUniform1f(glGetUniformLocation(program, "bloom_strength"), 0.6f);
+	};
+
+	PostEffect hit_flash = { "hit_flash", POST_PIXEL, shader_path("postHitFlash.glsl"), 1.f, "", false, nullptr };
+	hit_flash.set_uniforms = [this](GLuint program) {
+		glUniform1f(glGetUniformLocation(program, "hit_flash_amount"), 0.25f * m_drawn_hit_flash_ms / HIT_FLASH_MS);
+	};
+
+	return m_post_process.add(bloom_extract) && m_post_process.add(bloom_blur) &&
+		m_water.init(&m_post_process) &&
+		m_post_process.add(bloom) && m_post_process.add(hit_flash);
 }
 
 // Releases all the associated resources
 void World::destroy()
 {
-	glDeleteFramebuffers(1, &m_frame_buffer);
+	m_sim_thread.stop();
+	m_input_thread.stop();
+	m_jobs.destroy();
+	m_hot_reload.destroy();
+
+	m_post_process.destroy();
+	gl_set_screen_framebuffer(0);
+	m_screen_targets.destroy();
+	m_screen_target = nullptr;
+	m_dynamic_resolution.destroy();
+	gpu_profiler_destroy();
+	m_perf_hud.destroy();
+	delete m_gpu_timings_text;
+	m_gpu_timings_text = nullptr;
 	
 	if (m_bgms.size() > 0) {
 		for (auto &music : m_bgms)
@@ -200,16 +316,13 @@ void World::destroy()
 	clear_all_fighters();
 
 	m_platforms_tree->clear();
-	m_attacks_tree->clear();
 
 	for (auto &k : m_knives) {
 		k.destroy();
 	}
 	m_knives.clear();
-	for (auto pe_it = m_particle_emitters.begin(); pe_it != m_particle_emitters.end();) {
-		delete *pe_it;
-		pe_it = m_particle_emitters.erase(pe_it);
-	}
+	m_particles.destroy();
+	m_render_queue.destroy();
 	if (m_bg.m_initialized) {
 		m_bg.destroy();
 	}
@@ -222,19 +335,39 @@ void World::destroy()
 // Update our game world
 bool World::update(float elapsed_ms)
 {
-	int w, h;
-	glfwGetFramebufferSize(m_window, &w, &h);
-	vec2 screen = {(float)w, (float)h};
+	PROFILE_ZONE("World::update");
+
+	m_update_start_ns = profiler_now_ns();
+	m_tick++;
+
+	if (m_replay_recorder != nullptr)
+		m_replay_recorder->end_frame();
+
+	handle_queued_input();
+
+	// Checked at the start of a tick, no fighter is halfway through an update
+	if (m_hot_reload_on && m_hot_reload.poll())
+		m_sim_thread.run_on_render_thread([this] { apply_hot_reload(); });
+
+	vec2 screen = m_framebuffer_size;
+
+	if (m_hit_flash_ms > 0.f)
+	{
+		m_hit_flash_ms = std::max(0.f, m_hit_flash_ms - elapsed_ms);
+		m_hit_flash_on = m_hit_flash_ms > 0.f;
+	}
 
 	// Updating all entities, making the entities
 	// faster based on current
 
 	//if (m_paused) {
 	if (m_paused || m_game_over) {
+		animate_fighters(elapsed_ms);
 		return true;
 	}
 
 	if (is_ui_mode() && m_platforms_tree->size() > 0) {
+		PROFILE_ZONE("menu update");
 		for (AI& ai : m_char_select_ais) {
 			ai.update(elapsed_ms, m_platforms_tree, m_player1.get_position(),
 				m_player1.get_facing_front(), m_player1.get_health(), m_player1.is_blocking());
@@ -253,100 +386,73 @@ bool World::update(float elapsed_ms)
 
 	if (!m_paused) {
 		//mark alive players + ai as not having a collision applied before collision check
-		if (m_player1.get_in_play() && m_player1.get_alive()) {
-			m_player1.set_hurt(false);
-		}
-		if (m_player2.get_in_play() && m_player2.get_alive()) {
-			m_player2.set_hurt(false);
-		}
-		for (int i = 0; i < m_ais.size(); i++) {
-			if (m_ais[i].get_alive()) {
-				m_ais[i].set_hurt(false);
+		for (Fighter* fighter : m_fighters) {
+			if (fighter->get_alive()) {
+				fighter->set_hurt(false);
 			}
 		}
 
 		attack_collision();
-		m_attacks_tree->clear();
 		//damage effect removal loop
 		attack_deletion();
 
-		// PARTICLE EMISSION
-		for (auto& particleEmitter : m_particle_emitters) {
-			particleEmitter->update(elapsed_ms);
-		}
-
-		for (auto pe_it = m_particle_emitters.begin(); pe_it != m_particle_emitters.end();) {
-			if ((*pe_it)->get_alive_particles() == 0) {
-				delete *pe_it;
-				pe_it = m_particle_emitters.erase(pe_it);
-			}
-			else {
-				++pe_it;
-			}
-		}
-
-		// KNIVES STAGE EFFECT
-		for (auto &k : m_knives) {
-			k.update(elapsed_ms);
-			if (m_player1.get_in_play() && m_player1.get_alive() && !m_player1.is_blocking()) {
-				if (k.collides_with(m_player1)) {
-					m_player1.apply_damage(k.m_damage);
-				}
-			}
-			k.update(elapsed_ms);
-			if (m_player2.get_in_play() && m_player2.get_alive() && !m_player2.is_blocking()) {
-				if (k.collides_with(m_player2)) {
-					m_player2.apply_damage(k.m_damage);
-				}
-			}
-			for (auto &ai : m_ais) {
-				if (k.collides_with(ai)) {
-					ai.apply_damage(k.m_damage);
-				}
-			}
-
-			for (Renderable *renderable : m_platforms_tree->retrieve(*k.boundingBox, {})) {
-				Platform* platform = static_cast<Platform*>(renderable);
-				if (platform->check_collision(*k.boundingBox)) { k.m_is_on_ground = true; }
+		// Knives on the job workers while the particles update here, GPU particles make GL calls
+		{
+			JobGroup group;
+			JobFunction update_knives = [this, elapsed_ms](int, int) { knives_update(elapsed_ms); };
+			m_jobs.add(group, update_knives);
+			{
+				PROFILE_ZONE("particles update");
+				ALLOC_SCOPE("ParticleSystem::update");
+				m_particles.update(elapsed_ms);
 			}
+			m_jobs.wait(group);
 		}
 		
 		//update players + ai
-		Attack * attack = NULL;
-		if (m_player1.get_in_play())
 		{
-			attack = m_player1.update(elapsed_ms, m_platforms_tree);
-			if (attack != NULL) {
-				attack->init();
-				m_attacks.push_back(attack);
-			}
-		}
-		if (m_player2.get_in_play())
-		{
-			attack = m_player2.update(elapsed_ms, m_platforms_tree);
-			if (attack != NULL) {
-				attack->init();
-				m_attacks.push_back(attack);
-			}
+			PROFILE_ZONE("players update");
+			Attack* player_attacks[2] = { NULL, NULL };
+			m_jobs.parallel_for(2, 1, [this, elapsed_ms, &player_attacks](int begin, int end) {
+				for (int i = begin; i < end; i++) {
+					if (i == 0 && m_player1.get_in_play())
+						player_attacks[0] = m_player1.update(elapsed_ms, m_platforms_tree);
+					if (i == 1 && m_player2.get_in_play())
+						player_attacks[1] = m_player2.update(elapsed_ms, m_platforms_tree);
+				}
+			});
+			add_attack(player_attacks[0]);
+			add_attack(player_attacks[1]);
 		}
-
-		if (m_player1.get_in_play())
 		{
-			for (auto &ai : m_ais) {
-				attack = ai.update(elapsed_ms, m_platforms_tree, m_player1.get_position(), m_player1.get_facing_front(),
-					m_player1.get_health(), m_player1.is_blocking());
-				if (attack != NULL) {
-					attack->init();
-					m_attacks.push_back(attack);
+			PROFILE_ZONE("ai update");
+			if (m_player1.get_in_play())
+			{
+				// Deciding goes through state all AIs share, so only moving is spread out
+				if (m_mode == PARTY)
+					find_party_targets();
+				else
+					m_ai_targets.assign(m_ais.size(), &m_player1);
+				m_acting_ais.clear();
+				for (int i = 0; i < (int)m_ais.size(); i++) {
+					const Fighter& target = *m_ai_targets[i];
+					if (m_ais[i].think(target.get_position(), target.get_facing_front(),
+						target.get_health(), target.is_blocking())) {
+						m_acting_ais.push_back(i);
+					}
 				}
+				m_ai_attacks.assign(m_acting_ais.size(), NULL);
+				m_jobs.parallel_for((int)m_acting_ais.size(), 4, [this, elapsed_ms](int begin, int end) {
+					for (int i = begin; i < end; i++)
+						m_ai_attacks[i] = m_ais[m_acting_ais[i]].act(elapsed_ms, m_platforms_tree);
+				});
+				for (Attack* attack : m_ai_attacks)
+					add_attack(attack);
 			}
 		}
 
-		for (Attack *attack : m_attacks) {
-			m_attacks_tree->insert(attack);
-		}
-
 		if (!is_ui_mode()) {
+			PROFILE_ZONE("stage effects");
 			// STAGE EFFECTS -- 1 per stage
 			// HEAT WAVE
 			if (selected_stage == OVEN) {
@@ -384,7 +490,7 @@ bool World::update(float elapsed_ms)
 						printf("CLEARED KNIVES");
 					}
 				}*/
-				else if ((int)glfwGetTime() % FALLING_KNIVES_RATE == 0 && ((m_mode == PVP && knife_fall_count <2)
+				else if ((int)glfwGetTime() % FALLING_KNIVES_RATE == 0 && (((m_mode == PVP || m_mode == PARTY) && knife_fall_count <2)
 					|| (m_mode == PVC && knife_fall_count <1))) { //&& !m_heat_wave_on
 					set_falling_knives(true);
 				}
@@ -393,37 +499,197 @@ bool World::update(float elapsed_ms)
 		}
 	}
 	attack_update(elapsed_ms);
+	animate_fighters(elapsed_ms);
 	return true;
 }
 
+void World::animate_fighters(float ms)
+{
+	PROFILE_ZONE("animate fighters");
+	if (is_ui_mode()) {
+		AI* shown_ai = get_shown_char_select_ai();
+		if (shown_ai != nullptr)
+			shown_ai->animate(ms);
+		return;
+	}
+	for (Fighter* fighter : m_fighters)
+		fighter->animate(ms);
+}
+
+// m_char_select_ais are never deleted throughout the game but are only initialized once
+AI* World::get_shown_char_select_ai()
+{
+	if (m_mode == MENU) {
+		return &m_char_select_ais[0];
+	} else if (m_mode == CHARSELECT) {
+		FighterCharacter fc = m_menu.get_selected_char();
+		return &m_char_select_ais[fc != BLANK ? fc : 0];
+	} else if (m_mode == STAGESELECT && m_menu.get_selected_stage() == MENUBORDER) {
+		return &m_char_select_ais[0];
+	}
+	return nullptr;
+}
+
 // Render our game world
-// http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
 void World::draw()
 {
-	// Clearing error buffer
-	gl_flush_errors();
+	capture_frame(m_frame);
+	draw_frame(m_frame);
+}
 
-	// Getting size of window
-	int w, h;
-	glfwGetFramebufferSize(m_window, &w, &h);
+bool World::draw_latest_frame()
+{
+	m_sim_thread.run_pending_call();
+	RenderSnapshot* snapshot = m_sim_thread.acquire_snapshot();
+	if (snapshot == nullptr)
+		return false;
+	draw_frame(*snapshot);
+	return true;
+}
+
+// Records the entities that draw themselves as frames and everything else into the
+// snapshot's queue, in the order they used to be submitted
+void World::capture_frame(RenderSnapshot& snapshot)
+{
+	PROFILE_ZONE("World::capture_frame");
+
+	snapshot.tick = m_tick;
+	snapshot.generation = m_sim_thread.get_generation();
+	snapshot.hit_flash_on = m_hit_flash_on;
+	snapshot.hit_flash_ms = m_hit_flash_ms;
+	snapshot.heat_wave = m_heat_wave_on;
+	snapshot.show_perf_hud = m_show_perf_hud;
+	snapshot.show_gpu_timings = m_show_gpu_timings;
+
+	snapshot.attacks = (int)m_attacks.size();
+	snapshot.particle_count = m_particles.get_alive_particles();
+	snapshot.broadphase_queries = QuadTree::get_query_count();
+	snapshot.update_ms = (profiler_now_ns() - m_update_start_ns) / 1e6f;
+	QuadTree::reset_query_count();
 
-	
 	if (m_mode == DEV || m_mode == PVP)
 	{
 		m_bg.setPlayerInfo(m_player1.get_lives(), m_player1.get_health(), m_player1.get_block_tank(), m_player2.get_lives(), m_player2.get_health(), m_player2.get_block_tank());
 	}
 	else if (m_mode == TUTORIAL || m_mode == PVC)
 	{
-		AI ai = m_ais.front();
+		const AI& ai = m_ais.front();
 		m_bg.setPlayerInfo(m_player1.get_lives(), m_player1.get_health(), m_player1.get_block_tank(), ai.get_lives(), ai.get_health(), ai.get_block_tank());
 	}
+	else if (m_mode == PARTY)
+	{
+		int standing = 0;
+		for (const AI& ai : m_ais) {
+			if (ai.get_alive() || ai.get_lives() > 0)
+				standing++;
+		}
+		m_bg.setPlayerInfo(m_player1.get_lives(), m_player1.get_health(), m_player1.get_block_tank(), -1, -1, -1);
+		m_bg.setFightersLeft(standing, (int)m_ais.size());
+	}
+
+	// All frames are recorded before anything is submitted, the queue keeps pointers
+	// to them. Fighters go first, they move the nameplates the background records
+	snapshot.screen.clear();
+	snapshot.fighters.clear();
+	snapshot.knives.clear();
+	if (is_ui_mode()) {
+		AI* shown_ai = get_shown_char_select_ai();
+		if (shown_ai != nullptr) {
+			snapshot.fighters.emplace_back();
+			shown_ai->capture(snapshot.fighters.back());
+		}
+		m_menu.capture(snapshot.screen);
+	} else {
+		for (Fighter* fighter : m_fighters) {
+			snapshot.fighters.emplace_back();
+			fighter->capture(snapshot.fighters.back());
+		}
+		snapshot.knives.resize(m_knives.size());
+		for (size_t i = 0; i < m_knives.size(); i++)
+			m_knives[i].capture(snapshot.knives[i]);
+		m_bg.capture(snapshot.screen);
+	}
+	m_particles.capture(snapshot.particles);
+
+	// Queue up entities, draw order comes from their render layers
+	RenderQueue& queue = snapshot.queue;
+	queue.clear();
+	snapshot.screen.submit(queue);
+	if (is_ui_mode()) {
+		if (!snapshot.fighters.empty()) {
+			snapshot.fighters[0].submit(queue);
+		} else if (m_mode == STAGESELECT) {
+			m_platforms_tree->retrieve(m_screenBoundingBox, {})[1]->submit(queue);
+		} else if (m_mode == FIGHTINTRO) {
+			m_platforms_tree->retrieve(m_screenBoundingBox, {})[2]->submit(queue);
+		}
+	} else {
+		for (auto &k : snapshot.knives)
+			k.submit(queue);
+
+		for (auto &fighter : snapshot.fighters)
+			fighter.submit(queue);
+
+		// Sprites, recorded by value
+		for (auto &attack : m_attacks)
+			attack->submit(queue);
+
+		for (auto *platform : m_platforms_tree->retrieve(m_screenBoundingBox, {}))
+			platform->submit(queue);
+	}
+	snapshot.particles.submit(queue);
+	queue.sort();
+}
+
+// http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
+void World::draw_frame(RenderSnapshot& snapshot)
+{
+	PROFILE_ZONE("World::draw");
+
+	// Clearing error buffer
+	gl_flush_errors();
+	gl_state_begin_frame();
+
+	// Getting size of window
+	int w, h;
+	glfwGetFramebufferSize(m_window, &w, &h);
+
+	// Screen effects and overlays the simulation asked for
+	m_post_process.set_enabled("hit_flash", snapshot.hit_flash_on);
+	m_drawn_hit_flash_ms = snapshot.hit_flash_ms;
+	m_water.set_is_wavy(snapshot.heat_wave);
+	if (snapshot.show_perf_hud != m_perf_hud.is_visible())
+		m_perf_hud.set_visible(snapshot.show_perf_hud);
+	if (snapshot.show_gpu_timings && !gpu_profiler_is_enabled())
+		gpu_profiler_init();
+
+	double draw_start = glfwGetTime();
+	m_dynamic_resolution.begin_frame();
+	gpu_profiler_begin_frame();
+
+	if (m_perf_hud.is_visible())
+		collect_perf_stats(snapshot);
 
 	/////////////////////////////////////
-	// First render to the custom framebuffer
-	glBindFramebuffer(GL_FRAMEBUFFER, m_frame_buffer);
+	// First render to the post-processing target, or straight to the screen when no
+	// screen effect is on and the scene is drawn at full resolution
+	float render_scale = m_dynamic_resolution.get_scale();
+	bool post_process = m_post_process.is_active() || render_scale < 1.f;
+	int render_w = w;
+	int render_h = h;
+	if (post_process)
+	{
+		m_post_process.begin(w, h, render_scale);
+		render_w = m_post_process.get_scene_width();
+		render_h = m_post_process.get_scene_height();
+	}
+	else
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, gl_screen_framebuffer());
+	}
 
 	// Clearing backbuffer
-	glViewport(0, 0, w, h);
+	glViewport(0, 0, render_w, render_h);
 	glDepthRange(0.00001, 10);
 	const float clear_color[3] = {1.f, 1.f, 1.f};
 	glClearColor(clear_color[0], clear_color[1], clear_color[2], 1.0);
@@ -442,73 +708,55 @@ void World::draw()
 	float tx = -(right + left) / (right - left);
 	float ty = -(top + bottom) / (top - bottom);
 	mat3 projection_2D{{sx, 0.f, 0.f}, {0.f, sy, 0.f}, {tx, ty, 1.f}};
+	mat3 overlay_projection = projection_2D;
+	// Zoomed in by 5% to crop the boundary, screen effects sample past the edges
+	mat3 overscan{{1.05f, 0.f, 0.f}, {0.f, 1.05f, 0.f}, {0.f, 0.f, 1.f}};
+	projection_2D = mul(overscan, projection_2D);
 
-	// Drawing entities
-	if (is_ui_mode()) {
-		m_menu.draw(projection_2D); // m_char_select_ais are never deleted throughout the game but are only initialized once
-		if (m_mode == MENU) {
-			m_char_select_ais[0].draw(projection_2D);
-		} else if (m_mode == CHARSELECT) {
-			FighterCharacter fc = m_menu.get_selected_char();
-			if (fc != BLANK) { m_char_select_ais[fc].draw(projection_2D); }
-			else { m_char_select_ais[0].draw(projection_2D);}
-		} else if (m_mode == STAGESELECT) {
-			if (m_menu.get_selected_stage() != MENUBORDER) {
-				m_platforms_tree->retrieve(m_screenBoundingBox, {})[1]->draw(projection_2D);
-			} else { m_char_select_ais[0].draw(projection_2D); }
-		} else if (m_mode == FIGHTINTRO) {
-			m_platforms_tree->retrieve(m_screenBoundingBox, {})[2]->draw(projection_2D);
-		}
-	} else {
-		m_bg.draw(projection_2D);
-
-		for (auto &k : m_knives)
-			k.draw(projection_2D);
-
-		if (m_player1.get_in_play())
-		{
-			m_player1.draw(projection_2D);
-		}
-		if (m_player2.get_in_play())
-		{
-			m_player2.draw(projection_2D);
-		}
-		for (auto &fighter : m_ais)
-			fighter.draw(projection_2D);
-
-		for (auto &attack : m_attacks)
-			attack->draw(projection_2D);
-
-		for (auto *platform : m_platforms_tree->retrieve(m_screenBoundingBox, {}))
-			platform->draw(projection_2D);
-
-	}
-
-	for (auto& particleEmitter : m_particle_emitters) {
-		particleEmitter->draw(projection_2D);
+	{
+		PROFILE_ZONE("render queue");
+		GPU_PROFILE_ZONE("scene");
+		m_render_queue.execute(projection_2D, snapshot.queue);
 	}
 
 	/////////////////////
 	// Truly render to the screen
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
-
-	// Clearing backbuffer
-	glViewport(0, 0, w, h);
-	glDepthRange(0, 10);
-	glClearColor(0, 0, 0, 1.0);
-	glClearDepth(1.f);
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	if (post_process)
+	{
+		PROFILE_ZONE("post process");
+		GPU_PROFILE_ZONE("post process");
+		m_post_process.end();
+	}
 
-	// Bind our texture in Texture Unit 0
-	glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, m_screen_tex.id);
+	// Drawn on the screen at full resolution, after the effects
+	if (snapshot.show_gpu_timings)
+		draw_gpu_timings(overlay_projection);
+	if (m_perf_hud.is_visible())
+	{
+		m_perf_hud.set_position({ (float)(w - PerfHud::WIDTH - 10), 10.f });
+		m_perf_hud.draw(overlay_projection);
+	}
 
-	////////////////////////////
+	gpu_profiler_end_frame();
+	m_dynamic_resolution.end_frame();
+	m_draw_ms = (float)((glfwGetTime() - draw_start) * 1000.0);
+	m_dynamic_resolution.update(m_draw_ms);
 
-	m_water.draw(projection_2D);
 	//////////////////
 	// Presenting
-	glfwSwapBuffers(m_window);
+	if (!m_offscreen)
+	{
+		PROFILE_ZONE("swap buffers");
+		glfwSwapBuffers(m_window);
+	}
+	m_frame_pacer.end_frame();
+
+	// The swap call returns once the frame is queued, not shown
+	if (m_input_latency.is_enabled())
+	{
+		glFinish();
+		m_input_latency.add_presented_frame(profiler_now_ns(), snapshot.tick);
+	}
 }
 
 // Should the game be over ?
@@ -522,12 +770,11 @@ bool World::spawn_ai(AIType type)
 {
 	//intialize ai with next ID and provided type
 	AI ai(idCounter, type);
-	if (ai.init(3, "AI", BROCCOLI)) // TODO: RANDOMIZE BUT NOT INCLUDING BLANK PLACEHOLDER 
+	if (ai.init(3, "AI", BROCCOLI, m_components)) // TODO: RANDOMIZE BUT NOT INCLUDING BLANK PLACEHOLDER 
 	{
 		//assure the next ID given is unique
 		idCounter++;
 		m_ais.emplace_back(ai);
-		m_fighters.emplace_back(ai);
 		return true;
 	}
 	fprintf(stderr, "Failed to spawn fighter");
@@ -537,16 +784,35 @@ bool World::spawn_ai(AIType type)
 bool World::spawn_ai(AIType type, FighterCharacter fc)
 {
 	AI ai(idCounter, type);
-	if (ai.init(3, "AI", fc))
+	if (ai.init(3, "AI", fc, m_components))
 	{
 		idCounter++;
 		m_ais.emplace_back(ai);
-		m_fighters.emplace_back(ai);
 		return true;
 	}
 	fprintf(stderr, "Failed to spawn fighter");
 	return false;
 }
+
+bool World::spawn_party(int count)
+{
+	const AIType types[] = { INIT, CHASE, RANDOM };
+	m_ais.reserve(count);
+	for (int i = 0; i < count; i++) {
+		AI ai(idCounter, types[i % 3]);
+		if (!ai.init(3, "AI " + std::to_string(i + 1), (FighterCharacter)(i % BLANK), m_components)) {
+			fprintf(stderr, "Failed to spawn fighter");
+			return false;
+		}
+		idCounter++;
+		// Evenly over the main platform, keeping clear of player 1's spot
+		float x = 400.f + (i + 0.5f) * 750.f / count;
+		ai.set_spawn_position({ x, 525.f });
+		m_ais.emplace_back(ai);
+	}
+	return true;
+}
+
 // Creates a platform and if successful, adds it to the list of platform
 bool World::spawn_platform(float xpos, float ypos, float width, float height)
 {
@@ -561,8 +827,30 @@ bool World::spawn_platform(float xpos, float ypos, float width, float height)
 }
 
 // On key callback
+void World::queue_key(int key, int scancode, int action, int mods)
+{
+	m_input_queue.push({ key, scancode, action, mods, profiler_now_ns() });
+}
+
+// Acts on the keys and pad changes that arrived since the last tick, in order
+void World::handle_queued_input()
+{
+	InputEvent pad_event;
+	while (m_input_thread.pop(pad_event))
+		m_input_queue.push(pad_event);
+
+	for (const InputEvent &event : m_input_queue.take_events())
+	{
+		if (m_input_latency.is_enabled() && event.action == GLFW_PRESS)
+			m_input_latency.add_input(event.time_ns, m_tick);
+		on_key(m_window, event.key, event.scancode, event.action, event.mods);
+	}
+}
+
 void World::on_key(GLFWwindow *, int key, int, int action, int mod)
 {
+	if (m_replay_recorder != nullptr)
+		m_replay_recorder->record_key(key, action, mod);
 	
 	////////////// TEST MODES
 	//if (action == GLFW_RELEASE && key == GLFW_KEY_1) // TEST
@@ -658,25 +946,31 @@ void World::on_key(GLFWwindow *, int key, int, int action, int mod)
 				m_player1.broccoli_set_double_jump();
 			if (action == GLFW_PRESS && key == GLFW_KEY_S)
 				m_player1.set_movement(CROUCHING);
-			if (action == GLFW_PRESS && key == GLFW_KEY_C && !m_player1.is_tired_out() && !m_player1.is_blocking()) {
+			if (action == GLFW_PRESS && key == GLFW_KEY_C) {
+				// Buffered while blocking or tired out, the grunt is for a punch thrown now
 				m_player1.set_movement(PUNCHING);
-				play_grunt_audio();
+				if (!m_player1.is_tired_out() && !m_player1.is_blocking())
+					play_grunt_audio();
 			}
-			if (action == GLFW_PRESS && key == GLFW_KEY_V && !m_player1.is_tired_out() && !m_player1.is_blocking()) {
+			if (action == GLFW_PRESS && key == GLFW_KEY_V) {
 				m_player1.set_movement(ABILITY_1);
-				if (m_player1.get_fc() == BROCCOLI && !m_player1.broccoli_is_uppercut_on_cooldown())
-					Mix_PlayChannel(1, m_broccoli_uppercut_audio, 0);
-				if (m_player1.get_fc() == YAM && m_player1.yam_is_start_dashing() && m_player1.yam_dash_on_cooldown())
-					Mix_PlayChannel(1, m_yam_dash_audio, 0);
+				if (!m_player1.is_tired_out() && !m_player1.is_blocking()) {
+					if (m_player1.get_fc() == BROCCOLI && !m_player1.broccoli_is_uppercut_on_cooldown())
+						Mix_PlayChannel(1, m_broccoli_uppercut_audio, 0);
+					if (m_player1.get_fc() == YAM && m_player1.yam_is_start_dashing() && m_player1.yam_dash_on_cooldown())
+						Mix_PlayChannel(1, m_yam_dash_audio, 0);
+				}
 			}
-			if (action == GLFW_PRESS && key == GLFW_KEY_B && !m_player1.is_tired_out() && !m_player1.is_blocking()) {
+			if (action == GLFW_PRESS && key == GLFW_KEY_B) {
 				m_player1.set_movement(ABILITY_2);
-				if (m_player1.get_fc() == POTATO && !m_player1.potato_is_fries_on_cooldown()) Mix_PlayChannel(-1, m_potato_fries_audio, 0);
-				if (m_player1.get_fc() == BROCCOLI && !m_player1.broccoli_is_cauliflower_on_cooldown()) Mix_PlayChannel(-1, m_broccoli_cauliflower_audio, 0);
-				if (m_player1.get_fc() == EGGPLANT && m_player1.eggplant_is_shooting() && m_player1.eggplant_shoot_on_cooldown() && m_player1.eggplant_enough_to_shoot())
-					Mix_PlayChannel(1, m_eggplant_yeet_audio, 0);
-				if (m_player1.get_fc() == YAM && m_player1.yam_is_healing() && m_player1.yam_heal_on_cooldown())
-					Mix_PlayChannel(1, m_yam_heal_audio, 0);
+				if (!m_player1.is_tired_out() && !m_player1.is_blocking()) {
+					if (m_player1.get_fc() == POTATO && !m_player1.potato_is_fries_on_cooldown()) Mix_PlayChannel(-1, m_potato_fries_audio, 0);
+					if (m_player1.get_fc() == BROCCOLI && !m_player1.broccoli_is_cauliflower_on_cooldown()) Mix_PlayChannel(-1, m_broccoli_cauliflower_audio, 0);
+					if (m_player1.get_fc() == EGGPLANT && m_player1.eggplant_is_shooting() && m_player1.eggplant_shoot_on_cooldown() && m_player1.eggplant_enough_to_shoot())
+						Mix_PlayChannel(1, m_eggplant_yeet_audio, 0);
+					if (m_player1.get_fc() == YAM && m_player1.yam_is_healing() && m_player1.yam_heal_on_cooldown())
+						Mix_PlayChannel(1, m_yam_heal_audio, 0);
+				}
 			}
 			if (action == GLFW_REPEAT && key == GLFW_KEY_B && !m_player1.is_tired_out() && !m_player1.is_blocking()) {
 				m_player1.set_movement(HOLDING_ABILITY_2);
@@ -735,25 +1029,31 @@ void World::on_key(GLFWwindow *, int key, int, int action, int mod)
 				m_player2.broccoli_set_double_jump();
 			if (action == GLFW_PRESS && key == GLFW_KEY_DOWN)
 				m_player2.set_movement(CROUCHING);
-			if (action == GLFW_PRESS && (key == GLFW_KEY_KP_1 || key == GLFW_KEY_SLASH) && !m_player2.is_tired_out() && !m_player2.is_blocking()) {
+			if (action == GLFW_PRESS && (key == GLFW_KEY_KP_1 || key == GLFW_KEY_SLASH)) {
+				// Buffered while blocking or tired out, the grunt is for a punch thrown now
 				m_player2.set_movement(PUNCHING);
-				play_grunt_audio();
+				if (!m_player2.is_tired_out() && !m_player2.is_blocking())
+					play_grunt_audio();
 			}
-			if (action == GLFW_PRESS && (key == GLFW_KEY_KP_2 || key == GLFW_KEY_PERIOD) && !m_player2.is_tired_out() && !m_player2.is_blocking()) {
+			if (action == GLFW_PRESS && (key == GLFW_KEY_KP_2 || key == GLFW_KEY_PERIOD)) {
 				m_player2.set_movement(ABILITY_1);
-				if (m_player2.get_fc() == BROCCOLI && !m_player2.broccoli_is_uppercut_on_cooldown())
-					Mix_PlayChannel(2, m_broccoli_uppercut_audio, 0);
-				if (m_player2.get_fc() == YAM && m_player2.yam_is_start_dashing() && m_player2.yam_dash_on_cooldown())
-					Mix_PlayChannel(2, m_yam_dash_audio, 0);
+				if (!m_player2.is_tired_out() && !m_player2.is_blocking()) {
+					if (m_player2.get_fc() == BROCCOLI && !m_player2.broccoli_is_uppercut_on_cooldown())
+						Mix_PlayChannel(2, m_broccoli_uppercut_audio, 0);
+					if (m_player2.get_fc() == YAM && m_player2.yam_is_start_dashing() && m_player2.yam_dash_on_cooldown())
+						Mix_PlayChannel(2, m_yam_dash_audio, 0);
+				}
 			}
-			if (action == GLFW_PRESS && (key == GLFW_KEY_KP_3 || key == GLFW_KEY_COMMA) && !m_player2.is_tired_out() && !m_player2.is_blocking()) {
+			if (action == GLFW_PRESS && (key == GLFW_KEY_KP_3 || key == GLFW_KEY_COMMA)) {
 				m_player2.set_movement(ABILITY_2);
-				if (m_player2.get_fc() == POTATO && !m_player2.potato_is_fries_on_cooldown()) Mix_PlayChannel(-1, m_potato_fries_audio, 0);
-				if (m_player2.get_fc() == BROCCOLI && !m_player2.broccoli_is_cauliflower_on_cooldown()) Mix_PlayChannel(-1, m_broccoli_cauliflower_audio, 0);
-				if (m_player2.get_fc() == EGGPLANT && m_player2.eggplant_is_shooting() && m_player2.eggplant_shoot_on_cooldown() && m_player2.eggplant_enough_to_shoot())
-					Mix_PlayChannel(2, m_eggplant_yeet_audio, 0);
-				if (m_player2.get_fc() == YAM && m_player2.yam_is_healing() && m_player2.yam_heal_on_cooldown())
-					Mix_PlayChannel(2, m_yam_heal_audio, 0);
+				if (!m_player2.is_tired_out() && !m_player2.is_blocking()) {
+					if (m_player2.get_fc() == POTATO && !m_player2.potato_is_fries_on_cooldown()) Mix_PlayChannel(-1, m_potato_fries_audio, 0);
+					if (m_player2.get_fc() == BROCCOLI && !m_player2.broccoli_is_cauliflower_on_cooldown()) Mix_PlayChannel(-1, m_broccoli_cauliflower_audio, 0);
+					if (m_player2.get_fc() == EGGPLANT && m_player2.eggplant_is_shooting() && m_player2.eggplant_shoot_on_cooldown() && m_player2.eggplant_enough_to_shoot())
+						Mix_PlayChannel(2, m_eggplant_yeet_audio, 0);
+					if (m_player2.get_fc() == YAM && m_player2.yam_is_healing() && m_player2.yam_heal_on_cooldown())
+						Mix_PlayChannel(2, m_yam_heal_audio, 0);
+				}
 			}
 			if (action == GLFW_REPEAT && (key == GLFW_KEY_KP_3 || key == GLFW_KEY_COMMA) && !m_player2.is_tired_out() && !m_player2.is_blocking()) {
 				m_player2.set_movement(HOLDING_ABILITY_2);
@@ -902,6 +1202,16 @@ void World::on_key(GLFWwindow *, int key, int, int action, int mod)
 		Mix_FadeInMusic(m_bgms[m_background_track], -1, 1000);
 	}
 
+	// Performance HUD
+	if (action == GLFW_RELEASE && key == GLFW_KEY_F3) {
+		m_show_perf_hud = !m_show_perf_hud;
+	}
+
+	// GPU pass timings overlay
+	if (action == GLFW_RELEASE && key == GLFW_KEY_F2) {
+		m_show_gpu_timings = !m_show_gpu_timings;
+	}
+
 	// Fullscreen 
 	/*
 	if (action == GLFW_PRESS && key == GLFW_KEY_F11) {
@@ -924,7 +1234,22 @@ void World::on_key(GLFWwindow *, int key, int, int action, int mod)
 }
 
 
+void World::apply_hot_reload()
+{
+	const FighterDefinitionFile* definitions = m_hot_reload.reload();
+	if (definitions == nullptr)
+		return;
+	apply_fighter_definitions(*definitions);
+	for (Fighter* fighter : m_fighters)
+		fighter->apply_definition();
+}
+
 void World::reset()
+{
+	m_sim_thread.run_on_render_thread([this] { apply_reset(); });
+}
+
+void World::apply_reset()
 {
 	m_attacks.clear();
 	m_game_over = false;
@@ -959,6 +1284,7 @@ void World::reset()
 		}
 		break;
 	case TUTORIAL:
+	case PARTY:
 		m_player1.reset();
 
 		for (auto &ai : m_ais)
@@ -969,6 +1295,7 @@ void World::reset()
 	case MENU:
 		m_player1.set_in_play(false);
 		m_ais.clear();
+		update_fighter_list();
 		break;
 	case CHARSELECT:
 		break;
@@ -978,6 +1305,13 @@ void World::reset()
 }
 
 bool World::set_mode(GameMode mode) {
+	bool success = false;
+	m_sim_thread.run_on_render_thread([&] { success = apply_mode(mode); });
+	return success;
+}
+
+bool World::apply_mode(GameMode mode) {
+	alloc_tracker_skip_frames(ALLOC_WARMUP_FRAMES);
 	m_player1.set_in_play(false);
 	m_player2.set_in_play(false);
 	m_game_over = false;
@@ -991,10 +1325,7 @@ bool World::set_mode(GameMode mode) {
 		k.destroy();
 	}
 	m_knives.clear();
-	for (auto pe_it = m_particle_emitters.begin(); pe_it != m_particle_emitters.end();) {
-		delete *pe_it;
-		pe_it = m_particle_emitters.erase(pe_it);
-	}
+	m_particles.clear();
 	if (m_bg.m_initialized) {
 		m_bg.destroy();
 	}
@@ -1009,6 +1340,7 @@ bool World::set_mode(GameMode mode) {
 		case MENU:
 			init_stage(MENUBORDER);
 			m_player1.set_in_play(true); // needed to make AI respond
+			m_player1.attach(m_components); // moves along without being set up
 			set_paused(false);
 			initSuccess = initSuccess && m_menu.init(m_screen) && m_menu.set_mode(MENU);
 			init_char_select_ais();
@@ -1016,6 +1348,7 @@ bool World::set_mode(GameMode mode) {
 		case CHARSELECT:
 		{
 			m_player1.set_in_play(true);
+			m_player1.attach(m_components);
 			initSuccess = initSuccess && m_menu.init(m_screen) && m_menu.set_mode(CHARSELECT);
 			break;
 		}
@@ -1030,6 +1363,10 @@ bool World::set_mode(GameMode mode) {
 			if (selected_fight_mode == PVP) {
 				p2name = fighterMap[selectedP2].getFCName();
 			}
+			else if (selected_fight_mode == PARTY) {
+				p2name = std::to_string(m_party_size) + " AIs";
+				selectedP2 = BROCCOLI;
+			}
 			else {
 				p2name = "AI";
 				selectedP2 = BROCCOLI;
@@ -1042,11 +1379,11 @@ bool World::set_mode(GameMode mode) {
 			/*if (MAX_PLAYERS >= 1) { m_player1.set_in_play(true); }
 			if (MAX_PLAYERS >= 2) { m_player2.set_in_play(true); }
 			if (m_player1.get_in_play()) {
-				initSuccess = initSuccess && m_player1.init(1, "Poe Tatum", selectedP1);
+				initSuccess = initSuccess && m_player1.init(1, "Poe Tatum", selectedP1, m_components);
 				m_fighters.emplace_back(m_player1);
 			}
 			if (m_player2.get_in_play()) {
-				initSuccess = initSuccess && m_player2.init(2, "Spud", selectedP2);
+				initSuccess = initSuccess && m_player2.init(2, "Spud", selectedP2, m_components);
 				m_fighters.emplace_back(m_player2);
 			}*/
 
@@ -1063,28 +1400,30 @@ bool World::set_mode(GameMode mode) {
 			init_stage(selected_stage); // DO IN KEY CONTROL?
 			m_player1.set_in_play(true);
 			m_player2.set_in_play(true);
-			initSuccess = initSuccess && m_player1.init(1, p1name, selectedP1) && m_player2.init(2, p2name, selectedP2) && m_bg.init(m_screen, mode, selected_stage);
-			m_fighters.emplace_back(m_player1);
-			m_fighters.emplace_back(m_player2);
+			initSuccess = initSuccess && m_player1.init(1, p1name, selectedP1, m_components) && m_player2.init(2, p2name, selectedP2, m_components) && m_bg.init(m_screen, mode, selected_stage);
 			break;
 		case PVC: // single player
 			init_stage(selected_stage); // DO IN KEY CONTROL?
 			m_player1.set_in_play(true);
-			initSuccess = initSuccess && m_player1.init(1, p1name, selectedP1) && spawn_ai(INIT) && m_bg.init(m_screen, mode, selected_stage);
-			m_fighters.emplace_back(m_player1);
+			initSuccess = initSuccess && m_player1.init(1, p1name, selectedP1, m_components) && spawn_ai(INIT) && m_bg.init(m_screen, mode, selected_stage);
 			break;
 		case TUTORIAL:
 			init_stage(selected_stage); // DO IN KEY CONTROL?
 			m_player1.set_in_play(true);
-			initSuccess = initSuccess && m_player1.init(1, p1name, selectedP1) && spawn_ai(RANDOM) && m_bg.init(m_screen, mode, selected_stage);
-			m_fighters.emplace_back(m_player1);
+			initSuccess = initSuccess && m_player1.init(1, p1name, selectedP1, m_components) && spawn_ai(RANDOM) && m_bg.init(m_screen, mode, selected_stage);
+			break;
+		case PARTY:
+			init_stage(selected_stage);
+			m_player1.set_in_play(true);
+			initSuccess = initSuccess && m_player1.init(1, p1name, selectedP1, m_components) && spawn_party(m_party_size) && m_bg.init(m_screen, mode, selected_stage);
 			break;
 		default:
 			break;
 	}
+	update_fighter_list();
 	if (!is_ui_mode()) {
-		for (Fighter &f : m_fighters)
-			m_bg.addNameplate(f.get_nameplate(), f.get_name());
+		for (Fighter* fighter : m_fighters)
+			m_bg.addNameplate(fighter->get_nameplate(), fighter->get_name());
 	}
 	return initSuccess;
 }
@@ -1099,7 +1438,7 @@ void World::init_stage(Stage stage) {
 		case KITCHEN: {
 			spawn_platform(14, 546, 90, 8); //toaster platform
 			spawn_platform(1119, 546, 105, 8); //ricecooker platform
-			if (m_mode == PVP) { // only have top platforms in PVP
+			if (m_mode == PVP || m_mode == PARTY) { // only have top platforms in PVP and parties
 				spawn_platform(240, 400, 140, 8); //left cupboard platform
 				spawn_platform(820, 400, 140, 8); //right cupboard platform
 				spawn_platform(396, 328, 410, 17); //middle cupboard platform
@@ -1134,6 +1473,7 @@ void World::on_mouse_move(GLFWwindow *window, double xpos, double ypos)
 }
 
 bool World::check_collision_world(BoundingBox b1) {
+	ALLOC_SCOPE("World::check_collision_world");
 	// !!! refactor so that this doesn't use magic numbers
 	BoundingBox* b3 = new BoundingBox(0, 0, 1200, 800);
 	bool collision = b1.check_collision(*b3);
@@ -1151,15 +1491,11 @@ void World::play_grunt_audio() {
 }
 
 void World::clear_all_fighters() {
-	for (AI& ai : m_ais) {
-		ai.destroy();
-	}
-	m_ais.clear();
-
-	for (Fighter& fighter : m_fighters) {
-		fighter.destroy();
+	for (Fighter* fighter : m_fighters) {
+		fighter->destroy();
 	}
 	m_fighters.clear();
+	m_ais.clear();
 
 	std::map<FighterCharacter, FighterInfo>::iterator it;
 	for (it = fighterMap.begin(); it != fighterMap.end(); it++)
@@ -1168,69 +1504,81 @@ void World::clear_all_fighters() {
 	}
 }
 
+void World::update_fighter_list() {
+	m_fighters.clear();
+	if (m_player1.get_in_play())
+		m_fighters.push_back(&m_player1);
+	if (m_player2.get_in_play())
+		m_fighters.push_back(&m_player2);
+	for (AI& ai : m_ais)
+		m_fighters.push_back(&ai);
+}
+
+void World::find_party_targets() {
+	PROFILE_ZONE("party targets");
+	m_components.gather_fighters(m_fighters);
+	m_ai_targets.assign(m_ais.size(), &m_player1);
+	// AIs come after the players in m_fighters
+	int first_ai = m_components.fighters.size() - (int)m_ais.size();
+	m_jobs.parallel_for((int)m_ais.size(), 8, [this, first_ai](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			int closest = m_components.find_closest(first_ai + i);
+			if (closest >= 0)
+				m_ai_targets[i] = m_components.fighters.fighter[closest];
+		}
+	});
+}
+
 void World::attack_collision() {
+	PROFILE_ZONE("attack_collision");
+	m_components.gather_fighters(m_fighters);
+	m_components.gather_hitboxes(m_attacks);
+	const FighterRows& fighters = m_components.fighters;
+	const HitboxRows& hitboxes = m_components.hitboxes;
+
 	//damage effect collision loop
-	std::vector<Renderable*> renderables;
-	if (m_player1.get_in_play() && m_player1.get_alive()) {
-		BoundingBox b1 = m_player1.get_bounding_box();
-		renderables = m_attacks_tree->retrieve(b1, {});
-		for (Renderable* renderable : renderables) {
-			Attack* attack = static_cast<Attack*>(renderable);
-			BoundingBox b = attack->get_bounding_box();
-			if (attack->m_fighter_id != m_player1.get_id() && m_player1.is_blocking() == false && b.check_collision(b1)) {
-				//incur damage
-				m_player1.apply_damage(attack->m_damageEffect);
-				m_player1.set_hurt(true);
-				attack->m_damageEffect->m_hit_fighter = true;
-			}
-			// check attack collision with platforms
-			for (Renderable *renderable : m_platforms_tree->retrieve(b, {})) {
-				Platform* platform = static_cast<Platform*>(renderable);
-				if (b.check_collision(platform->get_bounding_box())) { attack->m_on_the_ground = true; }
-			}
+	if ((int)m_attack_hits.size() < fighters.size())
+		m_attack_hits.resize(fighters.size());
+	m_jobs.parallel_for(fighters.size(), 4, [this](int begin, int end) {
+		for (int i = begin; i < end; i++) {
+			m_attack_hits[i].clear();
+			if (m_components.fighters.alive[i])
+				m_components.find_hits(i, m_attack_hits[i]);
 		}
-	}
-
-	if (m_player2.get_in_play() && m_player2.get_alive()) {
-		BoundingBox b2 = m_player2.get_bounding_box();
-		renderables = m_attacks_tree->retrieve(b2, {});
-		for (Renderable* renderable : renderables) {
-			Attack* attack = static_cast<Attack*>(renderable);
-			BoundingBox b = attack->get_bounding_box();
-			if (attack->m_fighter_id != m_player2.get_id() && m_player2.is_blocking() == false && b.check_collision(b2)) {
-				//incur damage
-				m_player2.apply_damage(attack->m_damageEffect);
-				m_player2.set_hurt(true);
-				attack->m_damageEffect->m_hit_fighter = true;
-			}
-			// check attack collision with platforms
-			for (Renderable *renderable : m_platforms_tree->retrieve(b, {})) {
-				Platform* platform = static_cast<Platform*>(renderable);
-				if (b.check_collision(platform->get_bounding_box())) { attack->m_on_the_ground = true; }
-			}
+	});
+	ground_attacks();
+
+	for (int i = 0; i < fighters.size(); i++) {
+		for (int hit : m_attack_hits[i]) {
+			//incur damage
+			Attack* attack = hitboxes.attack[hit];
+			fighters.fighter[i]->apply_damage(attack->m_damageEffect);
+			fighters.fighter[i]->set_hurt(true);
+			m_hit_flash_ms = HIT_FLASH_MS;
+			attack->m_damageEffect->m_hit_fighter = true;
 		}
 	}
+}
 
-	for (AI &ai : m_ais) {
-		if (ai.get_alive()) {
-			BoundingBox b3 = ai.get_bounding_box();
-			renderables = m_attacks_tree->retrieve(b3, {});
-
-			for (Renderable* renderable : renderables) {
-				Attack* attack = static_cast<Attack*>(renderable);
-				if (attack->m_fighter_id != ai.get_id() && !ai.is_blocking() && attack->m_damageEffect->m_bounding_box.check_collision(b3)) {
-					//incur damage
-					ai.apply_damage(attack->m_damageEffect);
-					
-					ai.set_hurt(true);
-					attack->m_damageEffect->m_hit_fighter = true;
+void World::ground_attacks() {
+	// check attack collision with platforms
+	std::vector<Renderable*> platforms = m_platforms_tree->retrieve(m_screenBoundingBox, {});
+	m_jobs.parallel_for(m_components.hitboxes.size(), 64, [this, &platforms](int begin, int end) {
+		const HitboxRows& hitboxes = m_components.hitboxes;
+		for (int i = begin; i < end; i++) {
+			BoundingBox b(hitboxes.x[i], hitboxes.y[i], hitboxes.w[i], hitboxes.h[i]);
+			for (Renderable* renderable : platforms) {
+				if (b.check_collision(static_cast<Platform*>(renderable)->get_bounding_box())) {
+					hitboxes.attack[i]->m_on_the_ground = true;
+					break;
 				}
 			}
 		}
-	}
+	});
 }
 
 void World::attack_deletion() {
+	PROFILE_ZONE("attack_deletion");
 	for (int i = 0; i < m_attacks.size(); i++) {
 		if (m_attacks[i]->m_damageEffect->m_delete_when == AFTER_UPDATE ||
 			((m_attacks[i]->m_damageEffect->m_delete_when == AFTER_HIT || m_attacks[i]->m_damageEffect->m_delete_when == AFTER_HIT_OR_TIME) && m_attacks[i]->m_damageEffect->m_hit_fighter) ||
@@ -1249,8 +1597,38 @@ void World::attack_deletion() {
 }
 
 void World::attack_update(float ms) {
-	for (auto &attack : m_attacks)
-		attack->update(ms);
+	PROFILE_ZONE("attack_update");
+	m_jobs.parallel_for((int)m_attacks.size(), 16, [this, ms](int begin, int end) {
+		for (int i = begin; i < end; i++)
+			m_attacks[i]->update(ms);
+	});
+}
+
+// Reads the fighters' boxes and damages them, runs next to the particles update
+void World::knives_update(float ms) {
+	PROFILE_ZONE("knives update");
+	for (auto &k : m_knives) {
+		k.update(ms);
+		// m_fighters only holds the fighters in play
+		for (Fighter* fighter : m_fighters) {
+			if (fighter->get_alive() && !fighter->is_blocking() && k.collides_with(*fighter)) {
+				fighter->apply_damage(k.m_damage);
+			}
+		}
+
+		for (Renderable *renderable : m_platforms_tree->retrieve(*k.boundingBox, {})) {
+			Platform* platform = static_cast<Platform*>(renderable);
+			if (platform->check_collision(*k.boundingBox)) { k.m_is_on_ground = true; }
+		}
+	}
+}
+
+void World::add_attack(Attack* attack) {
+	if (attack == NULL)
+		return;
+	ALLOC_SCOPE("Attack::init");
+	attack->init();
+	m_attacks.push_back(attack);
 }
 
 void World::draw_rectangle() {
@@ -1273,7 +1651,7 @@ bool World::is_game_over() {
 		}
 		return false;
 	}
-	if (m_mode == PVC || m_mode == TUTORIAL) {
+	if (m_mode == PVC || m_mode == TUTORIAL || m_mode == PARTY) {
 		bool ais_alive = false;
 		for (int i = 0; i < m_ais.size(); i++) {
 			if (m_ais[i].get_alive() || m_ais[i].get_lives() > 0) {
@@ -1287,6 +1665,12 @@ bool World::is_game_over() {
 }
 
 void World::set_falling_knives(bool on) {
+	// Asked for every tick while the hazard is due, only a change waits on the render thread
+	if (m_falling_knives_on == on) { return; }
+	m_sim_thread.run_on_render_thread([this, on] { apply_falling_knives(on); });
+}
+
+void World::apply_falling_knives(bool on) {
 	//std::cout << "Set knives to: " << on << ", currently: " << m_falling_knives_on << std::endl;
 	//if (on && m_knives.size() > 0) { return; } // TEST
 	if (m_falling_knives_on == on) { return; }
@@ -1327,11 +1711,9 @@ void World::set_heat_wave(bool on) {
 	if (m_heat_wave_on == on) { return; }
 	if (on) {
 		m_stage_fx_time = glfwGetTime();
-		m_water.set_is_wavy(true);
 		int dmg = 20;
 	} else {
 		m_stage_fx_time = -1.f;
-		m_water.set_is_wavy(false);
 		for (int i = 0; i < m_ais.size(); i++) {
 			m_ais[i].set_hurt(false);
 		}
@@ -1349,20 +1731,10 @@ float World::get_stage_fx_time() {
 
 void World::apply_stage_fx_dmg() {
 	bool cond = (int)glfwGetTime() % 2 == 0;
-	if (m_player1.get_in_play()) {
-		m_player1.set_hurt(true);
-		if (cond && !m_player1.is_blocking())
-			m_player1.apply_damage(1);
-	}
-	if (m_player2.get_in_play()) {
-		m_player2.set_hurt(true);
-		if (cond && !m_player2.is_blocking())
-			m_player2.apply_damage(1);
-	}
-	for (int i = 0; i < m_ais.size(); i++) { // m_fighters does not work for some reason
-		if (cond && !m_ais[i].is_blocking())
-			m_ais[i].apply_damage(1);
-			m_ais[i].set_hurt(true);
+	for (Fighter* fighter : m_fighters) {
+		fighter->set_hurt(true);
+		if (cond && !fighter->is_blocking())
+			fighter->apply_damage(1);
 	}
 }
 
@@ -1372,28 +1744,28 @@ void World::init_char_select_ais() {
 	}
 	m_char_select_ais.clear();
 	AI ai_potato(idCounter, RANDOM);
-	if (ai_potato.init(3, "AI", POTATO))
+	if (ai_potato.init(3, "AI", POTATO, m_components))
 	{
 		idCounter++;
 		ai_potato.set_position({ 250.f, m_screen.y*.85f });
 		m_char_select_ais.emplace_back(ai_potato);
 	}
 	AI ai_broccoli(idCounter, RANDOM);
-	if (ai_broccoli.init(3, "AI", BROCCOLI))
+	if (ai_broccoli.init(3, "AI", BROCCOLI, m_components))
 	{
 		idCounter++;
 		ai_broccoli.set_position({ 250.f, m_screen.y*.85f });
 		m_char_select_ais.emplace_back(ai_broccoli);
 	}
 	AI ai_eggplant(idCounter, RANDOM);
-	if (ai_eggplant.init(3, "AI", EGGPLANT))
+	if (ai_eggplant.init(3, "AI", EGGPLANT, m_components))
 	{
 		idCounter++;
 		ai_eggplant.set_position({ 250.f, m_screen.y*.85f });
 		m_char_select_ais.emplace_back(ai_eggplant);
 	}
 	AI ai_yam(idCounter, RANDOM);
-	if (ai_yam.init(3, "AI", YAM))
+	if (ai_yam.init(3, "AI", YAM, m_components))
 	{
 		idCounter++;
 		ai_yam.set_position({ 250.f, m_screen.y*.85f });
@@ -1407,13 +1779,147 @@ bool World::is_ui_mode() {
 
 
 void World::emit_particles(vec2 position, vec3 color, int maxParticles, bool isRandom, float angle, float particleScale) {
-	auto pe = new ParticleEmitter(
+	m_particles.emit(ParticleEmitter(
 		position,
 		maxParticles,
 		color,
 		isRandom,
 		angle,
-		particleScale);
-	pe->init();
-	m_particle_emitters.emplace_back(pe);
+		particleScale));
+}
+
+// Counters of the frame that just ended and of the tick captured for the next one,
+// called before drawing it
+void World::collect_perf_stats(const RenderSnapshot& snapshot) {
+	GLStateStats gl_stats = gl_state_frame_stats();
+	AllocStats alloc_stats = alloc_tracker_last_frame();
+
+	PerfFrameStats stats;
+	stats.frame_ms = m_frame_pacer.get_last_interval_ms();
+	stats.update_ms = snapshot.update_ms;
+	stats.draw_ms = m_draw_ms;
+	stats.draw_calls = gl_stats.draw_calls;
+	stats.state_changes = gl_stats.issued;
+	stats.state_changes_elided = gl_stats.elided;
+	stats.attacks = snapshot.attacks;
+	stats.particles = snapshot.particle_count;
+	stats.broadphase_queries = snapshot.broadphase_queries;
+	stats.allocations = (int)alloc_stats.allocations;
+	stats.allocated_bytes = (int)alloc_stats.bytes;
+	stats.present_mode = m_frame_pacer.get_mode();
+	stats.pacing = m_frame_pacer.get_recent_stats();
+	m_perf_hud.add_frame(stats);
+}
+
+// Lists the GPU time of each pass in the top left corner
+void World::draw_gpu_timings(const mat3& projection) {
+	if (m_gpu_timings_text == nullptr) {
+		m_gpu_timings_text = new TextRenderer(mainFont, 24);
+		m_gpu_timings_text->setColor({ 1.f, 1.f, 0.f });
+	}
+
+	gl_disable(GL_DEPTH_TEST);
+
+	float y = 30.f;
+	for (const GpuZoneTiming& timing : gpu_profiler_results()) {
+		std::stringstream ss;
+		ss.precision(2);
+		ss << std::fixed << std::string(timing.depth * 2, ' ') << timing.name << ": " << timing.ms << " ms";
+		m_gpu_timings_text->setPosition({ 20.f, y });
+		m_gpu_timings_text->renderString(projection, ss.str());
+		y += 24.f;
+	}
+}
+
+void World::set_gpu_particles(bool on) {
+	m_gpu_particles = on;
+}
+
+void World::set_bloom(bool on) {
+	m_bloom = on;
+}
+
+void World::set_dynamic_resolution(bool on) {
+	m_dynamic_resolution_on = on;
+}
+
+void World::set_present_mode(PresentMode mode, float cap_fps) {
+	m_present_mode = mode;
+	m_frame_cap_fps = cap_fps;
+}
+
+void World::set_headless(bool on) {
+	m_headless = on;
+}
+
+void World::set_offscreen(bool on) {
+	m_offscreen = on;
+	m_headless = m_headless || on;
+}
+
+void World::set_sim_thread(bool on) {
+	m_use_sim_thread = on;
+}
+
+bool World::start_sim_thread(float step_ms) {
+	return m_use_sim_thread && m_sim_thread.start(this, step_ms);
+}
+
+void World::set_job_workers(int workers) {
+	m_job_workers = workers;
+}
+
+void World::set_party_size(int count) {
+	m_party_size = std::max(count, 1);
+}
+
+void World::set_hot_reload(bool on) {
+	m_hot_reload_on = on;
+}
+
+void World::set_input_poll_hz(int poll_hz) {
+	m_input_poll_hz = poll_hz;
+}
+
+void World::set_replay_recorder(ReplayRecorder* recorder) {
+	m_replay_recorder = recorder;
+}
+
+void World::inject_key(int key, int action, int mods) {
+	queue_key(key, 0, action, mods);
+}
+
+void World::set_measure_input_latency(bool on) {
+	m_input_latency.set_enabled(on);
+}
+
+void World::wait_for_next_frame() {
+	m_frame_pacer.wait_for_next_frame();
+}
+
+bool World::read_frame(std::vector<unsigned char>& rgba, int& width, int& height) {
+	if (m_screen_target == nullptr)
+		return false;
+
+	width = m_screen_target->width;
+	height = m_screen_target->height;
+	rgba.resize((size_t)width * height * 4);
+
+	gl_flush_errors();
+	glBindFramebuffer(GL_FRAMEBUFFER, m_screen_target->frame_buffer);
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+
+	// GL rows start at the bottom
+	size_t row_size = (size_t)width * 4;
+	std::vector<unsigned char> row(row_size);
+	for (int y = 0; y < height / 2; y++)
+	{
+		unsigned char* top = &rgba[y * row_size];
+		unsigned char* bottom = &rgba[(height - 1 - y) * row_size];
+		std::copy(top, top + row_size, row.begin());
+		std::copy(bottom, bottom + row_size, top);
+		std::copy(row.begin(), row.end(), bottom);
+	}
+	return !gl_has_errors();
 }
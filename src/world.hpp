@@ -3,6 +3,8 @@
 // internal
 #include "common.hpp"
 #include "fighterInfo.hpp"
+#include "postProcess.hpp"
+#include "dynamicResolution.hpp"
 #include "water.hpp"
 #include "fighter.hpp"
 #include "player1.hpp"
@@ -16,9 +18,25 @@
 #include "mainMenu.hpp"
 #include "platform.hpp"
 #include "knife.hpp"
-#include "particleEmitter.hpp"
+#include "particleSystem.hpp"
+#include "renderQueue.hpp"
+#include "profiler.hpp"
+#include "gpuProfiler.hpp"
+#include "perfHud.hpp"
+#include "allocTracker.hpp"
+#include "replay.hpp"
+#include "framePacer.hpp"
+#include "inputQueue.hpp"
+#include "inputLatency.hpp"
+#include "inputThread.hpp"
+#include "renderSnapshot.hpp"
+#include "simThread.hpp"
+#include "jobSystem.hpp"
+#include "componentStore.hpp"
+#include "hotReload.hpp"
 
 // stlib
+#include <atomic>
 #include <vector>
 #include <random>
 
@@ -43,7 +61,7 @@ class World
 	// Steps the game ahead by ms milliseconds
 	bool update(float ms);
 
-	// Renders our scene
+	// Renders our scene, captured right away from the current state
 	void draw();
 
 	// Should the game be over ?
@@ -63,28 +81,113 @@ class World
 	void apply_stage_fx_dmg();
 	void set_falling_knives(bool on);
 
+	// Must be called before init()
+	void set_gpu_particles(bool on);
+	void set_bloom(bool on);
+	void set_dynamic_resolution(bool on);
+	// Vsync by default, cap_fps only applies to PRESENT_CAPPED
+	void set_present_mode(PresentMode mode, float cap_fps);
+	// Hidden window without vsync or audio device, for automated runs
+	void set_headless(bool on);
+	// Headless on GLFW's null platform with a Mesa software context, the frame is drawn
+	// into a texture instead of a window. Runs without a display or GPU, needs GLFW 3.4
+	void set_offscreen(bool on);
+
+	// Ticks on a thread of its own while the caller only draws, see SimThread. GPU
+	// particles are turned off, they are simulated with GL calls. Must be called before init()
+	void set_sim_thread(bool on);
+	bool start_sim_thread(float step_ms);
+	// Workers sharing the per-entity updates of a tick, 0 for one per core and 1 to run
+	// everything on the updating thread. Must be called before init()
+	void set_job_workers(int workers);
+	// AIs spawned by the party mode
+	void set_party_size(int count);
+	// Reloads shaders, textures and fighter definitions as they are written, see
+	// HotReload. Must be called before init()
+	void set_hot_reload(bool on);
+	// Draws the latest snapshot of the simulation thread, false when there was no new one
+	bool draw_latest_frame();
+
+	// Polls gamepads on their own thread at this rate, 0 to leave them out. Never
+	// started headless. Must be called before init()
+	void set_input_poll_hz(int poll_hz);
+	const InputThread& get_input_thread() const { return m_input_thread; }
+
+	// Feeds key events to the recorder as they arrive, null to stop
+	void set_replay_recorder(ReplayRecorder* recorder);
+	// Queues a recorded key event as if the window had sent it
+	void inject_key(int key, int action, int mods);
+
+	// Times key presses until the frame showing them is presented. Waits for each
+	// swap to complete while on, which costs some CPU/GPU overlap
+	void set_measure_input_latency(bool on);
+	const InputLatency& get_input_latency() const { return m_input_latency; }
+
+	// Holds the loop back in the capped present mode, call before polling input
+	void wait_for_next_frame();
+	const FramePacer& get_frame_pacer() const { return m_frame_pacer; }
+
+	// Reads back the last drawn frame as RGBA, top row first. Offscreen only, a
+	// window's back buffer is gone after the swap
+	bool read_frame(std::vector<unsigned char>& rgba, int& width, int& height);
+
   private:
+	// The veggie_bench microbenchmarks drive attack_collision() directly
+	friend struct WorldBench;
+	// Ticks and captures on the simulation thread
+	friend class SimThread;
+
 	// Generates a new fighter
 	bool spawn_ai(AIType type);
 	bool spawn_ai(AIType type, FighterCharacter fc);
+	// Spreads count AIs over the stage, cycling through the characters and AI types
+	bool spawn_party(int count);
 	bool spawn_platform(float xpos, float ypos, float width, float height);
 
 	void reset();
+	// Bodies of set_mode(), reset() and set_falling_knives(), run on the render thread
+	// as they create or release GL objects
+	bool apply_mode(GameMode mode);
+	void apply_reset();
+	void apply_falling_knives(bool on);
+	void apply_hot_reload();
+
+	// Records what the frame draws into snapshot, no GL calls
+	void capture_frame(RenderSnapshot& snapshot);
+	void draw_frame(RenderSnapshot& snapshot);
 
 	//INPUT CALLBACK FUNCTIONS
+	void queue_key(int key, int scancode, int action, int mods);
+	void handle_queued_input();
 	void on_key(GLFWwindow *, int key, int, int action, int mod);
 	void on_mouse_move(GLFWwindow *window, double xpos, double ypos);
 	void attack_collision();
 	void attack_deletion();
 	void attack_update(float ms);
+	// Marks the attacks touching a platform as on the ground
+	void ground_attacks();
+	void knives_update(float ms);
+	// Inits an attack a fighter started and adds it to the world
+	void add_attack(Attack* attack);
 
 	bool check_collision(BoundingBox b1, BoundingBox b2);
 	bool check_collision_world(BoundingBox b1);
 
 	void clear_all_fighters();
+	// Rebuilds m_fighters, call whenever fighters are added or removed
+	void update_fighter_list();
+	// Party AIs go after the closest fighter still standing instead of player 1
+	void find_party_targets();
+	// Steps the sprite animations, once per tick after the fighters moved
+	void animate_fighters(float ms);
+	// The AI standing next to the menu, if the menu shows one
+	AI* get_shown_char_select_ai();
 	void init_char_select_ais();
 	bool is_ui_mode();
 	void emit_particles(vec2 position, vec3 color, int maxParticles, bool isRandom, float angle, float particleScale);
+	bool init_post_effects();
+	void draw_gpu_timings(const mat3& projection);
+	void collect_perf_stats(const RenderSnapshot& snapshot);
 
 	// Window handle
 	const GLFWvidmode* m_vidmode;
@@ -93,14 +196,74 @@ class World
 	GLFWwindow *m_window;
 	BoundingBox m_screenBoundingBox = BoundingBox(0.f, 0.f, 1200.f, 800.f);
 	vec2 m_screen; // screen vector
+	vec2 m_framebuffer_size; // read once, the window is not resizable
 
-	// Screen texture
-	// The draw loop first renders to this texture, then it is used for the water shader
-	GLuint m_frame_buffer;
-	Texture m_screen_tex;
-
-	// Water effect
+	// Screen effects, the draw loop renders through them when any is on
+	PostProcessChain m_post_process;
 	Water m_water;
+	bool m_bloom = false;
+	float m_hit_flash_ms = 0.f;
+	bool m_hit_flash_on = false;
+	float m_drawn_hit_flash_ms = 0.f; // of the snapshot being drawn
+
+	// Internal resolution of the scene, picked from frame times
+	DynamicResolution m_dynamic_resolution;
+	bool m_dynamic_resolution_on = true;
+
+	PresentMode m_present_mode = PRESENT_VSYNC;
+	float m_frame_cap_fps = 0.f;
+	FramePacer m_frame_pacer;
+
+	bool m_hot_reload_on = false;
+	HotReload m_hot_reload;
+
+	// Key events wait here for the start of the next tick
+	InputQueue m_input_queue;
+	InputLatency m_input_latency;
+	// Gamepad events, merged into the queue by time at the start of each tick
+	InputThread m_input_thread;
+	int m_input_poll_hz = InputThread::DEFAULT_POLL_HZ;
+
+	bool m_headless = false;
+	ReplayRecorder* m_replay_recorder = nullptr;
+
+	// Stands in for the window's framebuffer when offscreen
+	bool m_offscreen = false;
+	RenderTargetPool m_screen_targets;
+	RenderTarget* m_screen_target = nullptr;
+
+	// F2 overlay with the GPU time of each pass
+	bool m_show_gpu_timings = false;
+	TextRenderer* m_gpu_timings_text = nullptr;
+
+	// F3 performance HUD
+	bool m_show_perf_hud = false;
+	PerfHud m_perf_hud;
+	float m_draw_ms = 0.f;
+	uint64_t m_update_start_ns = 0;
+
+	// Per-frame draw commands, sorted by layer and GL state. Executes the queue of
+	// each snapshot, recorded into the snapshot itself
+	RenderQueue m_render_queue;
+
+	// Ticks counted since init, a snapshot is drawn from the state after one
+	uint64_t m_tick = 0;
+	// Frame captured and drawn by draw() when the simulation has no thread of its own
+	RenderSnapshot m_frame;
+	SimThread m_sim_thread;
+	bool m_use_sim_thread = false;
+
+	// Spreads the fighters, attacks and knives of a tick over the cores
+	JobSystem m_jobs;
+	int m_job_workers = 1;
+	// Dense copies of the fighters and attack hitboxes the collision and targeting loops walk
+	ComponentStore m_components;
+	// Hitbox rows touching each fighter row, found in parallel by attack_collision() and
+	// applied after in the order of the fighters
+	std::vector<std::vector<int>> m_attack_hits;
+	// AIs whose act() runs this tick and the attacks they started
+	std::vector<int> m_acting_ais;
+	std::vector<Attack*> m_ai_attacks;
 
 	// Game entities
 	MainMenu m_menu;
@@ -109,15 +272,20 @@ class World
 	Player2 m_player2;
 	std::vector<AI> m_ais;
 	std::vector<Attack*> m_attacks;
-	QuadTree *m_attacks_tree;
 	QuadTree *m_platforms_tree;
 	//float m_current_speed;
-	std::vector<Fighter> m_fighters; // all fighters including AIs
+	// All fighters in play, players first and then the AIs, so every fighter is updated
+	// and checked the same way whatever the mode
+	std::vector<Fighter*> m_fighters;
+	int m_party_size = 64;
+	// Who each AI thinks against this tick, player 1 outside of the party mode
+	std::vector<const Fighter*> m_ai_targets;
 	std::vector<AI> m_char_select_ais;
 
 	std::vector<Knife> m_knives;
 
-	std::vector<ParticleEmitter*> m_particle_emitters;
+	ParticleSystem m_particles;
+	bool m_gpu_particles = false;
 
 	unsigned int m_background_track;
 	std::vector<Mix_Music*> m_bgms;
@@ -136,7 +304,7 @@ class World
 
 	GameMode m_mode;
 	bool m_paused;
-	bool m_over;
+	std::atomic<bool> m_over{ false };
 	bool m_game_over = false;
 	std::string m_winner_name;
 	bool m_heat_wave_on = false;